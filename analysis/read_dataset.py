@@ -0,0 +1,83 @@
+"""
+Reader for the engine's columnar dataset files (--export-dataset).
+Loads every column (or a subset) as a NumPy array using the footer index.
+"""
+
+import argparse
+import struct
+
+import numpy as np
+
+MAGIC = b"LOBCOLS1"
+
+
+def read_dataset(path: str, columns=None) -> dict:
+    """Return {column_name: np.ndarray} for the requested columns.
+
+    Only the header, the footer and the requested column chunks are read,
+    so loading one column of a wide file costs that column's bytes.
+    """
+    with open(path, "rb") as f:
+        header = f.read(12)
+        if header[:8] != MAGIC:
+            raise ValueError(f"{path}: not a LOBCOLS1 file")
+        (count,) = struct.unpack_from("<I", header, 8)
+        entries = f.read(40 * count)
+        schema = []
+        for i in range(count):
+            entry = entries[40 * i:40 * (i + 1)]
+            name = entry[:32].split(b"\0", 1)[0].decode()
+            dtype = entry[32:40].split(b"\0", 1)[0].decode()
+            schema.append((name, np.dtype(dtype)))
+
+        f.seek(-24, 2)
+        tail = f.read(24)
+        if tail[16:] != MAGIC:
+            raise ValueError(f"{path}: no LOBCOLS1 footer (truncated export?)")
+        total_rows, footer_offset = struct.unpack_from("<QQ", tail)
+        f.seek(footer_offset)
+        (group_count,) = struct.unpack("<Q", f.read(8))
+        index = f.read(16 * group_count)
+        groups = [struct.unpack_from("<QQ", index, 16 * i)
+                  for i in range(group_count)]
+
+        names = [name for name, _ in schema]
+        wanted = names if columns is None else list(columns)
+        unknown = [name for name in wanted if name not in names]
+        if unknown:
+            raise KeyError(f"{path}: no column(s) {unknown}")
+        result = {name: np.empty(total_rows, dtype) for name, dtype in schema
+                  if name in wanted}
+
+        # Bytes per row of the chunks before each column: within a group of
+        # `rows` rows, the column's chunk starts at 8 + before * rows
+        layout = []
+        before = 0
+        for name, dtype in schema:
+            layout.append((name, dtype, before))
+            before += dtype.itemsize
+
+        row = 0
+        for group_offset, rows in groups:
+            for name, dtype, before in layout:
+                if name in result:
+                    f.seek(group_offset + 8 + before * rows)
+                    result[name][row:row + rows] = np.fromfile(f, dtype, rows)
+            row += rows
+
+    return result
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="Summarize a dataset export")
+    parser.add_argument("path")
+    args = parser.parse_args()
+
+    dataset = read_dataset(args.path)
+    for name, values in dataset.items():
+        if values.dtype.kind == "f":
+            valid = values[~np.isnan(values)]
+            print(f"{name:>14}: n={len(values)} nan={len(values) - len(valid)}"
+                  f" mean={valid.mean() if len(valid) else float('nan'):.6g}")
+        else:
+            print(f"{name:>14}: n={len(values)} first={values[:1]} last={values[-1:]}")
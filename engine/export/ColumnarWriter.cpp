@@ -0,0 +1,100 @@
+#include "ColumnarWriter.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+namespace lob {
+
+namespace {
+
+constexpr char kMagic[8] = {'L', 'O', 'B', 'C', 'O', 'L', 'S', '1'};
+constexpr size_t kNameSize = 32;
+constexpr size_t kDtypeSize = 8;
+
+template <typename T> void write_pod(std::ofstream &out, const T &value) {
+  out.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+} // namespace
+
+ColumnarWriter::ColumnarWriter(const std::string &path,
+                               std::vector<Column> columns, size_t group_rows)
+    : columns_(std::move(columns)),
+      group_rows_(std::max<size_t>(group_rows, 1)), staged_(0),
+      total_rows_(0), buffers_(columns_.size()) {
+  for (auto &buffer : buffers_)
+    buffer.resize(group_rows_);
+
+  file_.open(path, std::ios::binary | std::ios::trunc);
+  if (!file_.is_open()) {
+    std::cerr << "[ERROR] Failed to open export file: " << path << std::endl;
+    return;
+  }
+
+  file_.write(kMagic, sizeof(kMagic));
+  write_pod(file_, static_cast<uint32_t>(columns_.size()));
+  for (const Column &column : columns_) {
+    char name[kNameSize] = {};
+    char dtype[kDtypeSize] = {};
+    std::strncpy(name, column.name.c_str(), kNameSize - 1);
+    std::strcpy(dtype, column.type == Type::F64 ? "<f8" : "<u8");
+    file_.write(name, kNameSize);
+    file_.write(dtype, kDtypeSize);
+  }
+}
+
+ColumnarWriter::~ColumnarWriter() {
+  if (file_.is_open())
+    close();
+}
+
+void ColumnarWriter::put(size_t column, double value) {
+  std::memcpy(&buffers_[column][staged_], &value, sizeof(value));
+}
+
+void ColumnarWriter::put(size_t column, uint64_t value) {
+  buffers_[column][staged_] = value;
+}
+
+void ColumnarWriter::end_row() {
+  if (++staged_ == group_rows_)
+    flush_group();
+}
+
+void ColumnarWriter::flush_group() {
+  if (staged_ == 0)
+    return;
+
+  groups_.push_back(Group{static_cast<uint64_t>(file_.tellp()), staged_});
+  write_pod(file_, static_cast<uint64_t>(staged_));
+  for (const auto &buffer : buffers_) {
+    file_.write(reinterpret_cast<const char *>(buffer.data()),
+                static_cast<std::streamsize>(staged_ * sizeof(uint64_t)));
+  }
+
+  total_rows_ += staged_;
+  staged_ = 0;
+}
+
+bool ColumnarWriter::close() {
+  if (!file_.is_open())
+    return false;
+
+  flush_group();
+
+  uint64_t footer_offset = static_cast<uint64_t>(file_.tellp());
+  write_pod(file_, static_cast<uint64_t>(groups_.size()));
+  for (const Group &group : groups_) {
+    write_pod(file_, group.offset);
+    write_pod(file_, group.rows);
+  }
+  write_pod(file_, total_rows_);
+  write_pod(file_, footer_offset);
+  file_.write(kMagic, sizeof(kMagic));
+
+  bool ok = file_.good();
+  file_.close();
+  return ok;
+}
+
+} // namespace lob
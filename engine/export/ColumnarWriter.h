@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace lob {
+
+// Streaming columnar file writer. Rows are buffered column by column into
+// fixed-size row groups; each full group is written as contiguous column
+// chunks, so readers can load one column without touching the others.
+//
+// Layout (little-endian):
+//   "LOBCOLS1" | u32 column_count | column_count x {char name[32];
+//                                                   char dtype[8]}
+//   row group:  u64 rows | column chunks (rows x 8 bytes each, in order)
+//   footer:     u64 group_count | group_count x {u64 offset; u64 rows} |
+//               u64 total_rows | u64 footer_offset | "LOBCOLS1"
+// dtype is a NumPy descr ("<f8" or "<u8").
+class ColumnarWriter {
+public:
+  enum class Type : uint8_t { F64, U64 };
+
+  struct Column {
+    std::string name; // At most 31 characters
+    Type type;
+  };
+
+  ColumnarWriter(const std::string &path, std::vector<Column> columns,
+                 size_t group_rows = 65536);
+  ~ColumnarWriter();
+
+  ColumnarWriter(const ColumnarWriter &) = delete;
+  ColumnarWriter &operator=(const ColumnarWriter &) = delete;
+
+  bool is_open() const { return file_.is_open(); }
+
+  // Fill every column of the current row, then end_row()
+  void put(size_t column, double value);
+  void put(size_t column, uint64_t value);
+  void end_row();
+
+  // Flush the last group and write the footer
+  bool close();
+
+  size_t rows() const { return total_rows_ + staged_; }
+  size_t column_count() const { return columns_.size(); }
+
+private:
+  struct Group {
+    uint64_t offset;
+    uint64_t rows;
+  };
+
+  std::ofstream file_;
+  std::vector<Column> columns_;
+  size_t group_rows_;
+  size_t staged_;
+  uint64_t total_rows_;
+  std::vector<std::vector<uint64_t>> buffers_; // One 8-byte slot per cell
+  std::vector<Group> groups_;
+
+  void flush_group();
+};
+
+} // namespace lob
@@ -0,0 +1,164 @@
+#include "DatasetExporter.h"
+#include <algorithm>
+#include <iostream>
+#include <limits>
+
+namespace lob {
+
+namespace {
+
+constexpr double kNaN = std::numeric_limits<double>::quiet_NaN();
+
+// "ret_100ms", "ret_1s", ...
+std::string horizon_name(uint64_t ms) {
+  if (ms % 1000 == 0)
+    return "ret_" + std::to_string(ms / 1000) + "s";
+  return "ret_" + std::to_string(ms) + "ms";
+}
+
+} // namespace
+
+DatasetExporter::DatasetExporter(const std::string &path,
+                                 const Options &options)
+    : options_(options), tracker_(1), last_ofi_total_(0.0), emitted_(0),
+      pending_(0), cursor_(), last_mid_(0.0), last_ts_(0), overflowed_(0) {
+  auto &depths = options_.imbalance_depths;
+  auto &horizons = options_.horizons_ms;
+  if (depths.empty() || depths.size() > kMaxDepths || horizons.empty() ||
+      horizons.size() > kMaxHorizons) {
+    std::cerr << "[ERROR] Dataset export supports 1-" << kMaxDepths
+              << " imbalance depths and 1-" << kMaxHorizons << " horizons"
+              << std::endl;
+    return;
+  }
+  // Horizons resolve in order; the longest one decides when a row is done
+  std::sort(horizons.begin(), horizons.end());
+  ring_.resize(std::max<size_t>(options_.lookahead_rows, 1));
+
+  using Type = ColumnarWriter::Type;
+  std::vector<ColumnarWriter::Column> columns = {
+      {"exchange_ts", Type::U64}, {"local_ts", Type::U64},
+      {"mid", Type::F64},         {"spread", Type::F64},
+      {"microprice", Type::F64}};
+  for (size_t depth : depths)
+    columns.push_back({"imbalance_" + std::to_string(depth), Type::F64});
+  columns.push_back({"ofi", Type::F64});
+  columns.push_back({"bid_size", Type::F64});
+  columns.push_back({"ask_size", Type::F64});
+  for (uint64_t ms : horizons)
+    columns.push_back({horizon_name(ms), Type::F64});
+
+  writer_ = std::make_unique<ColumnarWriter>(path, std::move(columns));
+}
+
+DatasetExporter::~DatasetExporter() { close(); }
+
+void DatasetExporter::on_batch(const OrderBook &book, uint64_t exchange_ts,
+                               uint64_t local_ts, bool take_sample) {
+  // State before this batch is the as-of value for horizons ending earlier
+  resolve_before(exchange_ts);
+
+  const BookFeatures &f = tracker_.update(book);
+  last_mid_ = f.valid ? f.mid : 0.0;
+  last_ts_ = exchange_ts;
+
+  if (take_sample && f.valid) {
+    if (pending_ == ring_.size())
+      emit_oldest();
+
+    Row &row = row_at(emitted_ + pending_);
+    row.exchange_ts = exchange_ts;
+    row.local_ts = local_ts;
+    row.mid = f.mid;
+    row.spread = f.spread;
+    row.microprice = f.microprice;
+    row.ofi = f.ofi_total - last_ofi_total_;
+    row.bid_size = f.bid_size;
+    row.ask_size = f.ask_size;
+    for (size_t i = 0; i < options_.imbalance_depths.size(); ++i)
+      row.imbalance[i] = book.calculate_imbalance(options_.imbalance_depths[i]);
+    row.label.fill(kNaN);
+
+    last_ofi_total_ = f.ofi_total;
+    pending_++;
+  }
+
+  emit_ready();
+}
+
+void DatasetExporter::resolve_before(uint64_t exchange_ts) {
+  uint64_t end = emitted_ + pending_;
+  double future = last_mid_;
+
+  for (size_t h = 0; h < options_.horizons_ms.size(); ++h) {
+    uint64_t horizon = options_.horizons_ms[h];
+    uint64_t &cursor = cursor_[h];
+
+    while (cursor < end) {
+      Row &row = row_at(cursor);
+      if (row.exchange_ts + horizon >= exchange_ts)
+        break;
+      row.label[h] = future > 0.0 ? future / row.mid - 1.0 : kNaN;
+      cursor++;
+    }
+  }
+}
+
+void DatasetExporter::emit_ready() {
+  // Horizons are sorted: the longest one is the last to resolve
+  uint64_t done = cursor_[options_.horizons_ms.size() - 1];
+  while (emitted_ < done) {
+    write(row_at(emitted_));
+    emitted_++;
+    pending_--;
+  }
+}
+
+void DatasetExporter::emit_oldest() {
+  if (overflowed_++ == 0) {
+    std::cerr << "[WARN] Dataset lookahead ring full ("
+              << ring_.size() << " rows); emitting rows with unresolved"
+              << " labels" << std::endl;
+  }
+
+  write(row_at(emitted_));
+  emitted_++;
+  pending_--;
+  for (size_t h = 0; h < options_.horizons_ms.size(); ++h)
+    cursor_[h] = std::max(cursor_[h], emitted_);
+}
+
+void DatasetExporter::write(const Row &row) {
+  size_t c = 0;
+  writer_->put(c++, row.exchange_ts);
+  writer_->put(c++, row.local_ts);
+  writer_->put(c++, row.mid);
+  writer_->put(c++, row.spread);
+  writer_->put(c++, row.microprice);
+  for (size_t i = 0; i < options_.imbalance_depths.size(); ++i)
+    writer_->put(c++, row.imbalance[i]);
+  writer_->put(c++, row.ofi);
+  writer_->put(c++, row.bid_size);
+  writer_->put(c++, row.ask_size);
+  for (size_t h = 0; h < options_.horizons_ms.size(); ++h)
+    writer_->put(c++, row.label[h]);
+  writer_->end_row();
+}
+
+bool DatasetExporter::close() {
+  if (!is_open())
+    return false;
+
+  // Horizons ending at or before the last batch use its mid; later ones
+  // are beyond the data and stay NaN
+  if (last_ts_ < std::numeric_limits<uint64_t>::max())
+    resolve_before(last_ts_ + 1);
+  while (pending_ > 0) {
+    write(row_at(emitted_));
+    emitted_++;
+    pending_--;
+  }
+  return writer_->close();
+}
+
+} // namespace lob
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "../features/BookFeatures.h"
+#include "../order_book/OrderBook.h"
+#include "ColumnarWriter.h"
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace lob {
+
+// One-pass feature/label dataset for supervised training. Each sampling
+// point becomes a row of book features plus forward mid returns at fixed
+// event-time horizons:
+//   exchange_ts, local_ts, mid, spread, microprice, imbalance_<d> per
+//   depth, ofi (order flow imbalance since the previous row), bid_size,
+//   ask_size, ret_<h> per horizon = mid(t + h) / mid(t) - 1
+// mid(t + h) is the mid of the last batch with exchange_ts <= t + h.
+// Rows wait in a bounded lookahead ring until their longest horizon has
+// passed, then stream to a ColumnarWriter file. Labels that cannot be
+// resolved (end of data, ring overflow, one-sided book) are NaN.
+class DatasetExporter {
+public:
+  static constexpr size_t kMaxDepths = 4;
+  static constexpr size_t kMaxHorizons = 4;
+
+  struct Options {
+    std::vector<size_t> imbalance_depths{1, 5, 10};
+    std::vector<uint64_t> horizons_ms{100, 1000, 10000};
+    size_t lookahead_rows = 1 << 16; // Ring capacity
+  };
+
+  DatasetExporter(const std::string &path, const Options &options);
+  ~DatasetExporter();
+
+  bool is_open() const { return writer_ && writer_->is_open(); }
+
+  // Call at the end of every exchange batch, in time order. Resolves the
+  // labels whose horizon ended before this batch, then records a row when
+  // take_sample is set.
+  void on_batch(const OrderBook &book, uint64_t exchange_ts,
+                uint64_t local_ts, bool take_sample);
+
+  // Resolve what the data allows, emit every pending row, write footer
+  bool close();
+
+  size_t rows() const { return writer_ ? writer_->rows() + pending_ : 0; }
+  size_t overflowed() const { return overflowed_; }
+
+private:
+  struct Row {
+    uint64_t exchange_ts;
+    uint64_t local_ts;
+    double mid;
+    double spread;
+    double microprice;
+    double ofi;
+    double bid_size;
+    double ask_size;
+    std::array<double, kMaxDepths> imbalance;
+    std::array<double, kMaxHorizons> label;
+  };
+
+  Options options_;
+  std::unique_ptr<ColumnarWriter> writer_;
+  FeatureTracker tracker_;
+  double last_ofi_total_;
+
+  // Lookahead ring: rows [emitted_, emitted_ + pending_) by absolute index
+  std::vector<Row> ring_;
+  uint64_t emitted_;
+  size_t pending_;
+  std::array<uint64_t, kMaxHorizons> cursor_; // Next row lacking label h
+
+  double last_mid_; // Mid as of the last batch seen (0 if one-sided)
+  uint64_t last_ts_;
+  size_t overflowed_;
+
+  Row &row_at(uint64_t index) { return ring_[index % ring_.size()]; }
+  void resolve_before(uint64_t exchange_ts);
+  void emit_ready();
+  void emit_oldest();
+  void write(const Row &row);
+};
+
+} // namespace lob
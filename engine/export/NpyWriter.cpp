@@ -0,0 +1,88 @@
+#include "NpyWriter.h"
+#include <cstdint>
+#include <iostream>
+#include <sstream>
+
+namespace lob {
+
+namespace {
+
+constexpr char kMagic[] = "\x93NUMPY";
+constexpr size_t kPreambleSize = 10; // magic(6) + version(2) + HEADER_LEN(2)
+constexpr size_t kMaxRowsDigits = 20;
+
+} // namespace
+
+NpyWriter::NpyWriter() : row_bytes_(0), rows_(0), header_size_(0) {}
+
+NpyWriter::~NpyWriter() {
+  if (file_.is_open())
+    close();
+}
+
+std::string NpyWriter::header(size_t rows) const {
+  std::ostringstream dict;
+  dict << "{'descr': '" << descr_ << "', 'fortran_order': False, 'shape': ("
+       << rows << ",";
+  for (size_t dim : row_shape_)
+    dict << " " << dim << ",";
+  dict << "), }";
+  return dict.str();
+}
+
+bool NpyWriter::open(const std::string &path, const std::string &descr,
+                     size_t item_size, const std::vector<size_t> &row_shape) {
+  descr_ = descr;
+  row_shape_ = row_shape;
+  rows_ = 0;
+
+  row_bytes_ = item_size;
+  for (size_t dim : row_shape)
+    row_bytes_ *= dim;
+
+  // Reserve room for the widest possible row count, aligned to 64 bytes
+  size_t widest = header(0).size() - 1 + kMaxRowsDigits;
+  header_size_ = (kPreambleSize + widest + 1 + 63) / 64 * 64;
+
+  file_.open(path, std::ios::binary | std::ios::trunc);
+  if (!file_.is_open()) {
+    std::cerr << "[ERROR] Failed to open export file: " << path << std::endl;
+    return false;
+  }
+
+  // Placeholder header, patched by close()
+  file_.write(std::string(header_size_, ' ').data(), header_size_);
+  return true;
+}
+
+void NpyWriter::append(const void *rows, size_t count) {
+  file_.write(static_cast<const char *>(rows),
+              static_cast<std::streamsize>(count * row_bytes_));
+  rows_ += count;
+}
+
+bool NpyWriter::close() {
+  if (!file_.is_open())
+    return false;
+
+  std::string dict = header(rows_);
+  size_t header_len = header_size_ - kPreambleSize;
+  dict.append(header_len - dict.size() - 1, ' ');
+  dict.push_back('\n');
+
+  std::string preamble(kMagic, 6);
+  preamble.push_back('\x01'); // version 1.0
+  preamble.push_back('\x00');
+  preamble.push_back(static_cast<char>(header_len & 0xff));
+  preamble.push_back(static_cast<char>((header_len >> 8) & 0xff));
+
+  file_.seekp(0);
+  file_.write(preamble.data(), preamble.size());
+  file_.write(dict.data(), dict.size());
+
+  bool ok = file_.good();
+  file_.close();
+  return ok;
+}
+
+} // namespace lob
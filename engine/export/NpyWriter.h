@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace lob {
+
+// Streaming writer for a NumPy .npy file (format 1.0, C order) whose
+// leading dimension is unknown until the end. The header is reserved at a
+// fixed size and rewritten with the final row count on close(), so the data
+// always starts at the same offset and the file can be opened with
+// numpy.load(path, mmap_mode="r").
+class NpyWriter {
+public:
+  NpyWriter();
+  ~NpyWriter();
+
+  NpyWriter(const NpyWriter &) = delete;
+  NpyWriter &operator=(const NpyWriter &) = delete;
+
+  // descr is a NumPy dtype string ("<f8", "<u8", ...); row_shape the
+  // trailing dimensions of one row (empty for a 1-D array)
+  bool open(const std::string &path, const std::string &descr,
+            size_t item_size, const std::vector<size_t> &row_shape);
+
+  // Append count contiguous rows
+  void append(const void *rows, size_t count);
+
+  // Patch the header with the row count and close the file
+  bool close();
+
+  bool is_open() const { return file_.is_open(); }
+  size_t rows() const { return rows_; }
+  size_t row_bytes() const { return row_bytes_; }
+
+private:
+  std::ofstream file_;
+  std::string descr_;
+  std::vector<size_t> row_shape_;
+  size_t row_bytes_;
+  size_t rows_;
+  size_t header_size_;
+
+  std::string header(size_t rows) const;
+};
+
+} // namespace lob
@@ -0,0 +1,57 @@
+#include "TensorExporter.h"
+#include <algorithm>
+
+namespace lob {
+
+TensorExporter::TensorExporter(const std::string &prefix, size_t depth,
+                               size_t buffer_rows)
+    : depth_(depth), buffer_rows_(std::max<size_t>(buffer_rows, 1)),
+      staged_(0), rows_buffer_(buffer_rows_ * depth * kColumns),
+      index_buffer_(buffer_rows_ * 2), levels_(depth) {
+  tensor_.open(prefix + ".npy", "<f8", sizeof(double), {depth_, kColumns});
+  index_.open(prefix + ".ts.npy", "<u8", sizeof(uint64_t), {2});
+}
+
+TensorExporter::~TensorExporter() { close(); }
+
+void TensorExporter::sample(const OrderBook &book, uint64_t exchange_ts,
+                            uint64_t local_ts) {
+  double *row = rows_buffer_.data() + staged_ * depth_ * kColumns;
+  std::fill(row, row + depth_ * kColumns, 0.0);
+
+  size_t bids = book.get_bid_depth(levels_.data(), depth_);
+  for (size_t i = 0; i < bids; ++i) {
+    row[i * kColumns + 0] = levels_[i].price;
+    row[i * kColumns + 1] = levels_[i].volume;
+  }
+  size_t asks = book.get_ask_depth(levels_.data(), depth_);
+  for (size_t i = 0; i < asks; ++i) {
+    row[i * kColumns + 2] = levels_[i].price;
+    row[i * kColumns + 3] = levels_[i].volume;
+  }
+
+  index_buffer_[staged_ * 2 + 0] = exchange_ts;
+  index_buffer_[staged_ * 2 + 1] = local_ts;
+
+  if (++staged_ == buffer_rows_)
+    flush();
+}
+
+void TensorExporter::flush() {
+  if (staged_ == 0)
+    return;
+  tensor_.append(rows_buffer_.data(), staged_);
+  index_.append(index_buffer_.data(), staged_);
+  staged_ = 0;
+}
+
+bool TensorExporter::close() {
+  if (!is_open())
+    return false;
+  flush();
+  bool tensor_ok = tensor_.close();
+  bool index_ok = index_.close();
+  return tensor_ok && index_ok;
+}
+
+} // namespace lob
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "../order_book/OrderBook.h"
+#include "NpyWriter.h"
+#include <string>
+#include <vector>
+
+namespace lob {
+
+// Dense top-K book tensor for model training. Writes two .npy files:
+//   <prefix>.npy     float64 (N, depth, 4): bid_price, bid_size,
+//                    ask_price, ask_size per level, best first (missing
+//                    levels are 0)
+//   <prefix>.ts.npy  uint64 (N, 2): exchange_ts, local_ts of each row
+// Rows are staged in a fixed buffer and streamed out, so memory does not
+// grow with the input. Both files memory-map with numpy.load(mmap_mode="r").
+class TensorExporter {
+public:
+  static constexpr size_t kColumns = 4;
+
+  TensorExporter(const std::string &prefix, size_t depth,
+                 size_t buffer_rows = 4096);
+  ~TensorExporter();
+
+  bool is_open() const { return tensor_.is_open() && index_.is_open(); }
+
+  // Append the book's current top-K state as one row
+  void sample(const OrderBook &book, uint64_t exchange_ts, uint64_t local_ts);
+
+  // Flush staged rows and finalize both headers
+  bool close();
+
+  size_t rows() const { return tensor_.rows() + staged_; }
+  size_t depth() const { return depth_; }
+
+private:
+  size_t depth_;
+  size_t buffer_rows_;
+  size_t staged_;
+
+  NpyWriter tensor_;
+  NpyWriter index_;
+  std::vector<double> rows_buffer_;     // buffer_rows x depth x kColumns
+  std::vector<uint64_t> index_buffer_;  // buffer_rows x 2
+  std::vector<LevelInfo> levels_;       // depth scratch
+
+  void flush();
+};
+
+} // namespace lob
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "../order_book/OrderBook.h"
+
+namespace lob {
+
+// Book features maintained incrementally, one update per book change
+struct BookFeatures {
+  double mid;
+  double spread;
+  double microprice;
+  double imbalance;   // Volume imbalance over the tracker's depth
+  double ofi;         // Order flow imbalance contributed by the last update
+  double ofi_total;   // Running sum of ofi since construction/reset
+  double bid_price;
+  double bid_size;
+  double ask_price;
+  double ask_size;
+  bool valid;         // Both sides present
+};
+
+// Derives BookFeatures from the book's cached top of book. OFI follows
+// Cont, Kukanov & Stoikov: each touch change contributes
+//   e = 1{Pb >= Pb'} qb - 1{Pb <= Pb'} qb' - 1{Pa <= Pa'} qa + 1{Pa >= Pa'} qa'
+// (primed = previous touch), so OFI over a window is a difference of
+// ofi_total samples.
+class FeatureTracker {
+public:
+  explicit FeatureTracker(size_t imbalance_depth = 5)
+      : depth_(imbalance_depth), features_(), prev_() {}
+
+  const BookFeatures &update(const OrderBook &book) {
+    TopOfBook top = book.get_top_of_book();
+
+    features_.valid = top.valid();
+    features_.bid_price = top.bid_price;
+    features_.bid_size = top.bid_size;
+    features_.ask_price = top.ask_price;
+    features_.ask_size = top.ask_size;
+    features_.mid = top.mid;
+    features_.spread = top.spread;
+    features_.microprice = top.microprice;
+    features_.imbalance = book.calculate_imbalance(depth_);
+
+    double e = 0.0;
+    if (prev_.valid() && top.valid()) {
+      if (top.bid_price >= prev_.bid_price)
+        e += top.bid_size;
+      if (top.bid_price <= prev_.bid_price)
+        e -= prev_.bid_size;
+      if (top.ask_price <= prev_.ask_price)
+        e -= top.ask_size;
+      if (top.ask_price >= prev_.ask_price)
+        e += prev_.ask_size;
+    }
+    features_.ofi = e;
+    features_.ofi_total += e;
+
+    prev_ = top;
+    return features_;
+  }
+
+  void reset_ofi() { features_.ofi_total = 0.0; }
+
+  const BookFeatures &features() const { return features_; }
+  size_t imbalance_depth() const { return depth_; }
+
+private:
+  size_t depth_;
+  BookFeatures features_;
+  TopOfBook prev_;
+};
+
+} // namespace lob
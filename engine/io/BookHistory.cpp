@@ -0,0 +1,182 @@
+#include "BookHistory.h"
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+
+namespace lob {
+
+BookHistory::BookHistory(const std::string &event_file,
+                         const std::string &symbol,
+                         const BookHistoryOptions &options)
+    : event_file_(event_file), options_(options),
+      spec_(instrument_for(symbol)),
+      apply_(apply_event_for(options.queue_model)), events_(0), first_ts_(0),
+      last_ts_(0), checkpoint_bytes_(0), clock_(0), cache_hits_(0),
+      cache_misses_(0),
+      reader_(event_file, DynamicInstrument(spec_)), book_(symbol, spec_),
+      cursor_valid_(false), cursor_ts_(0), cursor_event_(0),
+      last_gap_events_(0) {
+  if (options_.checkpoint_every == 0)
+    options_.checkpoint_every = 1;
+  if (options_.cache_size == 0)
+    options_.cache_size = 1;
+}
+
+BookHistory::~BookHistory() {
+  if (spill_.is_open()) {
+    spill_.close();
+    std::remove(options_.spill_file.c_str());
+  }
+}
+
+bool BookHistory::build() {
+  if (!apply_) {
+    std::cerr << "[ERROR] Unknown queue model: " << options_.queue_model
+              << std::endl;
+    return false;
+  }
+  if (!reader_.is_open())
+    return false;
+  if (!options_.spill_file.empty() && !spill_.is_open()) {
+    // Never truncate (and later delete) a file the history did not create
+    std::error_code ec;
+    if (std::filesystem::exists(options_.spill_file, ec) || ec) {
+      std::cerr << "[ERROR] Checkpoint file already exists: "
+                << options_.spill_file << std::endl;
+      return false;
+    }
+    spill_.open(options_.spill_file, std::ios::binary | std::ios::in |
+                                         std::ios::out | std::ios::trunc);
+    if (!spill_.is_open()) {
+      std::cerr << "[ERROR] Cannot open checkpoint file: "
+                << options_.spill_file << std::endl;
+      return false;
+    }
+  }
+
+  checkpoints_.clear();
+  cache_.clear();
+  checkpoint_bytes_ = 0;
+  events_ = 0;
+  book_.clear();
+  reader_.seek_to(0);
+
+  // Checkpoint 0 is the empty book at the start of the file
+  BookState state;
+  book_.save_state(state);
+  store(Checkpoint{0, 0, reader_.tell(), 0, {}}, state);
+
+  while (reader_.has_more()) {
+    auto event = reader_.read_next();
+    if (!event)
+      continue;
+    apply_(book_, *event);
+    if (events_ == 0)
+      first_ts_ = event->exchange_ts;
+    last_ts_ = event->exchange_ts;
+
+    if (++events_ % options_.checkpoint_every == 0) {
+      book_.save_state(state);
+      store(Checkpoint{last_ts_, events_, reader_.tell(), 0, {}}, state);
+    }
+  }
+
+  cursor_valid_ = false;
+  pending_.reset();
+  return true;
+}
+
+void BookHistory::store(const Checkpoint &where, const BookState &state) {
+  Checkpoint checkpoint = where;
+  if (spill_.is_open()) {
+    spill_.seekp(0, std::ios::end);
+    checkpoint.stored = static_cast<uint64_t>(spill_.tellp());
+    state.write(spill_);
+  } else {
+    std::ostringstream out;
+    state.write(out);
+    checkpoint.bytes = out.str();
+  }
+  checkpoint_bytes_ += state.bytes();
+  checkpoints_.push_back(std::move(checkpoint));
+}
+
+const BookState &BookHistory::load(size_t index) {
+  ++clock_;
+  for (CacheEntry &entry : cache_) {
+    if (entry.checkpoint == index) {
+      entry.last_used = clock_;
+      ++cache_hits_;
+      return entry.state;
+    }
+  }
+  ++cache_misses_;
+
+  // Reuse the least recently used slot once the cache is full
+  CacheEntry *slot;
+  if (cache_.size() < options_.cache_size) {
+    cache_.emplace_back();
+    slot = &cache_.back();
+  } else {
+    slot = &*std::min_element(cache_.begin(), cache_.end(),
+                              [](const CacheEntry &a, const CacheEntry &b) {
+                                return a.last_used < b.last_used;
+                              });
+  }
+  slot->checkpoint = index;
+  slot->last_used = clock_;
+
+  const Checkpoint &checkpoint = checkpoints_[index];
+  if (spill_.is_open()) {
+    spill_.clear();
+    spill_.seekg(static_cast<std::streamoff>(checkpoint.stored));
+    slot->state.read(spill_);
+  } else {
+    std::istringstream in(checkpoint.bytes);
+    slot->state.read(in);
+  }
+  return slot->state;
+}
+
+bool BookHistory::next_event() {
+  while (!pending_ && reader_.has_more())
+    pending_ = reader_.read_next();
+  return pending_.has_value();
+}
+
+const OrderBook &BookHistory::book_at(uint64_t ts) {
+  last_gap_events_ = 0;
+  if (checkpoints_.empty())
+    return book_;
+
+  // Last checkpoint at or before ts (checkpoint 0 is always eligible)
+  auto after = std::upper_bound(
+      checkpoints_.begin() + 1, checkpoints_.end(), ts,
+      [](uint64_t t, const Checkpoint &c) { return t < c.ts; });
+  size_t index = static_cast<size_t>(after - checkpoints_.begin()) - 1;
+  const Checkpoint &checkpoint = checkpoints_[index];
+
+  // Moving forward past the checkpoint already: keep replaying instead
+  bool resume = cursor_valid_ && ts >= cursor_ts_ &&
+                cursor_event_ >= checkpoint.event;
+  if (!resume) {
+    book_.restore_state(load(index));
+    reader_.seek_to(checkpoint.offset);
+    pending_.reset();
+    cursor_event_ = checkpoint.event;
+  }
+
+  while (next_event() && pending_->exchange_ts <= ts) {
+    apply_(book_, *pending_);
+    pending_.reset();
+    ++cursor_event_;
+    ++last_gap_events_;
+  }
+  cursor_valid_ = true;
+  cursor_ts_ = ts;
+  return book_;
+}
+
+} // namespace lob
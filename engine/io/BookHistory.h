@@ -0,0 +1,107 @@
+#pragma once
+
+#include "../order_book/BookState.h"
+#include "../order_book/OrderBook.h"
+#include "EventApply.h"
+#include "EventReader.h"
+#include <fstream>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace lob {
+
+struct BookHistoryOptions {
+  uint64_t checkpoint_every = 10000; // Events between checkpoints
+  size_t cache_size = 8;             // Decoded checkpoints kept (LRU)
+  // Empty: checkpoints in memory. Otherwise a path that must not exist
+  // yet: build() creates it and the history deletes it when destroyed
+  std::string spill_file;
+  std::string queue_model = FifoPolicy::name;
+};
+
+// Random access to the book of one capture at any exchange time. build()
+// replays the file once and serializes the book every checkpoint_every
+// events (in memory, or appended to a spill file). book_at(ts) restores
+// the nearest checkpoint at or before ts and replays only the gap, so a
+// query costs at most checkpoint_every events plus one restore. The most
+// recently used checkpoints stay decoded, and a query later than the
+// previous one continues from it when that is closer than a checkpoint.
+class BookHistory {
+public:
+  BookHistory(const std::string &event_file, const std::string &symbol,
+              const BookHistoryOptions &options = BookHistoryOptions());
+  ~BookHistory();
+
+  BookHistory(const BookHistory &) = delete;
+  BookHistory &operator=(const BookHistory &) = delete;
+
+  // First pass over the file; false if it cannot be read or the queue
+  // model is unknown
+  bool build();
+
+  // Book after every event with exchange_ts <= ts (empty before the first
+  // event). The reference stays valid until the next call.
+  const OrderBook &book_at(uint64_t ts);
+
+  size_t checkpoints() const { return checkpoints_.size(); }
+  uint64_t events() const { return events_; }
+  uint64_t first_ts() const { return first_ts_; }
+  uint64_t last_ts() const { return last_ts_; }
+
+  // Serialized checkpoint size (memory or spill file)
+  uint64_t checkpoint_bytes() const { return checkpoint_bytes_; }
+
+  // Events replayed by the last book_at, and checkpoint cache counters
+  uint64_t last_gap_events() const { return last_gap_events_; }
+  uint64_t cache_hits() const { return cache_hits_; }
+  uint64_t cache_misses() const { return cache_misses_; }
+
+private:
+  struct Checkpoint {
+    uint64_t ts;       // exchange_ts of the last event applied
+    uint64_t event;    // Events applied
+    uint64_t offset;   // Reader offset of the next line
+    uint64_t stored;   // Spill file offset (on disk)
+    std::string bytes; // Serialized BookState (in memory)
+  };
+
+  struct CacheEntry {
+    size_t checkpoint;
+    uint64_t last_used;
+    BookState state;
+  };
+
+  std::string event_file_;
+  BookHistoryOptions options_;
+  InstrumentSpec spec_;
+  ApplyEventFn apply_;
+
+  std::vector<Checkpoint> checkpoints_;
+  std::fstream spill_;
+  uint64_t events_;
+  uint64_t first_ts_;
+  uint64_t last_ts_;
+  uint64_t checkpoint_bytes_;
+
+  std::vector<CacheEntry> cache_;
+  uint64_t clock_;
+  uint64_t cache_hits_;
+  uint64_t cache_misses_;
+
+  // Query cursor: book_ holds every event with ts <= cursor_ts_; pending_
+  // is the first event past it, already read
+  EventReader reader_;
+  OrderBook book_;
+  bool cursor_valid_;
+  uint64_t cursor_ts_;
+  uint64_t cursor_event_;
+  std::optional<Event> pending_;
+  uint64_t last_gap_events_;
+
+  void store(const Checkpoint &where, const BookState &state);
+  const BookState &load(size_t index);
+  bool next_event();
+};
+
+} // namespace lob
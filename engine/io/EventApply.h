@@ -0,0 +1,118 @@
+#pragma once
+
+#include "../order_book/OrderBook.h"
+#include "EventReader.h"
+
+namespace lob {
+
+// Apply one parsed event to the book. L2 events set absolute level volume
+// (decreases allocated by Policy); L3 events switch the book to true L3
+// mode on first use and are applied by exchange order id. Instrument is
+// the grid the events were parsed on (the book's own spec); a
+// StaticInstrument constant-folds level price conversion.
+template <typename Policy = FifoPolicy,
+          typename Instrument = DynamicInstrument>
+void apply_event(OrderBook &book, const Event &event) {
+  if (!is_l3_event(event.event_type)) {
+    book.update_order_ticks<Policy, Instrument>(
+        event.price_ticks, event.quantity, event.side, event.exchange_ts);
+    return;
+  }
+
+  if (!book.l3_enabled())
+    book.enable_l3();
+
+  switch (event.event_type) {
+  case EventType::ADD:
+    book.add_l3_order_ticks(event.order_id, event.price_ticks, event.quantity,
+                            event.side, event.exchange_ts);
+    break;
+  case EventType::MODIFY:
+    book.modify_l3_order_ticks(event.order_id, event.price_ticks,
+                               event.quantity, event.exchange_ts);
+    break;
+  case EventType::CANCEL:
+    book.cancel_l3_order(event.order_id);
+    break;
+  default:
+    break;
+  }
+}
+
+// Apply rows [begin, end) of a decoded block. Runs of same-side L2 rows
+// sharing an exchange timestamp go through update_batch (one touch refresh
+// and integrity check per run); L3 rows are applied one at a time.
+template <typename Policy = FifoPolicy,
+          typename Instrument = DynamicInstrument>
+void apply_block(OrderBook &book, const EventBlock &block, size_t begin,
+                 size_t end) {
+  const uint8_t *type = block.type.data();
+  const uint8_t *side = block.side.data();
+  const uint64_t *ts = block.exchange_ts.data();
+
+  size_t i = begin;
+  while (i < end) {
+    EventType event_type = static_cast<EventType>(type[i]);
+
+    if (is_l3_event(event_type)) {
+      if (!book.l3_enabled())
+        book.enable_l3();
+      switch (event_type) {
+      case EventType::ADD:
+        book.add_l3_order_ticks(block.order_id[i], block.price_ticks[i],
+                                block.quantity[i], block.side_at(i), ts[i]);
+        break;
+      case EventType::MODIFY:
+        book.modify_l3_order_ticks(block.order_id[i], block.price_ticks[i],
+                                   block.quantity[i], ts[i]);
+        break;
+      default:
+        book.cancel_l3_order(block.order_id[i]);
+        break;
+      }
+      ++i;
+      continue;
+    }
+
+    size_t run = i + 1;
+    while (run < end && !is_l3_event(static_cast<EventType>(type[run])) &&
+           side[run] == side[i] && ts[run] == ts[i])
+      ++run;
+
+    if (block.side_at(i) == Side::BID) {
+      book.update_batch<Side::BID, Policy, Instrument>(
+          &block.price_ticks[i], &block.quantity[i], run - i, ts[i]);
+    } else {
+      book.update_batch<Side::ASK, Policy, Instrument>(
+          &block.price_ticks[i], &block.quantity[i], run - i, ts[i]);
+    }
+    i = run;
+  }
+}
+
+template <typename Policy = FifoPolicy,
+          typename Instrument = DynamicInstrument>
+void apply_block(OrderBook &book, const EventBlock &block) {
+  apply_block<Policy, Instrument>(book, block, 0, block.size());
+}
+
+// Runtime-selected apply for callers that cannot be templated on the
+// policy (one indirect call per event)
+using ApplyEventFn = void (*)(OrderBook &, const Event &);
+
+// nullptr for an unknown model name
+inline ApplyEventFn apply_event_for(const std::string &queue_model) {
+  if (queue_model == FifoPolicy::name)
+    return &apply_event<FifoPolicy>;
+  if (queue_model == LifoCancelPolicy::name)
+    return &apply_event<LifoCancelPolicy>;
+  if (queue_model == ProRataPolicy::name)
+    return &apply_event<ProRataPolicy>;
+  if (queue_model == SizeWeightedPolicy::name)
+    return &apply_event<SizeWeightedPolicy>;
+  if (queue_model == MixedTradeCancelPolicy::name)
+    return &apply_event<MixedTradeCancelPolicy>;
+  return nullptr;
+}
+
+} // namespace lob
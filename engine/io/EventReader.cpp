@@ -1,90 +1,529 @@
 #include "EventReader.h"
+#include "../metrics/Diagnostics.h"
+#include "../metrics/Probes.h"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <string_view>
 #include <iostream>
-#include <sstream>
+#include <unordered_set>
 
 namespace lob {
 
-EventReader::EventReader(const std::string &filepath)
-    : filepath_(filepath), file_(filepath) {
+template <typename Instrument>
+BasicEventReader<Instrument>::BasicEventReader(const std::string &filepath,
+                                               const Instrument &instrument)
+    : filepath_(filepath), file_(filepath, std::ios::binary),
+      codec_(instrument), buffer_(kReadChunk), buffer_offset_(0), pos_(0),
+      end_(0), eof_(false), filter_(), filter_active_(false),
+      min_price_ticks_(std::numeric_limits<int64_t>::min()),
+      max_price_ticks_(std::numeric_limits<int64_t>::max()),
+      exhausted_(false), lines_filtered_(0) {
   if (!file_.is_open()) {
     std::cerr << "[ERROR] Failed to open file: " << filepath << std::endl;
   }
 }
 
-EventReader::~EventReader() {
+template <typename Instrument>
+BasicEventReader<Instrument>::~BasicEventReader() {
   if (file_.is_open()) {
     file_.close();
   }
 }
 
-std::optional<Event> EventReader::read_next() {
-  if (!file_.is_open() || file_.eof()) {
+template <typename Instrument>
+std::optional<Event> BasicEventReader<Instrument>::read_next() {
+  if (!file_.is_open() || exhausted_) {
     return std::nullopt;
   }
 
-  std::string line;
-  if (std::getline(file_, line)) {
-    return parse_line(line);
+  const char *begin;
+  const char *end;
+  while (next_line(begin, end)) {
+    if (filter_active_ && !prefilter(begin, end)) {
+      ++lines_filtered_;
+      if (exhausted_)
+        return std::nullopt;
+      continue;
+    }
+    return parse_line(begin, end);
   }
 
   return std::nullopt;
 }
 
-bool EventReader::has_more() const { return file_.is_open() && !file_.eof(); }
+template <typename Instrument>
+size_t BasicEventReader<Instrument>::read_block(EventBlock &block) {
+  block.clear();
+  if (!file_.is_open() || exhausted_)
+    return 0;
+
+  Event event;
+  const char *begin;
+  const char *end;
+  while (!block.full() && next_line(begin, end)) {
+    if (filter_active_ && !prefilter(begin, end)) {
+      ++lines_filtered_;
+      if (exhausted_)
+        break;
+      continue;
+    }
+    if (decode_line(begin, end, event))
+      block.push_back(event);
+  }
+
+  // Lots -> quantity as one pass over the column
+  const size_t count = block.size();
+  const int64_t *lots = block.qty_lots.data();
+  double *quantity = block.quantity.data();
+  for (size_t i = 0; i < count; ++i)
+    quantity[i] = codec_.lots_to_qty(lots[i]);
+
+  return count;
+}
+
+template <typename Instrument>
+bool BasicEventReader<Instrument>::has_more() const {
+  return file_.is_open() && !exhausted_ && !(eof_ && pos_ == end_);
+}
+
+template <typename Instrument> void BasicEventReader<Instrument>::reset() {
+  exhausted_ = false;
+  if (filter_active_ && filter_.sorted_by_time &&
+      filter_.min_exchange_ts != 0) {
+    seek_to_time(filter_.min_exchange_ts);
+  } else {
+    seek(0);
+  }
+}
 
-void EventReader::reset() {
+template <typename Instrument>
+void BasicEventReader<Instrument>::set_filter(const EventFilter &filter) {
+  filter_ = filter;
+  filter_active_ = filter.active();
+
+  min_price_ticks_ = std::isinf(filter.min_price)
+                         ? std::numeric_limits<int64_t>::min()
+                         : codec_.price_to_ticks(filter.min_price);
+  max_price_ticks_ = std::isinf(filter.max_price)
+                         ? std::numeric_limits<int64_t>::max()
+                         : codec_.price_to_ticks(filter.max_price);
+
+  if (file_.is_open())
+    reset();
+}
+
+template <typename Instrument>
+void BasicEventReader<Instrument>::seek(uint64_t offset) {
   file_.clear();
-  file_.seekg(0, std::ios::beg);
+  file_.seekg(static_cast<std::streamoff>(offset), std::ios::beg);
+  buffer_offset_ = offset;
+  pos_ = end_ = 0;
+  eof_ = false;
 }
 
-std::optional<Event> EventReader::parse_line(const std::string &line) {
-  // New format:
-  // [exchange_seq]|[exchange_event_ts]|[local_ingest_ts]|[event_type]|[price]|[qty]|[side]
-  std::istringstream ss(line);
-  std::string token;
+template <typename Instrument>
+bool BasicEventReader<Instrument>::next_line(const char *&begin,
+                                             const char *&end) {
+  while (true) {
+    char *data = buffer_.data();
+    auto *newline =
+        static_cast<char *>(std::memchr(data + pos_, '\n', end_ - pos_));
+    if (newline) {
+      begin = data + pos_;
+      end = newline;
+      pos_ = static_cast<size_t>(newline - data) + 1;
+      return true;
+    }
+
+    if (eof_) {
+      if (pos_ == end_)
+        return false;
+      begin = data + pos_; // Last line without a trailing newline
+      end = data + end_;
+      pos_ = end_;
+      return true;
+    }
+
+    // Keep the partial line, grow if it fills the buffer, read more
+    std::memmove(data, data + pos_, end_ - pos_);
+    buffer_offset_ += pos_;
+    end_ -= pos_;
+    pos_ = 0;
+    if (end_ == buffer_.size())
+      buffer_.resize(buffer_.size() * 2);
+
+    file_.read(buffer_.data() + end_,
+               static_cast<std::streamsize>(buffer_.size() - end_));
+    end_ += static_cast<size_t>(file_.gcount());
+    if (!file_)
+      eof_ = true;
+  }
+}
+
+EventType parse_event_type(const char *begin, const char *end) {
+  std::string_view token(begin, static_cast<size_t>(end - begin));
+  if (token == "UPDATE")
+    return EventType::UPDATE;
+  if (token == "SNAPSHOT")
+    return EventType::SNAPSHOT;
+  if (token == "ADD")
+    return EventType::ADD;
+  if (token == "MODIFY")
+    return EventType::MODIFY;
+  if (token == "CANCEL")
+    return EventType::CANCEL;
+  return EventType::UNKNOWN;
+}
+
+const char *to_string(EventType type) {
+  switch (type) {
+  case EventType::SNAPSHOT:
+    return "SNAPSHOT";
+  case EventType::UPDATE:
+    return "UPDATE";
+  case EventType::ADD:
+    return "ADD";
+  case EventType::MODIFY:
+    return "MODIFY";
+  case EventType::CANCEL:
+    return "CANCEL";
+  default:
+    return "UNKNOWN";
+  }
+}
+
+namespace {
+
+bool parse_uint(const char *begin, const char *end, uint64_t &out) {
+  auto result = std::from_chars(begin, end, out);
+  return result.ec == std::errc() && result.ptr == end;
+}
+
+// End of the field starting at cursor
+const char *field_end(const char *cursor, const char *line_end) {
+  auto *bar = static_cast<const char *>(
+      std::memchr(cursor, '|', static_cast<size_t>(line_end - cursor)));
+  return bar ? bar : line_end;
+}
+
+} // namespace
+
+template <typename Instrument>
+uint64_t BasicEventReader<Instrument>::exchange_ts_after(uint64_t offset) {
+  char probe[512];
+  file_.clear();
+  file_.seekg(static_cast<std::streamoff>(offset), std::ios::beg);
+  file_.read(probe, sizeof(probe));
+  const char *cursor = probe;
+  const char *end = probe + file_.gcount();
+
+  if (offset != 0) {
+    // Skip the (possibly partial) line containing offset
+    auto *newline = static_cast<const char *>(
+        std::memchr(cursor, '\n', static_cast<size_t>(end - cursor)));
+    if (!newline)
+      return std::numeric_limits<uint64_t>::max();
+    cursor = newline + 1;
+  }
+
+  const char *seq_end = field_end(cursor, end);
+  if (seq_end == end)
+    return std::numeric_limits<uint64_t>::max();
+  uint64_t ts;
+  if (!parse_uint(seq_end + 1, field_end(seq_end + 1, end), ts))
+    return std::numeric_limits<uint64_t>::max();
+  return ts;
+}
+
+template <typename Instrument>
+void BasicEventReader<Instrument>::seek_to_time(uint64_t min_exchange_ts) {
+  file_.clear();
+  file_.seekg(0, std::ios::end);
+  uint64_t lo = 0;
+  uint64_t hi = static_cast<uint64_t>(file_.tellg());
+
+  // Invariant: every line ending before the line after lo is < min
+  while (hi - lo > kSeekBlock) {
+    uint64_t mid = lo + (hi - lo) / 2;
+    if (exchange_ts_after(mid) < min_exchange_ts)
+      lo = mid;
+    else
+      hi = mid;
+  }
+
+  seek(lo);
+  if (lo != 0) {
+    const char *begin;
+    const char *end;
+    next_line(begin, end); // Partial line, known to be before the range
+  }
+}
+
+template <typename Instrument>
+bool BasicEventReader<Instrument>::prefilter(const char *begin,
+                                             const char *end) {
+  // exchange_seq
+  const char *token_end = field_end(begin, end);
+  uint64_t seq;
+  if (!parse_uint(begin, token_end, seq) || token_end == end)
+    return true;
+  if (seq < filter_.min_seq || seq > filter_.max_seq)
+    return false;
+
+  // exchange_event_ts
+  const char *cursor = token_end + 1;
+  token_end = field_end(cursor, end);
+  uint64_t ts;
+  if (!parse_uint(cursor, token_end, ts) || token_end == end)
+    return true;
+  if (ts > filter_.max_exchange_ts) {
+    exhausted_ = filter_.sorted_by_time;
+    return false;
+  }
+  if (ts < filter_.min_exchange_ts)
+    return false;
+
+  // local_ingest_ts (not filtered)
+  cursor = field_end(token_end + 1, end);
+  if (cursor == end)
+    return true;
+
+  // event_type
+  ++cursor;
+  token_end = field_end(cursor, end);
+  EventType type = parse_event_type(cursor, token_end);
+  if (type == EventType::UNKNOWN || token_end == end)
+    return true;
+  if (!(filter_.type_mask & EventFilter::type_bit(type)))
+    return false;
+
+  // price field starts here; side is read from the tail of the line
+  const char *price_begin = token_end + 1;
+  const char *price_end = field_end(price_begin, end);
+
+  if (!filter_.bids || !filter_.asks) {
+    const char *tail = end;
+    if (tail != begin && tail[-1] == '\r')
+      --tail;
+    if (is_l3_event(type)) {
+      while (tail != price_end && *--tail != '|') {
+      } // Drop the trailing order id
+    }
+    const char *side_begin = tail;
+    while (side_begin != price_end && side_begin[-1] != '|')
+      --side_begin;
+    bool bid = tail - side_begin == 3 && side_begin[0] == 'B' &&
+               side_begin[1] == 'I' && side_begin[2] == 'D';
+    if (bid ? !filter_.bids : !filter_.asks)
+      return false;
+  }
+
+  if (min_price_ticks_ != std::numeric_limits<int64_t>::min() ||
+      max_price_ticks_ != std::numeric_limits<int64_t>::max()) {
+    int64_t ticks;
+    if (!codec_.parse_price_ticks(price_begin, price_end, ticks))
+      return true;
+    if (ticks < min_price_ticks_ || ticks > max_price_ticks_)
+      return false;
+  }
+
+  return true;
+}
+
+template <typename Instrument>
+std::optional<Event>
+BasicEventReader<Instrument>::parse_line(const char *begin, const char *end) {
   Event event;
+  if (!decode_line(begin, end, event))
+    return std::nullopt;
+  return event;
+}
+
+template <typename Instrument>
+bool BasicEventReader<Instrument>::decode_line(const char *begin,
+                                               const char *end,
+                                               Event &event) {
+  // Format:
+  // [exchange_seq]|[exchange_event_ts]|[local_ingest_ts]|[event_type]|[price]|[qty]|[side]
+  // L3 events (ADD/MODIFY/CANCEL) carry a trailing [order_id] field
+  event = Event();
+  std::string_view line(begin, static_cast<size_t>(end - begin));
+
+  const char *cursor = begin;
+  const char *line_end = end;
+  if (cursor != line_end && line_end[-1] == '\r')
+    --line_end; // Tolerate CRLF files
 
   int field_idx = 0;
-  while (std::getline(ss, token, '|')) {
-    try {
-      switch (field_idx) {
-      case 0: // exchange_seq (sequence number)
-        event.exchange_seq = std::stoull(token);
-        break;
-      case 1: // exchange_event_ts (event timestamp from exchange)
-        event.exchange_ts = std::stoull(token);
-        break;
-      case 2: // local_ingest_ts (local ingestion timestamp)
-        event.local_ts = std::stoull(token);
-        break;
-      case 3: // event_type
-        event.event_type = token;
-        break;
-      case 4: // price
-        event.price = std::stod(token);
-        break;
-      case 5: // quantity
-        event.quantity = std::stod(token);
-        break;
-      case 6: // side
-        event.side = (token == "BID") ? Side::BID : Side::ASK;
-        break;
-      }
-      field_idx++;
-    } catch (const std::exception &e) {
-      std::cerr << "[ERROR] Failed to parse field " << field_idx
-                << " in line: " << line << std::endl;
-      return std::nullopt;
+  while (cursor != line_end) {
+    const char *token_end = cursor;
+    while (token_end != line_end && *token_end != '|')
+      ++token_end;
+
+    bool ok = true;
+    switch (field_idx) {
+    case 0: // exchange_seq (sequence number)
+      ok = parse_uint(cursor, token_end, event.exchange_seq);
+      break;
+    case 1: // exchange_event_ts (event timestamp from exchange)
+      ok = parse_uint(cursor, token_end, event.exchange_ts);
+      break;
+    case 2: // local_ingest_ts (local ingestion timestamp)
+      ok = parse_uint(cursor, token_end, event.local_ts);
+      break;
+    case 3: // event_type
+      event.event_type = parse_event_type(cursor, token_end);
+      ok = (event.event_type != EventType::UNKNOWN);
+      break;
+    case 4: // price (decimal text -> ticks)
+      ok = codec_.parse_price_ticks(cursor, token_end, event.price_ticks);
+      event.price = codec_.ticks_to_price(event.price_ticks);
+      break;
+    case 5: // quantity (decimal text -> lots)
+      ok = codec_.parse_qty_lots(cursor, token_end, event.qty_lots);
+      event.quantity = codec_.lots_to_qty(event.qty_lots);
+      break;
+    case 6: // side
+      event.side = (token_end - cursor == 3 && cursor[0] == 'B' &&
+                    cursor[1] == 'I' && cursor[2] == 'D')
+                       ? Side::BID
+                       : Side::ASK;
+      break;
+    case 7: // order_id (L3 events only)
+      ok = parse_uint(cursor, token_end, event.order_id);
+      break;
+    }
+
+    if (!ok) {
+      LOB_DIAG(DiagLevel::ERROR, DiagCategory::PARSE_FIELD,
+               "Failed to parse field " << field_idx << " in line: " << line);
+      return false;
     }
+
+    field_idx++;
+    if (token_end == line_end)
+      break;
+    cursor = token_end + 1;
   }
 
-  if (field_idx != 7) {
-    std::cerr << "[ERROR] Invalid event format (expected 7 fields, got "
-              << field_idx << "): " << line << std::endl;
-    return std::nullopt;
+  int expected_fields = is_l3_event(event.event_type) ? 8 : 7;
+  if (field_idx != expected_fields) {
+    LOB_DIAG(DiagLevel::ERROR, DiagCategory::PARSE_FORMAT,
+             "Invalid event format (expected " << expected_fields
+                                               << " fields, got " << field_idx
+                                               << "): " << line);
+    return false;
   }
 
-  return event;
+  LOB_PROBE6(event_parsed, event.exchange_seq, event.exchange_ts,
+             event.event_type, event.side, event.price_ticks, event.qty_lots);
+  return true;
+}
+
+template <typename Instrument>
+EventFileStats BasicEventReader<Instrument>::scan_stats(uint64_t budget) {
+  EventFileStats stats;
+  if (!file_.is_open())
+    return stats;
+
+  file_.clear();
+  file_.seekg(0, std::ios::end);
+  stats.bytes = static_cast<uint64_t>(file_.tellg());
+  stats.sampled = stats.bytes > budget;
+  const uint64_t windows = stats.sampled ? kScanWindows : 1;
+  const uint64_t window = stats.sampled ? budget / kScanWindows : stats.bytes;
+
+  std::unordered_set<uint64_t> live_orders; // From file start only
+  uint64_t lines = 0;
+  bool have_ts = false;
+
+  for (uint64_t w = 0; w < windows; ++w) {
+    // Windows are evenly spaced; the last one ends at end of file
+    uint64_t offset =
+        windows > 1 ? w * (stats.bytes - window) / (windows - 1) : 0;
+    seek(offset);
+
+    const char *begin;
+    const char *end;
+    uint64_t read = 0;
+    if (offset != 0) {
+      if (!next_line(begin, end)) // Partial line
+        continue;
+      read += static_cast<uint64_t>(end - begin) + 1;
+    }
+
+    uint64_t batch_seq = 0;
+    size_t batch = 0;
+    while (read < window && next_line(begin, end)) {
+      read += static_cast<uint64_t>(end - begin) + 1;
+
+      const char *line_end = end;
+      if (line_end != begin && line_end[-1] == '\r')
+        --line_end;
+      const char *field[8] = {};
+      const char *field_stop[8] = {};
+      int fields = 0;
+      for (const char *cursor = begin; fields < 8;) {
+        const char *token_end = field_end(cursor, line_end);
+        field[fields] = cursor;
+        field_stop[fields++] = token_end;
+        if (token_end == line_end)
+          break;
+        cursor = token_end + 1;
+      }
+
+      uint64_t seq;
+      uint64_t ts;
+      int64_t ticks;
+      if (fields < 7 || !parse_uint(field[0], field_stop[0], seq) ||
+          !parse_uint(field[1], field_stop[1], ts) ||
+          !codec_.parse_price_ticks(field[4], field_stop[4], ticks))
+        continue;
+      EventType type = parse_event_type(field[3], field_stop[3]);
+      if (type == EventType::UNKNOWN)
+        continue;
+
+      ++lines;
+      if (!have_ts) {
+        stats.first_ts = ts;
+        have_ts = true;
+      }
+      stats.last_ts = std::max(stats.last_ts, ts);
+
+      if (batch > 0 && seq == batch_seq) {
+        ++batch;
+      } else {
+        batch_seq = seq;
+        batch = 1;
+      }
+      stats.max_batch = std::max(stats.max_batch, batch);
+
+      uint64_t order_id;
+      if (w == 0 && fields == 8 &&
+          parse_uint(field[7], field_stop[7], order_id)) {
+        if (type == EventType::ADD)
+          live_orders.insert(order_id);
+        else if (type == EventType::CANCEL)
+          live_orders.erase(order_id);
+        stats.peak_l3_orders =
+            std::max(stats.peak_l3_orders, live_orders.size());
+      }
+    }
+    stats.bytes_scanned += read;
+  }
+
+  stats.events = lines;
+  if (stats.sampled && stats.bytes_scanned > 0)
+    stats.events = static_cast<uint64_t>(static_cast<double>(lines) *
+                                         stats.bytes / stats.bytes_scanned);
+
+  reset();
+  return stats;
 }
 
+template class BasicEventReader<DynamicInstrument>;
+template class BasicEventReader<BtcUsdtInstrument>;
+
 } // namespace lob
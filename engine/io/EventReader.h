@@ -4,50 +4,274 @@
 #include <crtdbg.h>
 #endif
 
+#include "../order_book/Instrument.h"
 #include "../order_book/Order.h"
+#include <cstdint>
 #include <fstream>
+#include <limits>
 #include <optional>
 #include <string>
+#include <vector>
 
 namespace lob {
 
+// Event types: L2 level updates (absolute volume at a price) and true L3
+// market-by-order messages keyed by exchange order id
+enum class EventType : uint8_t {
+  SNAPSHOT, // L2: level volume from the initial snapshot
+  UPDATE,   // L2: level volume from a depth delta
+  ADD,      // L3: new order
+  MODIFY,   // L3: order price/size change
+  CANCEL,   // L3: order removed
+  UNKNOWN
+};
+
+inline bool is_l3_event(EventType type) {
+  return type == EventType::ADD || type == EventType::MODIFY ||
+         type == EventType::CANCEL;
+}
+
+EventType parse_event_type(const char *begin, const char *end);
+const char *to_string(EventType type);
+
 // Parsed event structure
-// New format:
+// L2 format:
 // exchange_seq|exchange_event_ts|local_ingest_ts|event_type|price|qty|side
+// L3 format (ADD/MODIFY/CANCEL) appends the exchange order id:
+// exchange_seq|exchange_event_ts|local_ingest_ts|event_type|price|qty|side|order_id
 struct Event {
-  uint64_t exchange_seq;  // Sequence number from exchange
-  uint64_t exchange_ts;   // Event timestamp from exchange (ms)
-  uint64_t local_ts;      // Local ingestion timestamp (ms)
-  std::string event_type; // SNAPSHOT, UPDATE
+  uint64_t exchange_seq; // Sequence number from exchange
+  uint64_t exchange_ts;  // Event timestamp from exchange (ms)
+  uint64_t local_ts;     // Local ingestion timestamp (ms)
+  EventType event_type;
   double price;
   double quantity;
+  int64_t price_ticks; // Price on the instrument's tick grid
+  int64_t qty_lots;    // Quantity on the instrument's lot grid
   Side side;
+  uint64_t order_id; // Exchange order id (L3 events only)
 
   Event()
-      : exchange_seq(0), exchange_ts(0), local_ts(0), price(0.0), quantity(0.0),
-        side(Side::BID) {}
+      : exchange_seq(0), exchange_ts(0), local_ts(0),
+        event_type(EventType::UNKNOWN), price(0.0), quantity(0.0),
+        price_ticks(0), qty_lots(0), side(Side::BID), order_id(0) {}
+};
+
+// Structure-of-arrays block of decoded events (one column per field) for
+// block-at-a-time consumers. Prices stay on the tick grid; quantity is
+// decoded from qty_lots in one pass when the block is filled.
+struct EventBlock {
+  static constexpr size_t kDefaultCapacity = 4096;
+
+  std::vector<uint64_t> seq;
+  std::vector<uint64_t> exchange_ts;
+  std::vector<uint64_t> local_ts;
+  std::vector<int64_t> price_ticks;
+  std::vector<int64_t> qty_lots;
+  std::vector<double> quantity;
+  std::vector<uint8_t> side; // Side as uint8_t (0 = BID, 1 = ASK)
+  std::vector<uint8_t> type; // EventType as uint8_t
+  std::vector<uint64_t> order_id;
+
+  explicit EventBlock(size_t capacity = kDefaultCapacity)
+      : seq(capacity), exchange_ts(capacity), local_ts(capacity),
+        price_ticks(capacity), qty_lots(capacity), quantity(capacity),
+        side(capacity), type(capacity), order_id(capacity), count_(0) {}
+
+  size_t size() const { return count_; }
+  size_t capacity() const { return seq.size(); }
+  bool empty() const { return count_ == 0; }
+  bool full() const { return count_ == seq.size(); }
+  void clear() { count_ = 0; }
+
+  Side side_at(size_t i) const { return static_cast<Side>(side[i]); }
+  EventType type_at(size_t i) const { return static_cast<EventType>(type[i]); }
+
+  // Scatter one event into the next row (quantity is filled separately)
+  void push_back(const Event &event) {
+    size_t i = count_++;
+    seq[i] = event.exchange_seq;
+    exchange_ts[i] = event.exchange_ts;
+    local_ts[i] = event.local_ts;
+    price_ticks[i] = event.price_ticks;
+    qty_lots[i] = event.qty_lots;
+    side[i] = static_cast<uint8_t>(event.side);
+    type[i] = static_cast<uint8_t>(event.event_type);
+    order_id[i] = event.order_id;
+  }
+
+  // Materialize row i as an Event
+  template <typename Codec> Event event(size_t i, const Codec &codec) const {
+    Event event;
+    event.exchange_seq = seq[i];
+    event.exchange_ts = exchange_ts[i];
+    event.local_ts = local_ts[i];
+    event.event_type = type_at(i);
+    event.price_ticks = price_ticks[i];
+    event.price = codec.ticks_to_price(price_ticks[i]);
+    event.qty_lots = qty_lots[i];
+    event.quantity = quantity[i];
+    event.side = side_at(i);
+    event.order_id = order_id[i];
+    return event;
+  }
+
+private:
+  size_t count_;
+};
+
+// Reader-level predicate (all bounds inclusive). Lines are tested on their
+// cheap leading fields first (seq, exchange_ts, type, side, price) and
+// rejected lines are skipped without parsing the rest.
+struct EventFilter {
+  static constexpr uint32_t kAllTypes = 0xFFFFFFFFu;
+
+  uint64_t min_exchange_ts = 0;
+  uint64_t max_exchange_ts = std::numeric_limits<uint64_t>::max();
+  uint64_t min_seq = 0;
+  uint64_t max_seq = std::numeric_limits<uint64_t>::max();
+  uint32_t type_mask = kAllTypes; // Bit per EventType, see type_bit()
+  bool bids = true;
+  bool asks = true;
+  double min_price = -std::numeric_limits<double>::infinity();
+  double max_price = std::numeric_limits<double>::infinity();
+
+  // Files are recorded in exchange_ts order, which lets the reader bisect
+  // to min_exchange_ts and stop after max_exchange_ts. Clear for files
+  // that are not.
+  bool sorted_by_time = true;
+
+  static constexpr uint32_t type_bit(EventType type) {
+    return 1u << static_cast<uint32_t>(type);
+  }
+
+  bool has_time_range() const {
+    return min_exchange_ts != 0 ||
+           max_exchange_ts != std::numeric_limits<uint64_t>::max();
+  }
+
+  bool active() const {
+    return has_time_range() || min_seq != 0 ||
+           max_seq != std::numeric_limits<uint64_t>::max() ||
+           type_mask != kAllTypes || !bids || !asks ||
+           min_price != -std::numeric_limits<double>::infinity() ||
+           max_price != std::numeric_limits<double>::infinity();
+  }
 };
 
-class EventReader {
+// Summary of an event file used to presize engine structures at startup.
+// Exact for files no larger than the scan budget; otherwise extrapolated
+// from evenly spaced sample windows (max_batch is then a lower bound).
+struct EventFileStats {
+  uint64_t events = 0;       // Event lines (estimated when sampled)
+  size_t max_batch = 0;      // Most rows sharing one sequence number
+  size_t peak_l3_orders = 0; // Most live L3 orders seen from file start
+  uint64_t first_ts = 0;     // First/last exchange_ts (ms)
+  uint64_t last_ts = 0;
+  uint64_t bytes = 0;        // File size
+  uint64_t bytes_scanned = 0; // Bytes read by the scan
+  bool sampled = false;
+
+  uint64_t span_ms() const {
+    return last_ts > first_ts ? last_ts - first_ts : 0;
+  }
+};
+
+// Event file reader specialized on the instrument's price/qty grid.
+// Prices and quantities are parsed straight into ticks/lots; with a
+// StaticInstrument the grid arithmetic is constant-folded.
+template <typename Instrument> class BasicEventReader {
 public:
-  explicit EventReader(const std::string &filepath);
-  ~EventReader();
+  explicit BasicEventReader(const std::string &filepath,
+                            const Instrument &instrument = Instrument());
+  ~BasicEventReader();
 
   // Read next event from file
   std::optional<Event> read_next();
 
+  // Decode up to block.capacity() events into block (replacing its
+  // contents). Returns the number decoded; 0 at end of file. Malformed
+  // lines are reported and skipped, as with read_next().
+  size_t read_block(EventBlock &block);
+
   // Check if more events are available
   bool has_more() const;
 
-  // Reset to beginning of file
+  // False if the file could not be opened
+  bool is_open() const { return file_.is_open(); }
+
+  // Reset to beginning of file (or of the filter's time range)
   void reset();
 
+  // Byte offset of the next unread line, and resuming there (e.g. from a
+  // checkpoint). The offset must be one returned by tell().
+  uint64_t tell() const { return buffer_offset_ + pos_; }
+  void seek_to(uint64_t offset) {
+    exhausted_ = false;
+    seek(offset);
+  }
+
+  // Only return events matching the filter. With a time range on a
+  // time-sorted file this seeks straight to the first candidate line.
+  void set_filter(const EventFilter &filter);
+  const EventFilter &filter() const { return filter_; }
+
+  // Lines rejected by the filter since construction
+  uint64_t lines_filtered() const { return lines_filtered_; }
+
+  const PriceCodec<Instrument> &codec() const { return codec_; }
+
+  // Pre-scan the file for presizing stats, reading at most budget bytes
+  // (whole file if it fits, else kScanWindows evenly spaced windows), then
+  // rewind as reset() does. Malformed lines are skipped silently; they are
+  // reported when the replay reaches them.
+  EventFileStats scan_stats(uint64_t budget = kDefaultScanBudget);
+
+  static constexpr uint64_t kDefaultScanBudget = uint64_t(4) << 20;
+
 private:
+  static constexpr size_t kReadChunk = 1 << 20;
+  static constexpr uint64_t kSeekBlock = 64 * 1024; // Bisect granularity
+  static constexpr uint64_t kScanWindows = 8;
+
   std::string filepath_;
   std::ifstream file_;
+  PriceCodec<Instrument> codec_;
+
+  // Chunked line buffer (avoids a getline copy per event)
+  std::vector<char> buffer_;
+  uint64_t buffer_offset_; // File offset of buffer_[0]
+  size_t pos_;
+  size_t end_;
+  bool eof_;
+
+  EventFilter filter_;
+  bool filter_active_;
+  int64_t min_price_ticks_;
+  int64_t max_price_ticks_;
+  bool exhausted_; // Past max_exchange_ts on a sorted file
+  uint64_t lines_filtered_;
+
+  bool next_line(const char *&begin, const char *&end);
+  void seek(uint64_t offset);
+
+  // First exchange_ts of a line starting after offset (max if none)
+  uint64_t exchange_ts_after(uint64_t offset);
+  void seek_to_time(uint64_t min_exchange_ts);
+
+  // Cheap-field predicate on raw line text. False = skip; true = parse
+  // (malformed lines pass so parse_line reports them).
+  bool prefilter(const char *begin, const char *end);
 
   // Parse a line into an Event
-  std::optional<Event> parse_line(const std::string &line);
+  std::optional<Event> parse_line(const char *begin, const char *end);
+  bool decode_line(const char *begin, const char *end, Event &event);
 };
 
+// Instantiated in EventReader.cpp for these instruments
+extern template class BasicEventReader<DynamicInstrument>;
+extern template class BasicEventReader<BtcUsdtInstrument>;
+
+using EventReader = BasicEventReader<DynamicInstrument>;
+
 } // namespace lob
@@ -1,29 +1,444 @@
+#include "export/DatasetExporter.h"
+#include "export/TensorExporter.h"
+#include "io/EventApply.h"
 #include "io/EventReader.h"
+#include "metrics/ControlChannel.h"
+#include "metrics/Diagnostics.h"
+#include "metrics/LatencyHistogram.h"
 #include "metrics/Metrics.h"
+#include "metrics/Probes.h"
+#include "metrics/Trace.h"
+#include "oms/OrderManager.h"
+#include "oms/RiskGate.h"
+#include "order_book/ConsolidatedBook.h"
 #include "order_book/OrderBook.h"
 #include "strategy/Strategy.h"
+#include "strategy/WalkForward.h"
+#include <algorithm>
+#include <charconv>
 #include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
 #include <memory>
+#include <optional>
+#include <sstream>
+#include <unistd.h>
+#include <vector>
 
 using namespace lob;
 
-int main(int argc, char *argv[]) {
-  if (argc < 2) {
-    std::cerr << "Usage: " << argv[0] << " <event_file>" << std::endl;
-    return 1;
+namespace {
+
+struct RunOptions {
+  std::string event_file;
+  std::vector<std::string> extra_files; // Later captures / other venues
+  std::string asset = "BTCUSDT";
+  std::string instruments_file; // Optional runtime instrument specs
+  std::string queue_model = FifoPolicy::name; // L3 decrease allocation
+  LogBackend log_backend = LogBackend::AUTO;  // How metrics logs hit disk
+  std::string trace_file; // Chrome trace-event JSON of engine spans
+  std::string control_fifo; // Command pipe for live reconfiguration
+  std::string dump_file;    // SIGUSR1 snapshots (default per-pid file)
+  uint64_t diag_first = 10;    // Diagnostics reported in full per category
+  uint64_t diag_sample = 1000; // ...then one in this many
+  // Startup scan budget for presizing (0 = no scan)
+  uint64_t prescan_bytes =
+      BasicEventReader<DynamicInstrument>::kDefaultScanBudget;
+  EventFilter filter; // Reader-level predicate pushdown
+
+  // Post-run bootstrap of the strategy's fills (0 resamples = off)
+  BootstrapOptions bootstrap{BootstrapMethod::STATIONARY, 0};
+
+  // Pre-trade limits applied to every strategy order (all off by default)
+  RiskLimits risk;
+
+  // Export mode: replay without strategy/logging and write training data
+  std::string tensor_prefix; // Top-K depth tensor (.npy + .ts.npy)
+  size_t tensor_depth = 10;
+  std::string dataset_file;  // Feature/label rows (columnar)
+  uint64_t sample_ms = 0; // Minimum exchange time between samples
+
+  // Walk-forward mode: rolling train/test windows over a parameter grid
+  bool walk_forward = false;
+  WalkForwardOptions walk;
+  std::vector<size_t> grid_depths{1, 3, 5, 10};
+
+  // Consolidated mode: one capture per venue, merged into one book
+  bool consolidate = false;
+
+  bool exporting() const {
+    return !tensor_prefix.empty() || !dataset_file.empty();
+  }
+};
+
+void print_usage(const char *program) {
+  std::cerr << "Usage: " << program << " <event_file> [options]\n"
+            << "       " << program
+            << " --walk-forward <event_file>... [options]\n"
+            << "       " << program
+            << " --consolidate <venue_file>... [options]\n"
+            << "  --symbol <SYMBOL>       Instrument symbol (default BTCUSDT)\n"
+            << "  --instruments <file>    Load instrument specs at runtime\n"
+            << "  --queue-model <model>   L3 decrease allocation: fifo (default),"
+            << " lifo, prorata, size, mixed\n"
+            << "  --log-backend <name>    Metrics log writer: auto (default),"
+            << " uring, pwrite\n"
+            << "  --trace <file>          Write engine spans as Chrome"
+            << " trace-event JSON (needs LOB_ENABLE_TRACING)\n"
+            << "  --control <fifo>        Accept runtime commands on a named"
+            << " pipe (eval_every, trace, dump, ...)\n"
+            << "  --dump-file <file>      Append SIGUSR1/dump snapshots here"
+            << " (default market_engine.<pid>.dump)\n"
+            << "  --diag-first <n>        Report the first n diagnostics of"
+            << " each kind (default 10)\n"
+            << "  --diag-sample <m>       ...then one in m (default 1000)\n"
+            << "  --prescan-mb <n>        Sample up to n MB of the event file"
+            << " to presize buffers (default 4, 0 = off)\n"
+            << "  --from-ts <ms>, --to-ts <ms>\n"
+            << "                          Only events in this exchange time"
+            << " range (inclusive)\n"
+            << "  --from-seq <n>, --to-seq <n>\n"
+            << "                          Only events in this sequence range\n"
+            << "  --event-types <list>    Comma-separated types, e.g."
+            << " SNAPSHOT,UPDATE\n"
+            << "  --side <bid|ask>        Only events on one side\n"
+            << "  --price-min <p>, --price-max <p>\n"
+            << "                          Only events in this price band\n"
+            << "  --bootstrap <N>         Bootstrap N resamples of the fill"
+            << " PnL series (CIs in summary.log)\n"
+            << "  --bootstrap-method <m>  stationary (default) or block\n"
+            << "  --block-length <L>      Mean bootstrap block length"
+            << " (default n^(1/3))\n"
+            << "  --max-order-qty <q>     Reject orders larger than q\n"
+            << "  --max-position <q>      Limit worst-case absolute position\n"
+            << "  --max-notional <v>      Limit worst-case absolute exposure\n"
+            << "  --max-order-rate <n>    Throttle orders to n per second of"
+            << " local time\n"
+            << "  --order-burst <n>       Throttle bucket depth (default 10)\n"
+            << "  --price-band-bps <b>    Reject limit prices more than b bps"
+            << " from mid\n"
+            << "  --consolidate           Merge one capture per venue (same"
+            << " instrument) into a consolidated book\n"
+            << "  --walk-forward          Optimize the imbalance strategy on"
+            << " rolling train windows, test out of sample\n"
+            << "  --train-ms <ms>, --test-ms <ms>, --step-ms <ms>\n"
+            << "                          Window lengths and stride (default"
+            << " 60000, 20000, test length)\n"
+            << "  --grid-thresholds <list> Imbalance thresholds (default"
+            << " 0.1,0.2,0.3,0.4,0.5)\n"
+            << "  --grid-depths <list>    Imbalance depths (default 1,3,5,10)\n"
+            << "  --export-tensor <prefix> Write top-K depth rows to"
+            << " <prefix>.npy and <prefix>.ts.npy\n"
+            << "  --export-dataset <file> Write feature/label rows (columnar"
+            << " binary) to <file>\n"
+            << "  --tensor-depth <K>      Levels per side in the tensor"
+            << " (default 10)\n"
+            << "  --sample-ms <ms>        Minimum exchange time between export"
+            << " samples (default: every batch)"
+            << std::endl;
+}
+
+// Parse a non-negative integer option value
+template <typename T> bool parse_count(const char *text, T &out) {
+  const char *end = text + std::strlen(text);
+  auto [ptr, ec] = std::from_chars(text, end, out);
+  return ec == std::errc() && ptr == end;
+}
+
+// Parse a price option value
+bool parse_price(const char *text, double &out) {
+  const char *end = text + std::strlen(text);
+  auto [ptr, ec] = std::from_chars(text, end, out);
+  return ec == std::errc() && ptr == end;
+}
+
+// Parse "UPDATE,SNAPSHOT,..." into an EventFilter type mask
+bool parse_event_types(const char *text, uint32_t &mask) {
+  mask = 0;
+  const char *end = text + std::strlen(text);
+  while (text < end) {
+    const char *comma = std::find(text, end, ',');
+    EventType type = parse_event_type(text, comma);
+    if (type == EventType::UNKNOWN)
+      return false;
+    mask |= EventFilter::type_bit(type);
+    text = comma == end ? end : comma + 1;
+  }
+  return mask != 0;
+}
+
+// Parse a comma-separated list of numbers
+template <typename T>
+bool parse_list(const char *text, std::vector<T> &out,
+                bool (*parse)(const char *, T &)) {
+  out.clear();
+  std::string list = text;
+  size_t start = 0;
+  while (start <= list.size()) {
+    size_t comma = list.find(',', start);
+    if (comma == std::string::npos)
+      comma = list.size();
+    T value;
+    if (!parse(list.substr(start, comma - start).c_str(), value))
+      return false;
+    out.push_back(value);
+    start = comma + 1;
   }
+  return !out.empty();
+}
+
+bool parse_args(int argc, char *argv[], RunOptions &options) {
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    bool has_value = (i + 1 < argc);
+
+    if (arg == "--symbol" && has_value) {
+      options.asset = argv[++i];
+    } else if (arg == "--instruments" && has_value) {
+      options.instruments_file = argv[++i];
+    } else if (arg == "--queue-model" && has_value) {
+      options.queue_model = argv[++i];
+    } else if (arg == "--log-backend" && has_value) {
+      if (!parse_log_backend(argv[++i], options.log_backend))
+        return false;
+    } else if (arg == "--trace" && has_value) {
+      options.trace_file = argv[++i];
+    } else if (arg == "--control" && has_value) {
+      options.control_fifo = argv[++i];
+    } else if (arg == "--dump-file" && has_value) {
+      options.dump_file = argv[++i];
+    } else if (arg == "--diag-first" && has_value) {
+      if (!parse_count(argv[++i], options.diag_first))
+        return false;
+    } else if (arg == "--diag-sample" && has_value) {
+      if (!parse_count(argv[++i], options.diag_sample) ||
+          options.diag_sample == 0)
+        return false;
+    } else if (arg == "--prescan-mb" && has_value) {
+      if (!parse_count(argv[++i], options.prescan_bytes))
+        return false;
+      options.prescan_bytes <<= 20;
+    } else if (arg == "--from-ts" && has_value) {
+      if (!parse_count(argv[++i], options.filter.min_exchange_ts))
+        return false;
+    } else if (arg == "--to-ts" && has_value) {
+      if (!parse_count(argv[++i], options.filter.max_exchange_ts))
+        return false;
+    } else if (arg == "--from-seq" && has_value) {
+      if (!parse_count(argv[++i], options.filter.min_seq))
+        return false;
+    } else if (arg == "--to-seq" && has_value) {
+      if (!parse_count(argv[++i], options.filter.max_seq))
+        return false;
+    } else if (arg == "--event-types" && has_value) {
+      if (!parse_event_types(argv[++i], options.filter.type_mask))
+        return false;
+    } else if (arg == "--side" && has_value) {
+      std::string side = argv[++i];
+      if (side != "bid" && side != "ask")
+        return false;
+      options.filter.bids = (side == "bid");
+      options.filter.asks = (side == "ask");
+    } else if (arg == "--price-min" && has_value) {
+      if (!parse_price(argv[++i], options.filter.min_price))
+        return false;
+    } else if (arg == "--price-max" && has_value) {
+      if (!parse_price(argv[++i], options.filter.max_price))
+        return false;
+    } else if (arg == "--bootstrap" && has_value) {
+      if (!parse_count(argv[++i], options.bootstrap.resamples))
+        return false;
+    } else if (arg == "--bootstrap-method" && has_value) {
+      std::string method = argv[++i];
+      if (method != "stationary" && method != "block")
+        return false;
+      options.bootstrap.method = method == "block"
+                                     ? BootstrapMethod::BLOCK
+                                     : BootstrapMethod::STATIONARY;
+    } else if (arg == "--block-length" && has_value) {
+      if (!parse_count(argv[++i], options.bootstrap.block_length))
+        return false;
+    } else if (arg == "--max-order-qty" && has_value) {
+      if (!parse_price(argv[++i], options.risk.max_order_qty))
+        return false;
+    } else if (arg == "--max-position" && has_value) {
+      if (!parse_price(argv[++i], options.risk.max_position))
+        return false;
+    } else if (arg == "--max-notional" && has_value) {
+      if (!parse_price(argv[++i], options.risk.max_notional))
+        return false;
+    } else if (arg == "--max-order-rate" && has_value) {
+      if (!parse_price(argv[++i], options.risk.max_orders_per_sec))
+        return false;
+    } else if (arg == "--order-burst" && has_value) {
+      if (!parse_price(argv[++i], options.risk.burst) ||
+          options.risk.burst < 1.0)
+        return false;
+    } else if (arg == "--price-band-bps" && has_value) {
+      if (!parse_price(argv[++i], options.risk.price_band_bps))
+        return false;
+    } else if (arg == "--walk-forward") {
+      options.walk_forward = true;
+    } else if (arg == "--consolidate") {
+      options.consolidate = true;
+    } else if (arg == "--train-ms" && has_value) {
+      if (!parse_count(argv[++i], options.walk.train_ms) ||
+          options.walk.train_ms == 0)
+        return false;
+    } else if (arg == "--test-ms" && has_value) {
+      if (!parse_count(argv[++i], options.walk.test_ms) ||
+          options.walk.test_ms == 0)
+        return false;
+    } else if (arg == "--step-ms" && has_value) {
+      if (!parse_count(argv[++i], options.walk.step_ms))
+        return false;
+    } else if (arg == "--grid-thresholds" && has_value) {
+      if (!parse_list<double>(argv[++i], options.walk.thresholds,
+                              parse_price))
+        return false;
+    } else if (arg == "--grid-depths" && has_value) {
+      if (!parse_list<size_t>(argv[++i], options.grid_depths,
+                              parse_count<size_t>))
+        return false;
+    } else if (arg == "--export-tensor" && has_value) {
+      options.tensor_prefix = argv[++i];
+    } else if (arg == "--export-dataset" && has_value) {
+      options.dataset_file = argv[++i];
+    } else if (arg == "--tensor-depth" && has_value) {
+      if (!parse_count(argv[++i], options.tensor_depth) ||
+          options.tensor_depth == 0)
+        return false;
+    } else if (arg == "--sample-ms" && has_value) {
+      if (!parse_count(argv[++i], options.sample_ms))
+        return false;
+    } else if (!arg.empty() && arg[0] != '-' && options.event_file.empty()) {
+      options.event_file = arg;
+    } else if (!arg.empty() && arg[0] != '-') {
+      options.extra_files.push_back(arg);
+    } else {
+      return false;
+    }
+  }
+  // Several captures only make sense for walk-forward or consolidation
+  if (!options.extra_files.empty() && !options.walk_forward &&
+      !options.consolidate)
+    return false;
+  return !options.event_file.empty();
+}
+
+// Startup pre-scan: one line of file stats, and the L3 store presized so
+// the id index never rehashes while the book fills
+template <typename Reader>
+EventFileStats prescan(Reader &reader, OrderBook &book,
+                       const RunOptions &options) {
+  EventFileStats stats;
+  if (options.prescan_bytes == 0)
+    return stats;
+
+  stats = reader.scan_stats(options.prescan_bytes);
+  std::cout << "[INFO] Pre-scan: " << (stats.sampled ? "~" : "")
+            << stats.events << " events over " << stats.span_ms() / 1000.0
+            << " s, max batch " << stats.max_batch;
+  if (stats.peak_l3_orders > 0)
+    std::cout << ", " << stats.peak_l3_orders << " live L3 orders";
+  if (stats.sampled)
+    std::cout << " (sampled " << stats.bytes_scanned / (1 << 20) << " of "
+              << stats.bytes / (1 << 20) << " MB)";
+  std::cout << std::endl;
+
+  if (stats.peak_l3_orders > 0)
+    book.reserve_l3(stats.peak_l3_orders * 2);
+  return stats;
+}
+
+// Human-readable snapshot of a running replay (SIGUSR1 / "dump")
+void write_snapshot(std::ostream &out, const OrderBook &book,
+                    const Strategy &strategy, const OrderManager &oms,
+                    const RiskGate &risk, const RuntimeConfig &config,
+                    const LatencyHistogram &latency, uint64_t events,
+                    double elapsed_s) {
+  std::time_t now = std::time(nullptr);
+  char stamp[32];
+  std::strftime(stamp, sizeof(stamp), "%Y-%m-%d %H:%M:%S",
+                std::localtime(&now));
 
-  std::string event_file = argv[1];
-  std::string asset = "BTCUSDT"; // Can be extracted from filename
+  out << "=== Snapshot " << stamp << " ===\n";
+  out << "events " << events << " in " << elapsed_s << " s ("
+      << (elapsed_s > 0.0 ? events / elapsed_s : 0.0) << " events/s)\n";
+  out << "position " << strategy.get_position() << ", pnl "
+      << strategy.get_pnl() << "\n";
+  out << "orders " << oms.submitted() << " submitted, " << oms.fills()
+      << " fills, " << oms.live() << " live; risk rejected "
+      << risk.rejected() << " of " << risk.checked()
+      << (risk.kill_switch() ? " (kill switch ON)" : "") << "\n";
+  out << "config eval_every " << config.eval_every << ", book_log_every "
+      << config.book_log_every << ", latency_log_every "
+      << config.latency_log_every << ", progress_every "
+      << config.progress_every << ", tracing "
+      << (tracing_enabled() ? "on" : "off") << "\n";
+
+  TopOfBook top = book.get_top_of_book();
+  out << "book " << book.half<Side::BID>().size() << " bid / "
+      << book.half<Side::ASK>().size() << " ask levels";
+  if (top.valid())
+    out << ", mid " << top.mid << ", spread " << top.spread
+        << ", imbalance(5) " << book.calculate_imbalance(5);
+  out << "\n";
+
+  DepthArray<10> bids;
+  DepthArray<10> asks;
+  book.get_bid_depth(bids);
+  book.get_ask_depth(asks);
+  const InstrumentSpec &spec = book.instrument();
+  std::ostringstream depth;
+  depth << std::fixed;
+  depth << "      bid_size      bid_price |      ask_price      ask_size\n";
+  for (size_t i = 0; i < std::max(bids.size(), asks.size()); ++i) {
+    depth << "  ";
+    if (i < bids.size())
+      depth << std::setprecision(spec.qty_decimals) << std::setw(12)
+            << bids[i].volume << " " << std::setprecision(spec.price_decimals)
+            << std::setw(14) << bids[i].price;
+    else
+      depth << std::string(27, ' ');
+    depth << " | ";
+    if (i < asks.size())
+      depth << std::setprecision(spec.price_decimals) << std::setw(14)
+            << asks[i].price << " " << std::setprecision(spec.qty_decimals)
+            << std::setw(13) << asks[i].volume;
+    depth << "\n";
+  }
+  out << depth.str();
+
+  out << "event latency: " << latency.count() << " samples, mean "
+      << latency.mean_ns() << " ns, p50 <" << latency.quantile_ns(0.5)
+      << " ns, p99 <" << latency.quantile_ns(0.99) << " ns, max "
+      << latency.max_ns() << " ns\n";
+  latency.write(out);
+  out << std::endl;
+}
+
+// Replay loop, specialized on the instrument so that parsing and tick
+// conversion constant-fold for symbols known at compile time, and on the
+// queue policy so the L3 decrease model is inlined into book updates.
+template <typename Instrument, typename Policy>
+int run_replay(const RunOptions &options, const Instrument &instrument) {
+  const std::string &event_file = options.event_file;
+  const std::string &asset = options.asset;
 
   std::cout << "=== Market Microstructure Engine ===" << std::endl;
   std::cout << "[INFO] Processing events from: " << event_file << std::endl;
 
-  // Initialize components
-  OrderBook order_book(asset);
-  EventReader reader(event_file);
-  MetricsLogger metrics(asset, "../../logs");
+  // Initialize components (book and parser share the instrument's grid)
+  OrderBook order_book(asset, instrument.spec());
+  BasicEventReader<Instrument> reader(event_file, instrument);
+  if (options.filter.active())
+    reader.set_filter(options.filter);
+  MetricsLogger metrics(asset, "../../logs", options.log_backend);
 
   // Initialize strategy (choose one)
   std::unique_ptr<Strategy> strategy =
@@ -31,41 +446,157 @@ int main(int argc, char *argv[]) {
   // Or use: std::make_unique<MarketMakingStrategy>(0.1, 10.0);
 
   std::cout << "[INFO] Using strategy: " << strategy->get_name() << std::endl;
+  std::cout << "[INFO] L3 queue model: " << Policy::name << std::endl;
 
   // Performance counters
   uint64_t events_processed = 0;
   uint64_t total_latency_us = 0;
 
+  // Strategy fills for the post-run bootstrap
+  TradeSeries fills;
+
+  // Signals become market orders; the simulated venue acks and fills them
+  // at mid immediately
+  OrderManager oms;
+  RiskGate risk(options.risk);
+
+  // Live control: SIGUSR1 and the command FIFO only raise a flag; the
+  // work happens here between events
+  RuntimeConfig config;
+  EventFileStats file_stats = prescan(reader, order_book, options);
+  if (file_stats.events > 0)
+    metrics.reserve_latency_samples(
+        file_stats.events / config.latency_log_every + 1);
+  ControlChannel control;
+  control.install_signal_handler();
+  if (!options.control_fifo.empty() && control.open_fifo(options.control_fifo))
+    std::cout << "[INFO] Control FIFO: " << options.control_fifo << std::endl;
+  const std::string dump_file =
+      options.dump_file.empty()
+          ? "market_engine." + std::to_string(getpid()) + ".dump"
+          : options.dump_file;
+  LatencyHistogram event_latency;
+  auto run_start = std::chrono::steady_clock::now();
+  std::vector<ControlCommand> commands;
+
+  auto service_control = [&]() {
+    commands.clear();
+    bool dump = control.take(commands);
+    for (const ControlCommand &command : commands) {
+      if (apply_control_command(command, config)) {
+        std::cout << "[INFO] Control: " << to_string(command.op) << " "
+                  << command.value << std::endl;
+        continue;
+      }
+      switch (command.op) {
+      case ControlOp::DUMP:
+        dump = true;
+        break;
+      case ControlOp::TRACE:
+        if (!kTracingCompiled) {
+          std::cerr << "[WARN] Tracing not compiled in" << std::endl;
+          break;
+        }
+        set_tracing(command.value != 0);
+        std::cout << "[INFO] Control: tracing "
+                  << (command.value ? "on" : "off") << std::endl;
+        break;
+      case ControlOp::TRACE_DUMP:
+        if (write_chrome_trace(command.path))
+          std::cout << "[INFO] Trace written to " << command.path
+                    << std::endl;
+        else
+          std::cerr << "[ERROR] Could not write trace to " << command.path
+                    << std::endl;
+        break;
+      case ControlOp::KILL_SWITCH:
+        risk.set_kill_switch(command.value != 0);
+        std::cout << "[INFO] Control: kill switch "
+                  << (command.value ? "engaged" : "released") << std::endl;
+        break;
+      default:
+        break;
+      }
+    }
+
+    if (dump) {
+      double elapsed_s = std::chrono::duration<double>(
+                             std::chrono::steady_clock::now() - run_start)
+                             .count();
+      std::ofstream out(dump_file, std::ios::app);
+      write_snapshot(out, order_book, *strategy, oms, risk, config,
+                     event_latency, events_processed, elapsed_s);
+      if (out)
+        std::cout << "[INFO] Snapshot written to " << dump_file << std::endl;
+      else
+        std::cerr << "[ERROR] Could not write snapshot to " << dump_file
+                  << std::endl;
+    }
+  };
+
   // Event processing loop
   while (reader.has_more()) {
-    auto event_opt = reader.read_next();
+    // Safe point: no event in flight
+    if (control.pending())
+      service_control();
+
+    std::optional<Event> event_opt;
+    {
+      LOB_TRACE_SPAN("parse");
+      event_opt = reader.read_next();
+    }
     if (!event_opt)
       continue;
 
     Event event = *event_opt;
+    LOB_TRACE_SPAN("event");
 
     // Start processing timer
     auto processing_start = std::chrono::high_resolution_clock::now();
 
-    // Update order book
-    order_book.update_order(event.price, event.quantity, event.side,
-                            event.exchange_ts);
+    // Update order book (price already on the book's tick grid)
+    if (is_l3_event(event.event_type) && !order_book.l3_enabled()) {
+      std::cout << "[INFO] L3 events detected: tracking orders by id"
+                << std::endl;
+    }
+    {
+      LOB_TRACE_SPAN("book apply");
+      apply_event<Policy, Instrument>(order_book, event);
+    }
 
     // Evaluate strategy every N events (to reduce noise)
-    if (events_processed % 10 == 0) {
-      int signal = strategy->evaluate(order_book, event.local_ts);
+    if (events_processed % config.eval_every == 0) {
+      int signal;
+      {
+        LOB_TRACE_SPAN("strategy evaluate");
+        signal = strategy->evaluate(order_book, event.local_ts);
+      }
 
       // Execute trade based on signal
       if (signal != 0) {
-        auto mid_price = order_book.get_mid_price();
-        if (mid_price) {
-          double trade_quantity = signal * 0.01; // Trade 0.01 BTC
-          strategy->update_position(trade_quantity, *mid_price);
+        LOB_PROBE2(signal_emitted, signal, event.local_ts);
+        LOB_TRACE_SPAN("order");
+        TopOfBook top = order_book.get_top_of_book();
+        double trade_quantity = signal * 0.01; // Trade 0.01 BTC
+        Side order_side = signal > 0 ? Side::BID : Side::ASK;
+        if (risk.check(order_side, OrderKind::MARKET, top.mid,
+                       std::abs(trade_quantity), top,
+                       event.local_ts) == RiskCheck::PASSED) {
+          OrderId order =
+              oms.submit(OrderKind::MARKET, order_side, 0,
+                         std::abs(trade_quantity), events_processed,
+                         event.local_ts);
+          oms.acknowledge(order, event.local_ts);
+          oms.fill(order, std::abs(trade_quantity), top.mid, event.local_ts);
+          risk.on_fill(order_side, std::abs(trade_quantity));
+          strategy->update_position(trade_quantity, top.mid);
+          fills.add(event.local_ts, top.mid, trade_quantity);
 
           // Log trade
+          LOB_TRACE_SPAN("log");
           std::string side = (signal > 0) ? "BUY" : "SELL";
-          metrics.log_trade(event.local_ts, *mid_price,
-                            std::abs(trade_quantity), side);
+          metrics.log_trade(event.local_ts, top.mid, std::abs(trade_quantity),
+                            side);
 
           // Log inventory and PnL
           metrics.log_inventory(event.local_ts, strategy->get_position(),
@@ -77,16 +608,15 @@ int main(int argc, char *argv[]) {
     }
 
     // Log order book state periodically
-    if (events_processed % 100 == 0) {
-      auto best_bid = order_book.get_best_bid();
-      auto best_ask = order_book.get_best_ask();
-      auto mid_price = order_book.get_mid_price();
-      auto spread = order_book.get_spread();
+    if (events_processed % config.book_log_every == 0) {
+      LOB_TRACE_SPAN("log");
+      TopOfBook top = order_book.get_top_of_book();
       double imbalance = order_book.calculate_imbalance(5);
 
-      if (best_bid && best_ask && mid_price && spread) {
-        metrics.log_order_book_state(event.local_ts, *best_bid, *best_ask,
-                                     *mid_price, *spread, imbalance);
+      if (top.valid()) {
+        metrics.log_order_book_state(event.local_ts, top.bid_price,
+                                     top.ask_price, top.mid, top.spread,
+                                     imbalance);
       }
     }
 
@@ -97,9 +627,13 @@ int main(int argc, char *argv[]) {
                           .count();
 
     total_latency_us += latency_us;
+    event_latency.record(static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            processing_end - processing_start)
+            .count()));
 
-    // Log latency every 1000 events
-    if (events_processed % 1000 == 0) {
+    // Log latency every N events
+    if (events_processed % config.latency_log_every == 0) {
       metrics.log_latency(event.exchange_ts, event.local_ts,
                           event.local_ts + latency_us);
     }
@@ -107,7 +641,7 @@ int main(int argc, char *argv[]) {
     events_processed++;
 
     // Progress indicator
-    if (events_processed % 10000 == 0) {
+    if (events_processed % config.progress_every == 0) {
       std::cout << "[INFO] Processed " << events_processed << " events"
                 << std::endl;
     }
@@ -117,23 +651,65 @@ int main(int argc, char *argv[]) {
   std::cout << "\n=== Processing Complete ===" << std::endl;
   std::cout << "[STATS] Total events processed: " << events_processed
             << std::endl;
+  if (options.filter.active())
+    std::cout << "[STATS] Lines skipped by filter: " << reader.lines_filtered()
+              << std::endl;
 
   if (events_processed > 0) {
     double avg_latency =
         static_cast<double>(total_latency_us) / events_processed;
     std::cout << "[STATS] Average processing latency: " << avg_latency << " μs"
               << std::endl;
+    std::cout << "[STATS] Event latency p50 < "
+              << event_latency.quantile_ns(0.5) << " ns, p99 < "
+              << event_latency.quantile_ns(0.99) << " ns, max "
+              << event_latency.max_ns() << " ns" << std::endl;
   }
 
   std::cout << "[STATS] Final position: " << strategy->get_position()
             << std::endl;
   std::cout << "[STATS] Final PnL: $" << strategy->get_pnl() << std::endl;
+  std::cout << "[STATS] Orders: " << oms.submitted() << " submitted, "
+            << oms.fills() << " fills, " << oms.cancels() << " cancelled, "
+            << oms.live() << " live" << std::endl;
+  if (risk.rejected() > 0) {
+    std::cout << "[STATS] Risk rejections: " << risk.rejected() << " of "
+              << risk.checked() << " (";
+    const char *separator = "";
+    for (size_t i = 1; i < kRiskCheckCount; ++i) {
+      RiskCheck check = static_cast<RiskCheck>(i);
+      if (risk.rejections(check) == 0)
+        continue;
+      std::cout << separator << to_string(check) << " "
+                << risk.rejections(check);
+      separator = ", ";
+    }
+    std::cout << ")" << std::endl;
+  }
+
+  TopOfBook top = order_book.get_top_of_book();
+  if (top.valid()) {
+    std::cout << "[STATS] Final best bid: $" << top.bid_price << std::endl;
+    std::cout << "[STATS] Final best ask: $" << top.ask_price << std::endl;
+  }
+
+  if (options.bootstrap.resamples > 0) {
+    auto start = std::chrono::steady_clock::now();
+    BootstrapResult ci = bootstrap(fills.pnl_increments(), options.bootstrap);
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
 
-  auto best_bid = order_book.get_best_bid();
-  auto best_ask = order_book.get_best_ask();
-  if (best_bid && best_ask) {
-    std::cout << "[STATS] Final best bid: $" << *best_bid << std::endl;
-    std::cout << "[STATS] Final best ask: $" << *best_ask << std::endl;
+    std::cout << "[STATS] Bootstrap (" << to_string(options.bootstrap.method)
+              << ", " << ci.resamples << " resamples, " << elapsed
+              << " ms) PnL " << ci.pnl.estimate << " [" << ci.pnl.lower
+              << ", " << ci.pnl.upper << "], Sharpe " << ci.sharpe.estimate
+              << " [" << ci.sharpe.lower << ", " << ci.sharpe.upper
+              << "], max drawdown " << ci.max_drawdown.estimate << " ["
+              << ci.max_drawdown.lower << ", " << ci.max_drawdown.upper << "]"
+              << std::endl;
+    metrics.add_bootstrap_result(options.bootstrap.method, ci,
+                                 options.bootstrap.confidence);
   }
 
   metrics.flush();
@@ -141,3 +717,412 @@ int main(int argc, char *argv[]) {
 
   return 0;
 }
+
+// Export loop: rebuild the book from columnar event blocks and sample it
+// once per exchange batch (events sharing a sequence number), optionally
+// thinned to one sample per sample_ms of exchange time. No strategy, no
+// logging.
+template <typename Instrument, typename Policy>
+int run_export(const RunOptions &options, const Instrument &instrument) {
+  std::cout << "=== Market Microstructure Engine: export ===" << std::endl;
+  std::cout << "[INFO] Processing events from: " << options.event_file
+            << std::endl;
+
+  OrderBook order_book(options.asset, instrument.spec());
+  BasicEventReader<Instrument> reader(options.event_file, instrument);
+  if (options.filter.active())
+    reader.set_filter(options.filter);
+  EventFileStats file_stats = prescan(reader, order_book, options);
+
+  std::unique_ptr<TensorExporter> tensor;
+  if (!options.tensor_prefix.empty()) {
+    tensor = std::make_unique<TensorExporter>(options.tensor_prefix,
+                                              options.tensor_depth);
+    if (!tensor->is_open())
+      return 1;
+  }
+
+  std::unique_ptr<DatasetExporter> dataset;
+  if (!options.dataset_file.empty()) {
+    dataset = std::make_unique<DatasetExporter>(options.dataset_file,
+                                                DatasetExporter::Options());
+    if (!dataset->is_open())
+      return 1;
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  uint64_t events_processed = 0;
+  uint64_t next_sample_ts = 0;
+  bool in_batch = false;
+  uint64_t last_seq = 0;
+  uint64_t last_ts = 0;
+  uint64_t last_local_ts = 0;
+
+  auto end_batch = [&]() {
+    bool take_sample = last_ts >= next_sample_ts &&
+                       order_book.get_top_of_book().valid();
+    if (take_sample)
+      next_sample_ts = last_ts + options.sample_ms;
+
+    if (tensor && take_sample)
+      tensor->sample(order_book, last_ts, last_local_ts);
+    if (dataset)
+      dataset->on_batch(order_book, last_ts, last_local_ts, take_sample);
+  };
+
+  // Columnar decode: apply each exchange batch (run of rows sharing a
+  // sequence number) as a block, then sample. Blocks hold at least the
+  // largest batch, so no batch is split across more than two reads.
+  EventBlock block(
+      std::max(EventBlock::kDefaultCapacity, file_stats.max_batch));
+  while (size_t count = reader.read_block(block)) {
+    const uint64_t *seq = block.seq.data();
+    size_t i = 0;
+    while (i < count) {
+      // A new sequence number closes the previous batch
+      if (in_batch && seq[i] != last_seq)
+        end_batch();
+
+      size_t run = i + 1;
+      while (run < count && seq[run] == seq[i])
+        ++run;
+
+      apply_block<Policy, Instrument>(order_book, block, i, run);
+      last_seq = seq[run - 1];
+      last_ts = block.exchange_ts[run - 1];
+      last_local_ts = block.local_ts[run - 1];
+      in_batch = true;
+      i = run;
+    }
+    events_processed += count;
+  }
+  if (in_batch)
+    end_batch();
+
+  std::cout << "[STATS] Total events processed: " << events_processed
+            << std::endl;
+  if (options.filter.active())
+    std::cout << "[STATS] Lines skipped by filter: " << reader.lines_filtered()
+              << std::endl;
+
+  if (tensor) {
+    size_t rows = tensor->rows();
+    if (!tensor->close()) {
+      std::cerr << "[ERROR] Failed to finalize " << options.tensor_prefix
+                << ".npy" << std::endl;
+      return 1;
+    }
+    std::cout << "[STATS] Tensor rows: " << rows << " x "
+              << options.tensor_depth << " levels -> "
+              << options.tensor_prefix << ".npy" << std::endl;
+  }
+
+  if (dataset) {
+    size_t rows = dataset->rows();
+    if (!dataset->close()) {
+      std::cerr << "[ERROR] Failed to finalize " << options.dataset_file
+                << std::endl;
+      return 1;
+    }
+    std::cout << "[STATS] Dataset rows: " << rows << " -> "
+              << options.dataset_file << std::endl;
+  }
+
+  auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                     std::chrono::steady_clock::now() - start)
+                     .count();
+  std::cout << "[STATS] Export time: " << elapsed << " ms" << std::endl;
+  return 0;
+}
+
+// Walk-forward loop: rebuild the book once per capture, recording the
+// strategy's inputs at every evaluation point; all windows and grid cells
+// then run from that shared timeline.
+template <typename Instrument, typename Policy>
+int run_walk_forward(const RunOptions &options, const Instrument &instrument) {
+  std::cout << "=== Market Microstructure Engine: walk-forward ===" << std::endl;
+
+  std::vector<std::string> files{options.event_file};
+  files.insert(files.end(), options.extra_files.begin(),
+               options.extra_files.end());
+
+  auto start = std::chrono::steady_clock::now();
+  SignalTimeline timeline(options.grid_depths);
+  uint64_t events_processed = 0;
+
+  for (const std::string &file : files) {
+    std::cout << "[INFO] Processing events from: " << file << std::endl;
+    OrderBook order_book(options.asset, instrument.spec());
+    BasicEventReader<Instrument> reader(file, instrument);
+    if (!reader.is_open())
+      return 1;
+    if (options.filter.active())
+      reader.set_filter(options.filter);
+
+    size_t first_point = timeline.size();
+    uint64_t file_events = 0;
+    while (reader.has_more()) {
+      auto event_opt = reader.read_next();
+      if (!event_opt)
+        continue;
+      const Event &event = *event_opt;
+
+      apply_event<Policy, Instrument>(order_book, event);
+
+      // Same cadence as the replay loop's strategy evaluation
+      if (file_events % 10 == 0)
+        timeline.record(order_book, event.exchange_ts);
+      file_events++;
+    }
+    events_processed += file_events;
+
+    if (first_point > 0 && first_point < timeline.size() &&
+        timeline.timestamp[first_point] < timeline.timestamp[first_point - 1]) {
+      std::cerr << "[ERROR] Captures must be given in time order: " << file
+                << std::endl;
+      return 1;
+    }
+  }
+
+  auto rebuilt = std::chrono::steady_clock::now();
+  std::vector<WindowResult> windows = walk_forward(timeline, options.walk);
+  auto finished = std::chrono::steady_clock::now();
+
+  if (windows.empty()) {
+    std::cerr << "[ERROR] Capture too short for one " << options.walk.train_ms
+              << " ms train + " << options.walk.test_ms << " ms test window"
+              << std::endl;
+    return 1;
+  }
+
+  double total_pnl = 0.0;
+  size_t total_trades = 0;
+  size_t profitable = 0;
+  for (size_t w = 0; w < windows.size(); ++w) {
+    const WindowResult &window = windows[w];
+    std::cout << "[STATS] Window " << w << ": test [" << window.test_begin
+              << ", " << window.test_end << ") best threshold "
+              << window.best.threshold << " depth " << window.best.depth
+              << " train PnL " << window.train_pnl << " -> test PnL "
+              << window.test.pnl << " (" << window.test.trades << " trades)"
+              << std::endl;
+    total_pnl += window.test.pnl;
+    total_trades += window.test.trades;
+    if (window.test.pnl > 0.0)
+      profitable++;
+  }
+
+  auto ms = [](auto from, auto to) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(to - from)
+        .count();
+  };
+  size_t cells = options.walk.thresholds.size() * options.grid_depths.size();
+  std::cout << "[STATS] Total events processed: " << events_processed
+            << std::endl;
+  std::cout << "[STATS] Evaluation points: " << timeline.size() << std::endl;
+  std::cout << "[STATS] Windows: " << windows.size() << " x " << cells
+            << " grid cells" << std::endl;
+  std::cout << "[STATS] Out-of-sample PnL: $" << total_pnl << " ("
+            << total_trades << " trades, " << profitable << "/"
+            << windows.size() << " windows profitable)" << std::endl;
+  std::cout << "[STATS] Book rebuild: " << ms(start, rebuilt)
+            << " ms, grid search: " << ms(rebuilt, finished) << " ms"
+            << std::endl;
+  return 0;
+}
+
+// Consolidated replay: one capture per venue, merged in exchange time
+// into a ConsolidatedBook. Reports how often each venue sets the
+// consolidated touch and how often venues cross each other.
+template <typename Instrument, typename Policy>
+int run_consolidated(const RunOptions &options, const Instrument &instrument) {
+  std::cout << "=== Market Microstructure Engine: consolidated ==="
+            << std::endl;
+
+  std::vector<std::string> files{options.event_file};
+  files.insert(files.end(), options.extra_files.begin(),
+               options.extra_files.end());
+  if (files.size() > kMaxVenues) {
+    std::cerr << "[ERROR] At most " << kMaxVenues << " venues" << std::endl;
+    return 1;
+  }
+
+  ConsolidatedBook book(options.asset, instrument.spec());
+  std::vector<std::unique_ptr<BasicEventReader<Instrument>>> readers;
+  std::vector<std::optional<Event>> heads(files.size());
+
+  // Next valid event of a venue (malformed lines are reported and skipped)
+  auto advance = [&](size_t venue) {
+    heads[venue].reset();
+    BasicEventReader<Instrument> &reader = *readers[venue];
+    while (!heads[venue] && reader.has_more())
+      heads[venue] = reader.read_next();
+  };
+
+  for (const std::string &file : files) {
+    std::string name = std::filesystem::path(file).stem().string();
+    size_t venue = book.add_venue(name);
+    readers.push_back(
+        std::make_unique<BasicEventReader<Instrument>>(file, instrument));
+    if (!readers.back()->is_open())
+      return 1;
+    if (options.filter.active())
+      readers.back()->set_filter(options.filter);
+    advance(venue);
+    std::cout << "[INFO] Venue " << venue << ": " << name << " (" << file
+              << ")" << std::endl;
+  }
+
+  std::vector<uint64_t> venue_events(files.size(), 0);
+  std::vector<uint64_t> best_bid_events(files.size(), 0);
+  std::vector<uint64_t> best_ask_events(files.size(), 0);
+  uint64_t events_processed = 0;
+  uint64_t touch_changes = 0;
+  uint64_t crossed_events = 0;
+  uint64_t locked_events = 0;
+  TopOfBook last_top;
+
+  auto start = std::chrono::steady_clock::now();
+  while (true) {
+    // Earliest head across venues (ties go to the lower venue index)
+    size_t venue = kNoVenue;
+    for (size_t v = 0; v < heads.size(); ++v) {
+      if (heads[v] && (venue == kNoVenue ||
+                       heads[v]->exchange_ts < heads[venue]->exchange_ts))
+        venue = v;
+    }
+    if (venue == kNoVenue)
+      break;
+
+    book.apply<Policy>(venue, *heads[venue]);
+    venue_events[venue]++;
+    events_processed++;
+
+    TopOfBook top = book.get_top_of_book();
+    if (top.bid_price != last_top.bid_price ||
+        top.ask_price != last_top.ask_price ||
+        top.bid_size != last_top.bid_size ||
+        top.ask_size != last_top.ask_size)
+      touch_changes++;
+    last_top = top;
+    if (book.crossed())
+      crossed_events++;
+    else if (book.locked())
+      locked_events++;
+    for (uint32_t mask = book.best_bid_venues(); mask; mask &= mask - 1)
+      best_bid_events[__builtin_ctz(mask)]++;
+    for (uint32_t mask = book.best_ask_venues(); mask; mask &= mask - 1)
+      best_ask_events[__builtin_ctz(mask)]++;
+
+    advance(venue);
+  }
+  auto elapsed_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now() - start)
+                        .count();
+
+  std::cout << "\n=== Consolidated Summary ===" << std::endl;
+  std::cout << "[STATS] Total events processed: " << events_processed
+            << std::endl;
+  if (events_processed > 0)
+    std::cout << "[STATS] Time per event (read + venue + consolidated): "
+              << elapsed_ns / events_processed << " ns" << std::endl;
+  std::cout << "[STATS] Consolidated touch changes: " << touch_changes
+            << std::endl;
+  std::cout << "[STATS] Events with venues crossed: " << crossed_events
+            << ", locked (bid == ask): " << locked_events << std::endl;
+  for (size_t v = 0; v < book.venue_count(); ++v) {
+    double denominator = events_processed ? events_processed : 1;
+    std::cout << "[STATS] Venue " << book.venue_name(v) << ": "
+              << venue_events[v] << " events, at best bid "
+              << 100.0 * best_bid_events[v] / denominator
+              << "% / best ask " << 100.0 * best_ask_events[v] / denominator
+              << "% of the time" << std::endl;
+  }
+  TopOfBook top = book.get_top_of_book();
+  if (top.valid()) {
+    std::cout << "[STATS] Final consolidated bid: $" << top.bid_price << " x "
+              << top.bid_size << ", ask: $" << top.ask_price << " x "
+              << top.ask_size << std::endl;
+  }
+  return 0;
+}
+
+template <typename Instrument, typename Policy>
+int run_mode(const RunOptions &options, const Instrument &instrument) {
+  if (options.walk_forward)
+    return run_walk_forward<Instrument, Policy>(options, instrument);
+  if (options.consolidate)
+    return run_consolidated<Instrument, Policy>(options, instrument);
+  if (options.exporting())
+    return run_export<Instrument, Policy>(options, instrument);
+  return run_replay<Instrument, Policy>(options, instrument);
+}
+
+// Resolve the queue model once; everything below runs fully specialized
+template <typename Instrument>
+int run_with_queue_model(const RunOptions &options,
+                         const Instrument &instrument) {
+  const std::string &model = options.queue_model;
+
+  if (model == FifoPolicy::name)
+    return run_mode<Instrument, FifoPolicy>(options, instrument);
+  if (model == LifoCancelPolicy::name)
+    return run_mode<Instrument, LifoCancelPolicy>(options, instrument);
+  if (model == ProRataPolicy::name)
+    return run_mode<Instrument, ProRataPolicy>(options, instrument);
+  if (model == SizeWeightedPolicy::name)
+    return run_mode<Instrument, SizeWeightedPolicy>(options, instrument);
+  if (model == MixedTradeCancelPolicy::name)
+    return run_mode<Instrument, MixedTradeCancelPolicy>(options, instrument);
+
+  std::cerr << "[ERROR] Unknown queue model: " << model << std::endl;
+  return 1;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  RunOptions options;
+  if (!parse_args(argc, argv, options)) {
+    print_usage(argv[0]);
+    return 1;
+  }
+
+  if (!options.instruments_file.empty()) {
+    size_t loaded = load_instrument_specs(options.instruments_file);
+    std::cout << "[INFO] Loaded " << loaded << " instrument specs from "
+              << options.instruments_file << std::endl;
+  }
+
+  Diagnostics::instance().set_policy(options.diag_first, options.diag_sample);
+
+  if (!options.trace_file.empty()) {
+    if (kTracingCompiled) {
+      set_trace_thread_name("replay");
+      set_tracing(true);
+    } else {
+      std::cerr << "[WARN] Tracing not compiled in; reconfigure with"
+                << " -DLOB_ENABLE_TRACING=ON" << std::endl;
+    }
+  }
+
+  // Hot symbols run on a compile-time spec unless overridden at runtime
+  const InstrumentSpec &spec = instrument_for(options.asset);
+  int status = (options.asset == "BTCUSDT" && spec == instruments::BTCUSDT)
+                   ? run_with_queue_model(options, BtcUsdtInstrument())
+                   : run_with_queue_model(options, DynamicInstrument(spec));
+
+  Diagnostics::instance().flush();
+  Diagnostics::instance().write_summary(std::cout);
+
+  if (kTracingCompiled && !options.trace_file.empty()) {
+    set_tracing(false);
+    if (write_chrome_trace(options.trace_file))
+      std::cout << "[INFO] Trace written to " << options.trace_file
+                << std::endl;
+    else
+      std::cerr << "[ERROR] Could not write trace to " << options.trace_file
+                << std::endl;
+  }
+  return status;
+}
@@ -0,0 +1,601 @@
+#include "AsyncFileWriter.h"
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <io.h>
+#include <malloc.h>
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#define LOB_HAVE_IO_URING 1
+#endif
+
+namespace lob {
+
+bool parse_log_backend(const std::string &name, LogBackend &out) {
+  if (name == "auto") {
+    out = LogBackend::AUTO;
+  } else if (name == "uring") {
+    out = LogBackend::IO_URING;
+  } else if (name == "pwrite") {
+    out = LogBackend::PWRITE_THREAD;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+namespace {
+
+constexpr size_t kAlignment = 4096;
+
+// Platform file primitives: POSIX, or the MSVCRT/Win32 equivalents under
+// MinGW (no pwrite, no std::aligned_alloc)
+#ifdef _WIN32
+
+char *allocate_aligned(size_t capacity) {
+  return static_cast<char *>(_aligned_malloc(capacity, kAlignment));
+}
+void free_aligned(char *data) { _aligned_free(data); }
+
+int open_for_append(const std::string &path, uint64_t &size) {
+  int fd = ::_open(path.c_str(), _O_WRONLY | _O_CREAT | _O_BINARY,
+                   _S_IREAD | _S_IWRITE);
+  struct _stat64 info;
+  if (fd >= 0)
+    size = ::_fstat64(fd, &info) == 0 ? static_cast<uint64_t>(info.st_size)
+                                      : 0;
+  return fd;
+}
+int close_file(int fd) { return ::_close(fd); }
+
+// pwrite() via WriteFile at an explicit offset
+long long write_at(int fd, const char *data, size_t length,
+                   uint64_t offset) {
+  HANDLE handle = reinterpret_cast<HANDLE>(::_get_osfhandle(fd));
+  OVERLAPPED overlapped;
+  std::memset(&overlapped, 0, sizeof(overlapped));
+  overlapped.Offset = static_cast<DWORD>(offset);
+  overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+  DWORD chunk = static_cast<DWORD>(
+      std::min<size_t>(length, static_cast<size_t>(1) << 30));
+  DWORD written = 0;
+  if (handle == INVALID_HANDLE_VALUE ||
+      !::WriteFile(handle, data, chunk, &written, &overlapped)) {
+    errno = EIO;
+    return -1;
+  }
+  return static_cast<long long>(written);
+}
+
+#else
+
+char *allocate_aligned(size_t capacity) {
+  return static_cast<char *>(std::aligned_alloc(kAlignment, capacity));
+}
+void free_aligned(char *data) { std::free(data); }
+
+int open_for_append(const std::string &path, uint64_t &size) {
+  int fd = ::open(path.c_str(), O_WRONLY | O_CREAT, 0644);
+  struct stat info;
+  if (fd >= 0)
+    size = ::fstat(fd, &info) == 0 ? static_cast<uint64_t>(info.st_size) : 0;
+  return fd;
+}
+int close_file(int fd) { return ::close(fd); }
+
+long long write_at(int fd, const char *data, size_t length,
+                   uint64_t offset) {
+  return ::pwrite(fd, data, length, static_cast<off_t>(offset));
+}
+
+#endif
+
+// Write the rest of a request synchronously (off the engine thread)
+void finish_with_pwrite(IoRequest &request, size_t written) {
+  while (written < request.length) {
+    long long n = write_at(request.fd, request.data + written,
+                           request.length - written, request.offset + written);
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n <= 0) {
+      request.failed.store(true, std::memory_order_relaxed);
+      break;
+    }
+    written += static_cast<size_t>(n);
+  }
+  request.in_flight.store(false, std::memory_order_release);
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// Backends
+// ---------------------------------------------------------------------------
+
+class AsyncIo::Backend {
+public:
+  virtual ~Backend() = default;
+  virtual void submit(IoRequest &request) = 0;
+  virtual const char *name() const = 0;
+};
+
+namespace {
+
+// Worker thread draining a queue of requests with pwrite()
+class PwriteThreadBackend : public AsyncIo::Backend {
+public:
+  PwriteThreadBackend() : stop_(false), worker_([this] { run(); }) {}
+
+  ~PwriteThreadBackend() override {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    ready_.notify_one();
+    worker_.join();
+  }
+
+  void submit(IoRequest &request) override {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      queue_.push_back(&request);
+    }
+    ready_.notify_one();
+  }
+
+  const char *name() const override { return "pwrite thread"; }
+
+private:
+  std::mutex mutex_;
+  std::condition_variable ready_;
+  std::deque<IoRequest *> queue_;
+  bool stop_;
+  std::thread worker_;
+
+  void run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      ready_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+      if (queue_.empty())
+        return; // stop_ with nothing left to write
+
+      IoRequest *request = queue_.front();
+      queue_.pop_front();
+      lock.unlock();
+      finish_with_pwrite(*request, 0);
+      lock.lock();
+    }
+  }
+};
+
+#ifdef LOB_HAVE_IO_URING
+
+// Minimal raw io_uring (no liburing): one submission ring fed by the
+// engine thread, completions reaped by a thread blocked in io_uring_enter.
+class IoUringBackend : public AsyncIo::Backend {
+public:
+  static constexpr unsigned kEntries = 64;
+
+  IoUringBackend() : ring_fd_(-1), stop_(false), submitted_(0) {}
+
+  ~IoUringBackend() override {
+    if (reaper_.joinable()) {
+      stop_.store(true, std::memory_order_relaxed);
+      push(nullptr); // NOP wakes the reaper
+      reaper_.join();
+    }
+    if (sqes_)
+      ::munmap(sqes_, sqes_size_);
+    if (cq_ptr_ && cq_ptr_ != sq_ptr_)
+      ::munmap(cq_ptr_, cq_size_);
+    if (sq_ptr_)
+      ::munmap(sq_ptr_, sq_size_);
+    if (ring_fd_ >= 0)
+      ::close(ring_fd_);
+  }
+
+  // False if the kernel or sandbox refuses io_uring
+  bool init() {
+    io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+    ring_fd_ = static_cast<int>(
+        ::syscall(__NR_io_uring_setup, kEntries, &params));
+    if (ring_fd_ < 0)
+      return false;
+
+    sq_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cq_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (single_mmap)
+      sq_size_ = cq_size_ = std::max(sq_size_, cq_size_);
+
+    sq_ptr_ = ::mmap(nullptr, sq_size_, PROT_READ | PROT_WRITE,
+                     MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQ_RING);
+    if (sq_ptr_ == MAP_FAILED) {
+      sq_ptr_ = nullptr;
+      return false;
+    }
+    cq_ptr_ = single_mmap
+                  ? sq_ptr_
+                  : ::mmap(nullptr, cq_size_, PROT_READ | PROT_WRITE,
+                           MAP_SHARED | MAP_POPULATE, ring_fd_,
+                           IORING_OFF_CQ_RING);
+    if (cq_ptr_ == MAP_FAILED) {
+      cq_ptr_ = nullptr;
+      return false;
+    }
+    sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+    void *sqes = ::mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED)
+      return false;
+    sqes_ = static_cast<io_uring_sqe *>(sqes);
+
+    char *sq = static_cast<char *>(sq_ptr_);
+    sq_head_ = reinterpret_cast<unsigned *>(sq + params.sq_off.head);
+    sq_tail_ = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+    sq_mask_ = *reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+    sq_array_ = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+    sq_entries_ = params.sq_entries;
+
+    char *cq = static_cast<char *>(cq_ptr_);
+    cq_head_ = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+    cq_tail_ = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+    cq_mask_ = *reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+    cqes_ = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+
+    reaper_ = std::thread([this] { reap(); });
+    return true;
+  }
+
+  void submit(IoRequest &request) override { push(&request); }
+
+  const char *name() const override { return "io_uring"; }
+
+private:
+  int ring_fd_;
+  std::atomic<bool> stop_;
+  std::atomic<uint64_t> submitted_; // Orders request setup before reaping
+  std::mutex submit_mutex_;
+  std::thread reaper_;
+  std::unique_ptr<PwriteThreadBackend> fallback_;
+
+  void *sq_ptr_ = nullptr;
+  void *cq_ptr_ = nullptr;
+  size_t sq_size_ = 0;
+  size_t cq_size_ = 0;
+  io_uring_sqe *sqes_ = nullptr;
+  size_t sqes_size_ = 0;
+
+  unsigned *sq_head_ = nullptr;
+  unsigned *sq_tail_ = nullptr;
+  unsigned *sq_array_ = nullptr;
+  unsigned sq_mask_ = 0;
+  unsigned sq_entries_ = 0;
+  unsigned *cq_head_ = nullptr;
+  unsigned *cq_tail_ = nullptr;
+  unsigned cq_mask_ = 0;
+  io_uring_cqe *cqes_ = nullptr;
+
+  // Queue a write (or a NOP for nullptr) and tell the kernel
+  void push(IoRequest *request) {
+    std::lock_guard<std::mutex> lock(submit_mutex_);
+
+    unsigned tail = *sq_tail_;
+    unsigned head = __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+    if (tail - head >= sq_entries_) {
+      // Ring full (more streams than entries): the fallback worker takes
+      // it, so the engine thread still never waits on the disk
+      if (request)
+        fallback().submit(*request);
+      return;
+    }
+
+    unsigned index = tail & sq_mask_;
+    io_uring_sqe &sqe = sqes_[index];
+    std::memset(&sqe, 0, sizeof(sqe));
+    if (request) {
+      sqe.opcode = IORING_OP_WRITE;
+      sqe.fd = request->fd;
+      sqe.addr = reinterpret_cast<uint64_t>(request->data);
+      sqe.len = static_cast<uint32_t>(request->length);
+      sqe.off = request->offset;
+    } else {
+      sqe.opcode = IORING_OP_NOP;
+    }
+    sqe.user_data = reinterpret_cast<uint64_t>(request);
+
+    sq_array_[index] = index;
+    submitted_.fetch_add(1, std::memory_order_release);
+    __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+
+    // The kernel consumed nothing (the reaper's enter never submits), so
+    // withdraw the entry and let the fallback worker write it
+    if (::syscall(__NR_io_uring_enter, ring_fd_, 1, 0, 0, nullptr, 0) < 0 &&
+        request) {
+      __atomic_store_n(sq_tail_, tail, __ATOMIC_RELEASE);
+      fallback().submit(*request);
+    }
+  }
+
+  // Worker for writes the ring could not take (created on first use;
+  // called with submit_mutex_ held)
+  PwriteThreadBackend &fallback() {
+    if (!fallback_)
+      fallback_ = std::make_unique<PwriteThreadBackend>();
+    return *fallback_;
+  }
+
+  void reap() {
+    while (true) {
+      ::syscall(__NR_io_uring_enter, ring_fd_, 0, 1, IORING_ENTER_GETEVENTS,
+                nullptr, 0);
+
+      // The kernel hand-off is invisible to the memory model (and to
+      // sanitizers); pair with the submitter explicitly
+      submitted_.load(std::memory_order_acquire);
+      unsigned head = *cq_head_;
+      unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+      bool stop = false;
+
+      for (; head != tail; ++head) {
+        const io_uring_cqe &cqe = cqes_[head & cq_mask_];
+        auto *request = reinterpret_cast<IoRequest *>(cqe.user_data);
+        if (!request) {
+          stop = stop_.load(std::memory_order_relaxed);
+          continue;
+        }
+        // Short writes and errors (e.g. IORING_OP_WRITE unsupported) are
+        // completed synchronously here, off the engine thread
+        size_t written = cqe.res > 0 ? static_cast<size_t>(cqe.res) : 0;
+        finish_with_pwrite(*request, written);
+      }
+      __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+
+      if (stop)
+        return;
+    }
+  }
+};
+
+#endif // LOB_HAVE_IO_URING
+
+} // namespace
+
+AsyncIo::AsyncIo(LogBackend backend) {
+#ifdef LOB_HAVE_IO_URING
+  if (backend != LogBackend::PWRITE_THREAD) {
+    auto uring = std::make_unique<IoUringBackend>();
+    if (uring->init()) {
+      backend_ = std::move(uring);
+      return;
+    }
+    if (backend == LogBackend::IO_URING) {
+      std::cerr << "[WARN] io_uring unavailable, using pwrite thread"
+                << std::endl;
+    }
+  }
+#else
+  (void)backend;
+#endif
+  backend_ = std::make_unique<PwriteThreadBackend>();
+}
+
+AsyncIo::~AsyncIo() = default;
+
+void AsyncIo::submit(IoRequest &request) {
+  request.in_flight.store(true, std::memory_order_relaxed);
+  backend_->submit(request);
+}
+
+const char *AsyncIo::backend_name() const { return backend_->name(); }
+
+// ---------------------------------------------------------------------------
+// AsyncFileWriter
+// ---------------------------------------------------------------------------
+
+AsyncFileWriter::AsyncFileWriter()
+    : io_(nullptr), fd_(-1), offset_(0), active_(0), failed_(false) {}
+
+AsyncFileWriter::~AsyncFileWriter() {
+  close();
+  for (Buffer &buffer : buffers_)
+    free_aligned(buffer.data);
+}
+
+bool AsyncFileWriter::open(const std::string &path, AsyncIo &io) {
+  // Append to whatever is already there
+  fd_ = open_for_append(path, offset_);
+  if (fd_ < 0)
+    return false;
+
+  io_ = &io;
+  for (Buffer &buffer : buffers_) {
+    if (!reserve(buffer, kSubmitThreshold * 2)) {
+      close_file(fd_);
+      fd_ = -1;
+      return false;
+    }
+  }
+  return true;
+}
+
+bool AsyncFileWriter::reserve(Buffer &buffer, size_t capacity) {
+  if (capacity <= buffer.capacity)
+    return true;
+
+  capacity = (capacity + kAlignment - 1) / kAlignment * kAlignment;
+  char *data = allocate_aligned(capacity);
+  if (!data) {
+    failed_ = true;
+    return false;
+  }
+  if (buffer.size > 0)
+    std::memcpy(data, buffer.data, buffer.size);
+  free_aligned(buffer.data);
+  buffer.data = data;
+  buffer.capacity = capacity;
+  return true;
+}
+
+void AsyncFileWriter::write(const char *data, size_t length) {
+  if (fd_ < 0)
+    return;
+
+  Buffer &active = buffers_[active_];
+  if (active.size + length > active.capacity) {
+    // The other buffer is still on its way to disk: grow, don't wait. Out
+    // of memory drops the write; close() then reports the failure.
+    if (!reserve(active, std::max(active.capacity * 2, active.size + length)))
+      return;
+  }
+  std::memcpy(active.data + active.size, data, length);
+  active.size += length;
+
+  if (active.size >= kSubmitThreshold)
+    try_submit();
+}
+
+bool AsyncFileWriter::try_submit() {
+  Buffer &active = buffers_[active_];
+  Buffer &other = buffers_[1 - active_];
+  if (active.size == 0 ||
+      other.request.in_flight.load(std::memory_order_acquire))
+    return false;
+
+  if (other.request.failed.exchange(false))
+    failed_ = true;
+
+  IoRequest &request = active.request;
+  request.fd = fd_;
+  request.data = active.data;
+  request.length = active.size;
+  request.offset = offset_;
+  offset_ += active.size;
+  io_->submit(request);
+
+  active_ = 1 - active_;
+  other.size = 0;
+  return true;
+}
+
+void AsyncFileWriter::flush() {
+  if (fd_ >= 0)
+    try_submit();
+}
+
+void AsyncFileWriter::wait(const Buffer &buffer) {
+  while (buffer.request.in_flight.load(std::memory_order_acquire))
+    std::this_thread::yield();
+}
+
+bool AsyncFileWriter::close() {
+  if (fd_ < 0)
+    return false;
+
+  while (buffers_[active_].size > 0) {
+    wait(buffers_[1 - active_]);
+    try_submit();
+  }
+  for (Buffer &buffer : buffers_) {
+    wait(buffer);
+    if (buffer.request.failed.exchange(false))
+      failed_ = true;
+  }
+
+  bool ok = close_file(fd_) == 0 && !failed_;
+  fd_ = -1;
+  return ok;
+}
+
+// ---------------------------------------------------------------------------
+// AsyncLogStream
+// ---------------------------------------------------------------------------
+
+AsyncLogStream::Buf::Buf(AsyncFileWriter &writer) : writer_(writer) {
+  setp(staging_, staging_ + sizeof(staging_));
+}
+
+void AsyncLogStream::Buf::drain() {
+  if (pptr() > pbase())
+    writer_.write(pbase(), static_cast<size_t>(pptr() - pbase()));
+  setp(staging_, staging_ + sizeof(staging_));
+}
+
+AsyncLogStream::Buf::int_type AsyncLogStream::Buf::overflow(int_type ch) {
+  drain();
+  if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+    *pptr() = traits_type::to_char_type(ch);
+    pbump(1);
+  }
+  return traits_type::not_eof(ch);
+}
+
+std::streamsize AsyncLogStream::Buf::xsputn(const char *s,
+                                            std::streamsize n) {
+  if (n > epptr() - pptr()) {
+    drain();
+    if (n > epptr() - pptr()) {
+      writer_.write(s, static_cast<size_t>(n));
+      return n;
+    }
+  }
+  std::memcpy(pptr(), s, static_cast<size_t>(n));
+  pbump(static_cast<int>(n));
+  return n;
+}
+
+int AsyncLogStream::Buf::sync() {
+  drain();
+  writer_.flush();
+  return 0;
+}
+
+AsyncLogStream::AsyncLogStream() : std::ostream(nullptr), buf_(writer_) {
+  rdbuf(&buf_);
+}
+
+AsyncLogStream::~AsyncLogStream() { close(); }
+
+bool AsyncLogStream::open(const std::string &path, AsyncIo &io) {
+  if (!writer_.open(path, io)) {
+    setstate(std::ios::failbit);
+    return false;
+  }
+  clear();
+  return true;
+}
+
+void AsyncLogStream::close() {
+  if (!writer_.is_open())
+    return;
+  buf_.pubsync();
+  if (!writer_.close())
+    setstate(std::ios::badbit);
+}
+
+} // namespace lob
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <streambuf>
+#include <string>
+
+namespace lob {
+
+// How log buffers reach the disk
+enum class LogBackend {
+  AUTO,         // io_uring if the kernel allows it, else PWRITE_THREAD
+  IO_URING,     // Writes submitted to an io_uring, completions on a thread
+  PWRITE_THREAD // Writes handed to a worker thread calling pwrite()
+};
+
+bool parse_log_backend(const std::string &name, LogBackend &out);
+
+// One in-flight buffer write. Owned by the submitting stream; the backend
+// clears in_flight (release) once every byte has landed or failed.
+struct IoRequest {
+  int fd = -1;
+  const char *data = nullptr;
+  size_t length = 0;
+  uint64_t offset = 0;
+  std::atomic<bool> in_flight{false};
+  std::atomic<bool> failed{false};
+};
+
+// Shared submission/completion service. Submitting never waits for the
+// disk: io_uring takes the write from the submission ring, the fallback
+// queues it for its worker thread (as does io_uring when its ring is full
+// or the kernel rejects the submission). Short or failed io_uring writes
+// are finished with pwrite() on the completion thread.
+class AsyncIo {
+public:
+  explicit AsyncIo(LogBackend backend = LogBackend::AUTO);
+  ~AsyncIo();
+
+  AsyncIo(const AsyncIo &) = delete;
+  AsyncIo &operator=(const AsyncIo &) = delete;
+
+  void submit(IoRequest &request);
+  const char *backend_name() const;
+
+  class Backend;
+
+private:
+  std::unique_ptr<Backend> backend_;
+};
+
+// Append-only file written through AsyncIo with double buffering: the
+// engine fills one page-aligned buffer while the other is being written.
+// If the disk falls behind, the active buffer grows instead of blocking.
+class AsyncFileWriter {
+public:
+  static constexpr size_t kSubmitThreshold = 256 * 1024;
+
+  AsyncFileWriter();
+  ~AsyncFileWriter();
+
+  AsyncFileWriter(const AsyncFileWriter &) = delete;
+  AsyncFileWriter &operator=(const AsyncFileWriter &) = delete;
+
+  bool open(const std::string &path, AsyncIo &io);
+  bool is_open() const { return fd_ >= 0; }
+
+  void write(const char *data, size_t length);
+
+  // Hand buffered bytes to the backend if the previous write is done
+  // (never waits)
+  void flush();
+
+  // Wait for every byte to reach the file and close it (shutdown only)
+  bool close();
+
+private:
+  struct Buffer {
+    char *data = nullptr;
+    size_t size = 0;
+    size_t capacity = 0;
+    IoRequest request;
+  };
+
+  AsyncIo *io_;
+  int fd_;
+  uint64_t offset_;
+  Buffer buffers_[2];
+  int active_;
+  bool failed_;
+
+  bool reserve(Buffer &buffer, size_t capacity); // false: out of memory
+  bool try_submit();
+  static void wait(const Buffer &buffer);
+};
+
+// std::ostream over an AsyncFileWriter, so formatted logging code is
+// unchanged. flush() is non-blocking; close() drains.
+class AsyncLogStream : public std::ostream {
+public:
+  AsyncLogStream();
+  ~AsyncLogStream() override;
+
+  bool open(const std::string &path, AsyncIo &io);
+  bool is_open() const { return writer_.is_open(); }
+  void close();
+
+private:
+  class Buf : public std::streambuf {
+  public:
+    explicit Buf(AsyncFileWriter &writer);
+
+  protected:
+    int_type overflow(int_type ch) override;
+    std::streamsize xsputn(const char *s, std::streamsize n) override;
+    int sync() override;
+
+  private:
+    AsyncFileWriter &writer_;
+    char staging_[4096];
+
+    void drain();
+  };
+
+  AsyncFileWriter writer_;
+  Buf buf_;
+};
+
+} // namespace lob
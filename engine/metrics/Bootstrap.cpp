@@ -0,0 +1,224 @@
+#include "Bootstrap.h"
+#include "Trace.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <thread>
+
+namespace lob {
+
+std::vector<double> TradeSeries::pnl_increments() const {
+  std::vector<double> increments;
+  if (size() < 2)
+    return increments;
+
+  increments.reserve(size() - 1);
+  double position = quantity[0];
+  for (size_t i = 1; i < size(); ++i) {
+    increments.push_back(position * (price[i] - price[i - 1]));
+    position += quantity[i];
+  }
+  return increments;
+}
+
+const char *to_string(BootstrapMethod method) {
+  return method == BootstrapMethod::BLOCK ? "block" : "stationary";
+}
+
+namespace {
+
+constexpr size_t kChunk = 64; // Resamples per RNG stream
+
+uint64_t splitmix64(uint64_t &state) {
+  uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31);
+}
+
+// xoshiro256**: small state, one stream per chunk of resamples
+class Rng {
+public:
+  Rng(uint64_t seed, uint64_t stream) {
+    uint64_t state = seed ^ (stream * 0xD1B54A32D192ED03ULL);
+    for (uint64_t &word : s_)
+      word = splitmix64(state);
+  }
+
+  uint64_t next() {
+    uint64_t result = rotl(s_[1] * 5, 7) * 9;
+    uint64_t t = s_[1] << 17;
+    s_[2] ^= s_[0];
+    s_[3] ^= s_[1];
+    s_[1] ^= s_[2];
+    s_[0] ^= s_[3];
+    s_[2] ^= t;
+    s_[3] = rotl(s_[3], 45);
+    return result;
+  }
+
+  // Uniform in [0, n) (multiply-shift, negligible bias for n << 2^64)
+  size_t below(size_t n) {
+    return static_cast<size_t>(mul_high(next(), n));
+  }
+
+private:
+  uint64_t s_[4];
+
+  static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+  // High 64 bits of a 64x64 product from 32-bit halves (no __int128, so
+  // the same draws on every target)
+  static uint64_t mul_high(uint64_t a, uint64_t b) {
+    const uint64_t a_lo = a & 0xFFFFFFFFULL, a_hi = a >> 32;
+    const uint64_t b_lo = b & 0xFFFFFFFFULL, b_hi = b >> 32;
+    const uint64_t lo_lo = a_lo * b_lo;
+    const uint64_t hi_lo = a_hi * b_lo;
+    const uint64_t lo_hi = a_lo * b_hi;
+    // Cannot overflow: < 2^32 + 2^32 + (2^32 - 1)^2
+    const uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFFULL) + lo_hi;
+    return a_hi * b_hi + (hi_lo >> 32) + (cross >> 32);
+  }
+};
+
+// Running summary of one (resampled) increment path
+struct PathStats {
+  double sum = 0.0;
+  double sum_sq = 0.0;
+  double peak = 0.0;
+  double max_drawdown = 0.0;
+
+  void add(double x) {
+    sum += x;
+    sum_sq += x * x;
+    peak = std::max(peak, sum);
+    max_drawdown = std::max(max_drawdown, peak - sum);
+  }
+
+  double sharpe(size_t n) const {
+    double mean = sum / static_cast<double>(n);
+    double variance = sum_sq / static_cast<double>(n) - mean * mean;
+    return variance > 1e-24 ? mean / std::sqrt(variance) : 0.0;
+  }
+};
+
+PathStats block_path(const double *x, size_t n, size_t block, Rng &rng) {
+  PathStats stats;
+  size_t starts = n - block + 1;
+  size_t filled = 0;
+  while (filled < n) {
+    const double *src = x + rng.below(starts);
+    size_t take = std::min(block, n - filled);
+    for (size_t k = 0; k < take; ++k)
+      stats.add(src[k]);
+    filled += take;
+  }
+  return stats;
+}
+
+PathStats stationary_path(const double *x, size_t n, uint64_t restart,
+                          Rng &rng) {
+  PathStats stats;
+  size_t pos = rng.below(n);
+  stats.add(x[pos]);
+  for (size_t k = 1; k < n; ++k) {
+    // New block with probability 1/L, else continue (wrapping)
+    if (rng.next() < restart) {
+      pos = rng.below(n);
+    } else if (++pos == n) {
+      pos = 0;
+    }
+    stats.add(x[pos]);
+  }
+  return stats;
+}
+
+// Linear-interpolated percentile of sorted data
+double percentile(const std::vector<double> &sorted, double p) {
+  double rank = p * static_cast<double>(sorted.size() - 1);
+  size_t lo = static_cast<size_t>(rank);
+  size_t hi = std::min(lo + 1, sorted.size() - 1);
+  double frac = rank - static_cast<double>(lo);
+  return sorted[lo] + frac * (sorted[hi] - sorted[lo]);
+}
+
+Interval interval(double estimate, std::vector<double> &samples,
+                  double confidence) {
+  std::sort(samples.begin(), samples.end());
+  double tail = (1.0 - confidence) / 2.0;
+  return Interval{estimate, percentile(samples, tail),
+                  percentile(samples, 1.0 - tail)};
+}
+
+} // namespace
+
+BootstrapResult bootstrap(const std::vector<double> &increments,
+                          const BootstrapOptions &options) {
+  const size_t n = increments.size();
+  BootstrapResult result{};
+  result.observations = n;
+  if (n == 0 || options.resamples == 0)
+    return result;
+
+  size_t block = options.block_length;
+  if (block == 0)
+    block = static_cast<size_t>(std::ceil(std::cbrt(static_cast<double>(n))));
+  block = std::min(std::max<size_t>(block, 1), n);
+  result.block_length = block;
+  result.resamples = options.resamples;
+
+  // P(new block) = 1 / block as a threshold on a 64-bit draw
+  const uint64_t restart =
+      block == 1 ? ~0ULL
+                 : static_cast<uint64_t>(18446744073709551616.0 /
+                                         static_cast<double>(block));
+
+  std::vector<double> pnl(options.resamples);
+  std::vector<double> sharpe(options.resamples);
+  std::vector<double> drawdown(options.resamples);
+
+  const size_t chunks = (options.resamples + kChunk - 1) / kChunk;
+  std::atomic<size_t> next_chunk{0};
+  const double *x = increments.data();
+
+  auto worker = [&]() {
+    for (size_t chunk = next_chunk.fetch_add(1); chunk < chunks;
+         chunk = next_chunk.fetch_add(1)) {
+      LOB_TRACE_SPAN("bootstrap chunk");
+      Rng rng(options.seed, chunk);
+      size_t end = std::min(options.resamples, (chunk + 1) * kChunk);
+      for (size_t r = chunk * kChunk; r < end; ++r) {
+        PathStats stats = options.method == BootstrapMethod::BLOCK
+                              ? block_path(x, n, block, rng)
+                              : stationary_path(x, n, restart, rng);
+        pnl[r] = stats.sum;
+        sharpe[r] = stats.sharpe(n);
+        drawdown[r] = stats.max_drawdown;
+      }
+    }
+  };
+
+  size_t threads = options.threads;
+  if (threads == 0)
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  threads = std::min(threads, chunks);
+
+  std::vector<std::thread> pool;
+  for (size_t t = 1; t < threads; ++t)
+    pool.emplace_back(worker);
+  worker();
+  for (std::thread &thread : pool)
+    thread.join();
+
+  PathStats observed;
+  for (double v : increments)
+    observed.add(v);
+
+  result.pnl = interval(observed.sum, pnl, options.confidence);
+  result.sharpe = interval(observed.sharpe(n), sharpe, options.confidence);
+  result.max_drawdown =
+      interval(observed.max_drawdown, drawdown, options.confidence);
+  return result;
+}
+
+} // namespace lob
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace lob {
+
+// Strategy fills in structure-of-arrays form (one column per field)
+struct TradeSeries {
+  std::vector<uint64_t> timestamp;
+  std::vector<double> price;
+  std::vector<double> quantity; // Signed: + buy, - sell
+
+  void reserve(size_t n) {
+    timestamp.reserve(n);
+    price.reserve(n);
+    quantity.reserve(n);
+  }
+
+  void add(uint64_t ts, double fill_price, double signed_quantity) {
+    timestamp.push_back(ts);
+    price.push_back(fill_price);
+    quantity.push_back(signed_quantity);
+  }
+
+  size_t size() const { return timestamp.size(); }
+  bool empty() const { return timestamp.empty(); }
+
+  // Mark-to-market PnL change between consecutive fills: the position held
+  // after fill i-1 revalued at fill i's price (size() - 1 entries)
+  std::vector<double> pnl_increments() const;
+};
+
+enum class BootstrapMethod {
+  BLOCK,     // Moving blocks of fixed length
+  STATIONARY // Politis-Romano: geometric block lengths, circular wrap
+};
+
+struct BootstrapOptions {
+  BootstrapMethod method = BootstrapMethod::STATIONARY;
+  size_t resamples = 10000;
+  size_t block_length = 0; // Mean block length; 0 = n^(1/3)
+  double confidence = 0.95;
+  uint64_t seed = 42;
+  size_t threads = 0; // 0 = all hardware threads
+};
+
+// Point estimate and percentile interval
+struct Interval {
+  double estimate;
+  double lower;
+  double upper;
+};
+
+struct BootstrapResult {
+  Interval pnl;          // Sum of increments
+  Interval sharpe;       // Mean / stdev of increments (per fill, not annualized)
+  Interval max_drawdown; // Largest peak-to-trough fall of cumulative PnL
+  size_t observations;
+  size_t resamples;
+  size_t block_length;
+};
+
+// Bootstrap confidence intervals for PnL, Sharpe and max drawdown of an
+// increment series. Resamples are split into fixed chunks pulled by worker
+// threads; each chunk has its own RNG stream derived from (seed, chunk),
+// so results do not depend on the thread count. Resampled paths are
+// summarized on the fly without materializing them.
+BootstrapResult bootstrap(const std::vector<double> &increments,
+                          const BootstrapOptions &options = BootstrapOptions());
+
+const char *to_string(BootstrapMethod method);
+
+} // namespace lob
@@ -0,0 +1,279 @@
+#include "ControlChannel.h"
+#include <cerrno>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace lob {
+
+namespace {
+
+constexpr uint32_t kDumpRequested = 1u << 0;
+constexpr uint32_t kCommandsQueued = 1u << 1;
+
+// Set from the signal handler, so it must be lock-free
+std::atomic<uint32_t> g_control_flags{0};
+static_assert(std::atomic<uint32_t>::is_always_lock_free,
+              "control flags are written from a signal handler");
+
+#ifndef _WIN32
+struct sigaction g_previous_action;
+
+void on_sigusr1(int) {
+  g_control_flags.fetch_or(kDumpRequested, std::memory_order_relaxed);
+}
+#endif
+
+bool parse_switch(const std::string &word, uint64_t &out) {
+  if (word == "on" || word == "1") {
+    out = 1;
+    return true;
+  }
+  if (word == "off" || word == "0") {
+    out = 0;
+    return true;
+  }
+  return false;
+}
+
+} // namespace
+
+const char *to_string(ControlOp op) {
+  switch (op) {
+  case ControlOp::DUMP:
+    return "dump";
+  case ControlOp::EVAL_EVERY:
+    return "eval_every";
+  case ControlOp::BOOK_LOG_EVERY:
+    return "book_log_every";
+  case ControlOp::LATENCY_LOG_EVERY:
+    return "latency_log_every";
+  case ControlOp::PROGRESS_EVERY:
+    return "progress_every";
+  case ControlOp::TRACE:
+    return "trace";
+  case ControlOp::TRACE_DUMP:
+    return "trace_dump";
+  default:
+    return "kill_switch";
+  }
+}
+
+bool parse_control_command(const std::string &line, ControlCommand &out) {
+  std::istringstream in(line);
+  std::string name;
+  std::string arg;
+  std::string extra;
+  in >> name >> arg >> extra;
+  if (!extra.empty())
+    return false;
+
+  ControlCommand command;
+  if (name == "dump") {
+    command.op = ControlOp::DUMP;
+    if (!arg.empty())
+      return false;
+  } else if (name == "trace" || name == "kill_switch") {
+    command.op = name == "trace" ? ControlOp::TRACE : ControlOp::KILL_SWITCH;
+    if (!parse_switch(arg, command.value))
+      return false;
+  } else if (name == "trace_dump") {
+    command.op = ControlOp::TRACE_DUMP;
+    command.path = arg;
+    if (arg.empty())
+      return false;
+  } else {
+    if (name == "eval_every")
+      command.op = ControlOp::EVAL_EVERY;
+    else if (name == "book_log_every")
+      command.op = ControlOp::BOOK_LOG_EVERY;
+    else if (name == "latency_log_every")
+      command.op = ControlOp::LATENCY_LOG_EVERY;
+    else if (name == "progress_every")
+      command.op = ControlOp::PROGRESS_EVERY;
+    else
+      return false;
+
+    // Cadences are positive event counts
+    char *end = nullptr;
+    errno = 0;
+    unsigned long long value = std::strtoull(arg.c_str(), &end, 10);
+    if (arg.empty() || *end != '\0' || errno != 0 || value == 0 ||
+        arg[0] == '-')
+      return false;
+    command.value = value;
+  }
+
+  out = command;
+  return true;
+}
+
+bool apply_control_command(const ControlCommand &command,
+                           RuntimeConfig &config) {
+  switch (command.op) {
+  case ControlOp::EVAL_EVERY:
+    config.eval_every = command.value;
+    return true;
+  case ControlOp::BOOK_LOG_EVERY:
+    config.book_log_every = command.value;
+    return true;
+  case ControlOp::LATENCY_LOG_EVERY:
+    config.latency_log_every = command.value;
+    return true;
+  case ControlOp::PROGRESS_EVERY:
+    config.progress_every = command.value;
+    return true;
+  default:
+    return false;
+  }
+}
+
+ControlChannel::~ControlChannel() { close(); }
+
+#ifdef _WIN32
+
+// No SIGUSR1 or named pipes: the channel stays closed and pending() is
+// never raised, so the replay loop runs as without --control
+void ControlChannel::install_signal_handler() {}
+
+bool ControlChannel::open_fifo(const std::string &) {
+  std::cerr << "[WARN] --control and SIGUSR1 snapshots are not supported on "
+               "this platform"
+            << std::endl;
+  return false;
+}
+
+void ControlChannel::close() {}
+
+#else
+
+void ControlChannel::install_signal_handler() {
+  if (signal_installed_)
+    return;
+  struct sigaction action;
+  std::memset(&action, 0, sizeof(action));
+  action.sa_handler = on_sigusr1;
+  sigemptyset(&action.sa_mask);
+  action.sa_flags = SA_RESTART;
+  if (sigaction(SIGUSR1, &action, &g_previous_action) == 0)
+    signal_installed_ = true;
+}
+
+bool ControlChannel::open_fifo(const std::string &path) {
+  if (fifo_fd_ >= 0)
+    return false;
+
+  if (mkfifo(path.c_str(), 0600) == 0) {
+    created_fifo_ = true;
+  } else if (errno != EEXIST) {
+    std::cerr << "[ERROR] Cannot create control FIFO " << path << ": "
+              << std::strerror(errno) << std::endl;
+    return false;
+  }
+
+  struct stat info;
+  if (stat(path.c_str(), &info) != 0 || !S_ISFIFO(info.st_mode)) {
+    std::cerr << "[ERROR] " << path << " exists and is not a FIFO"
+              << std::endl;
+    return false;
+  }
+
+  // Read-write so the pipe never reports EOF between writers, and so
+  // close() can wake the reader by writing to it
+  fifo_fd_ = ::open(path.c_str(), O_RDWR | O_CLOEXEC);
+  if (fifo_fd_ < 0) {
+    std::cerr << "[ERROR] Cannot open control FIFO " << path << ": "
+              << std::strerror(errno) << std::endl;
+    if (created_fifo_)
+      unlink(path.c_str());
+    created_fifo_ = false;
+    return false;
+  }
+
+  fifo_path_ = path;
+  stop_.store(false);
+  reader_ = std::thread(&ControlChannel::read_loop, this);
+  return true;
+}
+
+void ControlChannel::close() {
+  if (reader_.joinable()) {
+    stop_.store(true);
+    ssize_t ignored = ::write(fifo_fd_, "\n", 1);
+    (void)ignored;
+    reader_.join();
+  }
+  if (fifo_fd_ >= 0) {
+    ::close(fifo_fd_);
+    fifo_fd_ = -1;
+  }
+  if (created_fifo_) {
+    unlink(fifo_path_.c_str());
+    created_fifo_ = false;
+  }
+  if (signal_installed_) {
+    sigaction(SIGUSR1, &g_previous_action, nullptr);
+    signal_installed_ = false;
+  }
+}
+
+#endif // _WIN32
+
+bool ControlChannel::pending() const {
+  return g_control_flags.load(std::memory_order_relaxed) != 0;
+}
+
+bool ControlChannel::take(std::vector<ControlCommand> &commands) {
+  uint32_t flags = g_control_flags.exchange(0, std::memory_order_acquire);
+  if (flags & kCommandsQueued) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    commands.insert(commands.end(), queued_.begin(), queued_.end());
+    queued_.clear();
+  }
+  return (flags & kDumpRequested) != 0;
+}
+
+#ifndef _WIN32
+void ControlChannel::read_loop() {
+  std::string line;
+  char chunk[512];
+  while (!stop_.load()) {
+    ssize_t n = ::read(fifo_fd_, chunk, sizeof(chunk));
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n <= 0)
+      break;
+
+    for (ssize_t i = 0; i < n; ++i) {
+      if (chunk[i] != '\n') {
+        line.push_back(chunk[i]);
+        continue;
+      }
+      if (stop_.load())
+        return;
+      if (line.find_first_not_of(" \t\r") != std::string::npos) {
+        ControlCommand command;
+        if (parse_control_command(line, command)) {
+          std::lock_guard<std::mutex> lock(mutex_);
+          queued_.push_back(command);
+          g_control_flags.fetch_or(kCommandsQueued, std::memory_order_release);
+        } else {
+          std::cerr << "[WARN] Ignoring control command: " << line
+                    << std::endl;
+        }
+      }
+      line.clear();
+    }
+  }
+}
+#endif
+
+} // namespace lob
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace lob {
+
+// Replay loop knobs that can change mid-run (all counted in events)
+struct RuntimeConfig {
+  uint64_t eval_every = 10;         // Strategy evaluation cadence
+  uint64_t book_log_every = 100;    // Order book state log sampling
+  uint64_t latency_log_every = 1000; // Latency log sampling
+  uint64_t progress_every = 10000;  // Progress line on stdout
+};
+
+enum class ControlOp {
+  DUMP,              // Snapshot stats/book/histograms (same as SIGUSR1)
+  EVAL_EVERY,        // eval_every <n>
+  BOOK_LOG_EVERY,    // book_log_every <n>
+  LATENCY_LOG_EVERY, // latency_log_every <n>
+  PROGRESS_EVERY,    // progress_every <n>
+  TRACE,             // trace on|off
+  TRACE_DUMP,        // trace_dump <file>
+  KILL_SWITCH        // kill_switch on|off
+};
+
+const char *to_string(ControlOp op);
+
+struct ControlCommand {
+  ControlOp op = ControlOp::DUMP;
+  uint64_t value = 0; // Cadence, or 1/0 for on/off
+  std::string path;   // trace_dump target
+};
+
+// Parse one command line; false (and nothing written) if malformed
+bool parse_control_command(const std::string &line, ControlCommand &out);
+
+// Apply a cadence command to config; false for commands the caller owns
+// (dump, trace, kill switch)
+bool apply_control_command(const ControlCommand &command,
+                           RuntimeConfig &config);
+
+// Out-of-band control for a running replay. SIGUSR1 requests a snapshot
+// dump; a named pipe accepts one command per line, e.g.
+//
+//   echo "eval_every 50" > engine.ctl
+//
+// Neither the signal handler nor the pipe reader touches engine state:
+// they queue work and raise one atomic flag, which the replay loop tests
+// once per event and services between events (the safe point). On Windows
+// the channel is a no-op: open_fifo() warns and fails, no signal is routed.
+class ControlChannel {
+public:
+  ControlChannel() = default;
+  ~ControlChannel();
+
+  ControlChannel(const ControlChannel &) = delete;
+  ControlChannel &operator=(const ControlChannel &) = delete;
+
+  // Route SIGUSR1 to dump requests (previous handler restored on close)
+  void install_signal_handler();
+
+  // Create the FIFO if needed and start the reader thread
+  bool open_fifo(const std::string &path);
+
+  void close();
+
+  // The per-event check: one relaxed load
+  bool pending() const;
+
+  // Consume the pending work: true if a dump was requested; commands
+  // received since the last call are appended to commands
+  bool take(std::vector<ControlCommand> &commands);
+
+private:
+  std::string fifo_path_;
+  int fifo_fd_ = -1;
+  bool created_fifo_ = false;
+  bool signal_installed_ = false;
+  std::thread reader_;
+  std::atomic<bool> stop_{false};
+
+  std::mutex mutex_;
+  std::vector<ControlCommand> queued_;
+
+  void read_loop();
+};
+
+} // namespace lob
@@ -0,0 +1,172 @@
+#include "Diagnostics.h"
+#include <cerrno>
+#include <unistd.h>
+
+namespace lob {
+
+const char *to_string(DiagLevel level) {
+  switch (level) {
+  case DiagLevel::DEBUG:
+    return "DEBUG";
+  case DiagLevel::INFO:
+    return "INFO";
+  case DiagLevel::WARN:
+    return "WARN";
+  default:
+    return "ERROR";
+  }
+}
+
+const char *to_string(DiagCategory category) {
+  switch (category) {
+  case DiagCategory::PARSE_FIELD:
+    return "parse_field";
+  case DiagCategory::PARSE_FORMAT:
+    return "parse_format";
+  case DiagCategory::CROSSED_BOOK:
+    return "crossed_book";
+  case DiagCategory::CROSSED_LEVEL:
+    return "crossed_level";
+  default:
+    return "unknown";
+  }
+}
+
+Diagnostics &Diagnostics::instance() {
+  static Diagnostics diagnostics;
+  return diagnostics;
+}
+
+Diagnostics::Diagnostics() {
+  for (auto &count : counts_)
+    count.store(0, std::memory_order_relaxed);
+}
+
+Diagnostics::~Diagnostics() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  wake_.notify_one();
+  if (writer_.joinable())
+    writer_.join();
+}
+
+void Diagnostics::emit(DiagLevel level, DiagCategory category,
+                       const std::string &message) {
+  uint64_t n = count(category);
+  uint64_t first_n = first_n_.load(std::memory_order_relaxed);
+
+  std::string line;
+  line.reserve(message.size() + 64);
+  line += '[';
+  line += to_string(level);
+  line += "] ";
+  line += message;
+  if (n > first_n) {
+    line += " (";
+    line += to_string(category);
+    line += " #";
+    line += std::to_string(n);
+    line += ", reporting 1 in ";
+    line += std::to_string(sample_every_.load(std::memory_order_relaxed));
+    line += ')';
+  } else if (n == first_n) {
+    line += " (further ";
+    line += to_string(category);
+    line += " reports sampled)";
+  }
+  line += '\n';
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (queue_.size() >= kMaxQueued) {
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    queue_.push_back(std::move(line));
+    enqueued_++;
+    if (!writer_.joinable())
+      writer_ = std::thread(&Diagnostics::writer_loop, this);
+  }
+  wake_.notify_one();
+}
+
+void Diagnostics::set_policy(uint64_t first_n, uint64_t sample_every) {
+  first_n_.store(first_n, std::memory_order_relaxed);
+  sample_every_.store(sample_every ? sample_every : 1,
+                      std::memory_order_relaxed);
+}
+
+void Diagnostics::set_output(int fd) {
+  flush();
+  std::lock_guard<std::mutex> lock(mutex_);
+  fd_ = fd;
+}
+
+void Diagnostics::reset_counts() {
+  for (auto &count : counts_)
+    count.store(0, std::memory_order_relaxed);
+  dropped_.store(0, std::memory_order_relaxed);
+}
+
+void Diagnostics::flush() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  uint64_t target = enqueued_;
+  drained_.wait(lock, [&] { return written_ >= target || !writer_.joinable(); });
+}
+
+void Diagnostics::write_summary(std::ostream &out) const {
+  bool any = false;
+  for (size_t i = 0; i < kDiagCategoryCount; ++i) {
+    uint64_t n = counts_[i].load(std::memory_order_relaxed);
+    if (n == 0)
+      continue;
+    out << (any ? ", " : "[STATS] Diagnostics: ")
+        << to_string(static_cast<DiagCategory>(i)) << " " << n;
+    any = true;
+  }
+  if (!any)
+    return;
+  uint64_t dropped = dropped_.load(std::memory_order_relaxed);
+  if (dropped)
+    out << " (" << dropped << " reports dropped)";
+  out << std::endl;
+}
+
+void Diagnostics::writer_loop() {
+  std::vector<std::string> batch;
+  std::string buffer;
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    wake_.wait(lock, [&] { return stop_ || !queue_.empty(); });
+    if (queue_.empty() && stop_)
+      return;
+
+    // One write per batch, outside the lock
+    batch.swap(queue_);
+    int fd = fd_;
+    lock.unlock();
+    buffer.clear();
+    for (const std::string &line : batch)
+      buffer += line;
+    const char *data = buffer.data();
+    size_t left = buffer.size();
+    while (left > 0) {
+      ssize_t n = ::write(fd, data, left);
+      if (n < 0 && errno == EINTR)
+        continue;
+      if (n <= 0)
+        break;
+      data += n;
+      left -= static_cast<size_t>(n);
+    }
+    lock.lock();
+
+    written_ += batch.size();
+    batch.clear();
+    drained_.notify_all();
+  }
+}
+
+} // namespace lob
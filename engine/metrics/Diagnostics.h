@@ -0,0 +1,122 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace lob {
+
+enum class DiagLevel : uint8_t { DEBUG, INFO, WARN, ERROR };
+
+// Statements below this level compile to nothing (counter included).
+// Override with -DLOB_DIAG_MIN_LEVEL=0 to keep DEBUG diagnostics.
+#ifndef LOB_DIAG_MIN_LEVEL
+#define LOB_DIAG_MIN_LEVEL 1
+#endif
+
+enum class DiagCategory : uint8_t {
+  PARSE_FIELD,   // Malformed field in an event line
+  PARSE_FORMAT,  // Wrong field count in an event line
+  CROSSED_BOOK,  // Crossed book detected and repaired
+  CROSSED_LEVEL, // Level removed by a crossed-book repair
+  kCount
+};
+
+constexpr size_t kDiagCategoryCount =
+    static_cast<size_t>(DiagCategory::kCount);
+
+const char *to_string(DiagLevel level);
+const char *to_string(DiagCategory category);
+
+// Process-wide diagnostics: every occurrence bumps its category counter;
+// only the first first_n of a category, then every sample_every-th, is
+// formatted and queued for a background thread that writes to stderr in
+// batches. A burst of bad lines therefore costs a counter increment per
+// line, not a formatted write per line.
+class Diagnostics {
+public:
+  static Diagnostics &instance();
+
+  ~Diagnostics();
+  Diagnostics(const Diagnostics &) = delete;
+  Diagnostics &operator=(const Diagnostics &) = delete;
+
+  // Count an occurrence; true if it should be reported
+  bool should_report(DiagCategory category) {
+    uint64_t n = counts_[static_cast<size_t>(category)].fetch_add(
+                     1, std::memory_order_relaxed) +
+                 1;
+    return n <= first_n_.load(std::memory_order_relaxed) ||
+           n % sample_every_.load(std::memory_order_relaxed) == 0;
+  }
+
+  // Queue a message for the sink (never blocks on the output)
+  void emit(DiagLevel level, DiagCategory category,
+            const std::string &message);
+
+  void set_policy(uint64_t first_n, uint64_t sample_every);
+
+  // Redirect the sink (default: stderr); the fd is not closed
+  void set_output(int fd);
+
+  uint64_t count(DiagCategory category) const {
+    return counts_[static_cast<size_t>(category)].load(
+        std::memory_order_relaxed);
+  }
+  uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+  void reset_counts();
+
+  // Block until everything queued so far has been written
+  void flush();
+
+  // "[STATS] Diagnostics: ..." for categories that occurred
+  void write_summary(std::ostream &out) const;
+
+private:
+  static constexpr size_t kMaxQueued = 4096;
+
+  Diagnostics();
+
+  std::array<std::atomic<uint64_t>, kDiagCategoryCount> counts_;
+  std::atomic<uint64_t> first_n_{10};
+  std::atomic<uint64_t> sample_every_{1000};
+  std::atomic<uint64_t> dropped_{0};
+
+  // Async sink
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::condition_variable drained_;
+  std::vector<std::string> queue_;
+  uint64_t enqueued_ = 0;
+  uint64_t written_ = 0;
+  int fd_ = 2;
+  bool stop_ = false;
+  std::thread writer_;
+
+  void writer_loop();
+};
+
+} // namespace lob
+
+// Report a diagnostic; the message is a stream expression that is only
+// evaluated when this occurrence is reported:
+//   LOB_DIAG(DiagLevel::WARN, DiagCategory::CROSSED_BOOK, "bid " << p);
+#define LOB_DIAG(level, category, message)                                   \
+  do {                                                                       \
+    if constexpr (static_cast<int>(level) >= LOB_DIAG_MIN_LEVEL) {           \
+      ::lob::Diagnostics &lob_diag_ = ::lob::Diagnostics::instance();        \
+      if (lob_diag_.should_report(category)) {                               \
+        std::ostringstream lob_diag_message_;                                \
+        lob_diag_message_ << message;                                        \
+        lob_diag_.emit(level, category, lob_diag_message_.str());            \
+      }                                                                      \
+    }                                                                        \
+  } while (0)
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <ostream>
+
+namespace lob {
+
+// Log2-bucketed latency histogram: bucket b counts samples in
+// [2^(b-1), 2^b) nanoseconds (bucket 0 holds zero). Recording is a
+// count-leading-zeros and an increment, cheap enough for every event.
+class LatencyHistogram {
+public:
+  static constexpr size_t kBuckets = 64;
+
+  void record(uint64_t ns) {
+    buckets_[bucket(ns)]++;
+    count_++;
+    total_ns_ += ns;
+    if (ns > max_ns_)
+      max_ns_ = ns;
+  }
+
+  uint64_t count() const { return count_; }
+  uint64_t max_ns() const { return max_ns_; }
+  double mean_ns() const {
+    return count_ ? static_cast<double>(total_ns_) / count_ : 0.0;
+  }
+
+  // Upper bound of the bucket holding the q-quantile (0 < q <= 1)
+  uint64_t quantile_ns(double q) const {
+    uint64_t target = static_cast<uint64_t>(q * count_);
+    if (target == 0)
+      target = 1;
+    uint64_t seen = 0;
+    for (size_t b = 0; b < kBuckets; ++b) {
+      seen += buckets_[b];
+      if (seen >= target)
+        return upper_bound(b);
+    }
+    return max_ns_;
+  }
+
+  void clear() { *this = LatencyHistogram(); }
+
+  // One line per non-empty bucket: "[lo, hi) ns count"
+  void write(std::ostream &out) const {
+    for (size_t b = 0; b < kBuckets; ++b) {
+      if (buckets_[b] == 0)
+        continue;
+      out << "  [" << (b ? upper_bound(b - 1) : 0) << ", " << upper_bound(b)
+          << ") ns " << buckets_[b] << "\n";
+    }
+  }
+
+private:
+  std::array<uint64_t, kBuckets> buckets_{};
+  uint64_t count_ = 0;
+  uint64_t total_ns_ = 0;
+  uint64_t max_ns_ = 0;
+
+  static size_t bucket(uint64_t ns) {
+    if (ns == 0)
+      return 0;
+    size_t b = 64 - static_cast<size_t>(__builtin_clzll(ns));
+    return b < kBuckets ? b : kBuckets - 1;
+  }
+  static uint64_t upper_bound(size_t b) {
+    return b >= 63 ? UINT64_MAX : (uint64_t{1} << b);
+  }
+};
+
+} // namespace lob
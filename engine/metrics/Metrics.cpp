@@ -5,8 +5,9 @@
 namespace lob {
 
 MetricsLogger::MetricsLogger(const std::string &asset,
-                             const std::string &output_dir)
-    : asset_(asset), total_events_(0), total_trades_(0) {
+                             const std::string &output_dir,
+                             LogBackend backend)
+    : asset_(asset), io_(backend), total_events_(0), total_trades_(0) {
 
   // Generate timestamp for the session folder
   auto now = std::chrono::system_clock::now();
@@ -30,12 +31,12 @@ MetricsLogger::MetricsLogger(const std::string &asset,
   std::filesystem::create_directories(output_dir_);
 
   // Open log files
-  trades_log_.open(output_dir_ + "/trades.log", std::ios::app);
-  latency_log_.open(output_dir_ + "/latency.log", std::ios::app);
-  inventory_log_.open(output_dir_ + "/inventory.log", std::ios::app);
-  pnl_log_.open(output_dir_ + "/pnl.log", std::ios::app);
-  orderbook_log_.open(output_dir_ + "/orderbook.log", std::ios::app);
-  summary_log_.open(output_dir_ + "/summary.log", std::ios::app);
+  trades_log_.open(output_dir_ + "/trades.log", io_);
+  latency_log_.open(output_dir_ + "/latency.log", io_);
+  inventory_log_.open(output_dir_ + "/inventory.log", io_);
+  pnl_log_.open(output_dir_ + "/pnl.log", io_);
+  orderbook_log_.open(output_dir_ + "/orderbook.log", io_);
+  summary_log_.open(output_dir_ + "/summary.log", io_);
 
   // Write headers with EXPLICIT UNITS
   if (trades_log_.is_open()) {
@@ -63,6 +64,7 @@ MetricsLogger::MetricsLogger(const std::string &asset,
 
   std::cout << "[INFO] Metrics logger initialized for " << asset_ << std::endl;
   std::cout << "[INFO] Log files created in: " << output_dir_ << std::endl;
+  std::cout << "[INFO] Log writer: " << io_.backend_name() << std::endl;
 }
 
 MetricsLogger::~MetricsLogger() {
@@ -85,6 +87,11 @@ MetricsLogger::~MetricsLogger() {
     summary_log_.close();
 }
 
+void MetricsLogger::reserve_latency_samples(size_t samples) {
+  ingest_latencies_us_.reserve(samples);
+  processing_latencies_us_.reserve(samples);
+}
+
 void MetricsLogger::log_trade(uint64_t timestamp, double price, double quantity,
                               const std::string &side) {
   if (trades_log_.is_open()) {
@@ -160,6 +167,12 @@ void MetricsLogger::flush() {
     summary_log_.flush();
 }
 
+void MetricsLogger::add_bootstrap_result(BootstrapMethod method,
+                                         const BootstrapResult &result,
+                                         double confidence) {
+  bootstrap_results_.push_back(BootstrapEntry{method, result, confidence});
+}
+
 void MetricsLogger::generate_summary() {
   if (!summary_log_.is_open())
     return;
@@ -221,6 +234,23 @@ void MetricsLogger::generate_summary() {
     summary_log_ << "  Max:  " << proc_max << " us" << "\n\n";
   }
 
+  // Bootstrap confidence intervals for the strategy's fills
+  for (const BootstrapEntry &entry : bootstrap_results_) {
+    const BootstrapResult &r = entry.result;
+    summary_log_ << "--- Bootstrap CI (" << to_string(entry.method) << ", "
+                 << entry.confidence * 100.0 << "%, " << r.resamples
+                 << " resamples, block " << r.block_length << ", "
+                 << r.observations << " observations) ---" << "\n";
+    summary_log_ << "  PnL:          " << r.pnl.estimate << " ["
+                 << r.pnl.lower << ", " << r.pnl.upper << "] USD" << "\n";
+    summary_log_ << "  Sharpe:       " << r.sharpe.estimate << " ["
+                 << r.sharpe.lower << ", " << r.sharpe.upper
+                 << "] per fill" << "\n";
+    summary_log_ << "  Max Drawdown: " << r.max_drawdown.estimate << " ["
+                 << r.max_drawdown.lower << ", " << r.max_drawdown.upper
+                 << "] USD" << "\n\n";
+  }
+
   summary_log_ << "=== END SUMMARY ===" << "\n";
 
   std::cout << "[INFO] Performance summary written to: " << output_dir_
@@ -9,13 +9,16 @@
 #include <string>
 #include <vector>
 
+#include "AsyncFileWriter.h"
+#include "Bootstrap.h"
 
 namespace lob {
 
 class MetricsLogger {
 public:
   MetricsLogger(const std::string &asset,
-                const std::string &output_dir = "./logs");
+                const std::string &output_dir = "./logs",
+                LogBackend backend = LogBackend::AUTO);
   ~MetricsLogger();
 
   // Log different types of metrics
@@ -33,9 +36,18 @@ public:
                             double best_ask, double mid_price, double spread,
                             double imbalance);
 
-  // Flush all buffers
+  // Hand buffered lines to the writer backend (never waits on the disk)
   void flush();
 
+  // Presize the latency series for the expected number of log_latency calls
+  void reserve_latency_samples(size_t samples);
+
+  const char *backend_name() const { return io_.backend_name(); }
+
+  // Bootstrap intervals to include in the summary
+  void add_bootstrap_result(BootstrapMethod method,
+                            const BootstrapResult &result, double confidence);
+
   // Generate summary statistics (call at end of session)
   void generate_summary();
 
@@ -43,19 +55,29 @@ private:
   std::string asset_;
   std::string output_dir_;
 
+  // Asynchronous writer shared by all log files (must outlive them)
+  AsyncIo io_;
+
   // File handles
-  std::ofstream trades_log_;
-  std::ofstream latency_log_;
-  std::ofstream inventory_log_;
-  std::ofstream pnl_log_;
-  std::ofstream orderbook_log_;
-  std::ofstream summary_log_;
+  AsyncLogStream trades_log_;
+  AsyncLogStream latency_log_;
+  AsyncLogStream inventory_log_;
+  AsyncLogStream pnl_log_;
+  AsyncLogStream orderbook_log_;
+  AsyncLogStream summary_log_;
 
   // Latency tracking for percentile calculation
   std::vector<int64_t> ingest_latencies_us_; // Exchange -> Local (data arrival)
   std::vector<int64_t>
       processing_latencies_us_; // Local -> Processing (engine latency)
 
+  struct BootstrapEntry {
+    BootstrapMethod method;
+    BootstrapResult result;
+    double confidence;
+  };
+  std::vector<BootstrapEntry> bootstrap_results_;
+
   // Statistics counters
   uint64_t total_events_;
   uint64_t total_trades_;
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <type_traits>
+
+// Statically defined tracepoints (USDT) in the systemtap sys/sdt.h format,
+// self-contained so no systemtap headers are needed to build. Each probe
+// site is a single NOP plus an ELF note (.note.stapsdt) recording its
+// address and where its arguments live; bpftrace, perf and bcc patch the
+// NOP into a breakpoint only while attached:
+//
+//   bpftrace -l 'usdt:./market_engine:lob:*'
+//   bpftrace -e 'usdt:./market_engine:lob:crossed_book_repaired
+//                { printf("%d %d\n", arg0, arg1); }'
+//
+// Arguments must be integers, enums or pointers. They are passed as
+// operands the compiler already has in a register or memory, so keep them
+// cheap to compute: they are evaluated even when nothing is attached.
+// Define LOB_DISABLE_PROBES to compile every probe out.
+//
+// Probes (provider "lob"):
+//   event_parsed          seq, exchange_ts, type, side, price_ticks, qty_lots
+//   batch_applied         side, updates, timestamp, levels on that side
+//   level_created         side, price_ticks
+//   level_erased          side, price_ticks
+//   crossed_book_repaired bid_ticks, ask_ticks, levels removed
+//   signal_emitted        signal, timestamp
+//   fill                  order id, side, quantity (1e-8 units), price (1e-8)
+
+#if !defined(LOB_DISABLE_PROBES) && defined(__ELF__) &&                      \
+    (defined(__GNUC__) || defined(__clang__)) &&                             \
+    (defined(__x86_64__) || defined(__i386__) || defined(__aarch64__))
+#define LOB_PROBES_ENABLED 1
+#else
+#define LOB_PROBES_ENABLED 0
+#endif
+
+namespace lob {
+
+// Fixed-point scale for probe arguments that are doubles in the engine
+constexpr double kProbeScale = 1e8;
+
+// Argument size in bytes, negative when signed (sdt.h "N@operand")
+template <typename T> constexpr int sdt_arg_size() {
+  static_assert(std::is_integral<T>::value || std::is_enum<T>::value ||
+                    std::is_pointer<T>::value,
+                "probe arguments must be integers, enums or pointers");
+  return std::is_signed<T>::value ? -static_cast<int>(sizeof(T))
+                                  : static_cast<int>(sizeof(T));
+}
+
+} // namespace lob
+
+#if LOB_PROBES_ENABLED
+
+#if defined(__LP64__)
+#define LOB_SDT_ADDR ".8byte"
+#else
+#define LOB_SDT_ADDR ".4byte"
+#endif
+
+// The NOP, then a stapsdt note: probe address, base (for prelink
+// adjustment), no semaphore, provider, name and argument format. The "?"
+// section flag keeps notes of discarded COMDAT copies out of the link.
+#define LOB_SDT_ASM(name, args)                                              \
+  "990: nop\n"                                                               \
+  ".pushsection .note.stapsdt,\"?\",\"note\"\n"                              \
+  ".balign 4\n"                                                              \
+  ".4byte 992f-991f, 994f-993f, 3\n"                                         \
+  "991: .asciz \"stapsdt\"\n"                                                \
+  "992: .balign 4\n"                                                         \
+  "993: " LOB_SDT_ADDR " 990b\n" LOB_SDT_ADDR " _.stapsdt.base\n"            \
+  LOB_SDT_ADDR " 0\n"                                                        \
+  ".asciz \"lob\"\n"                                                         \
+  ".asciz \"" #name "\"\n"                                                   \
+  ".asciz \"" args "\"\n"                                                    \
+  "994: .balign 4\n"                                                         \
+  ".popsection\n"                                                            \
+  ".ifndef _.stapsdt.base\n"                                                 \
+  ".pushsection .stapsdt.base,\"aG\",\"progbits\",.stapsdt.base,comdat\n"    \
+  ".weak _.stapsdt.base\n"                                                   \
+  ".hidden _.stapsdt.base\n"                                                 \
+  "_.stapsdt.base: .space 1\n"                                               \
+  ".size _.stapsdt.base, 1\n"                                                \
+  ".popsection\n"                                                            \
+  ".endif\n"
+
+#define LOB_SDT_FMT1 "%c[s1]@%[a1]"
+#define LOB_SDT_FMT2 LOB_SDT_FMT1 " %c[s2]@%[a2]"
+#define LOB_SDT_FMT3 LOB_SDT_FMT2 " %c[s3]@%[a3]"
+#define LOB_SDT_FMT4 LOB_SDT_FMT3 " %c[s4]@%[a4]"
+#define LOB_SDT_FMT5 LOB_SDT_FMT4 " %c[s5]@%[a5]"
+#define LOB_SDT_FMT6 LOB_SDT_FMT5 " %c[s6]@%[a6]"
+
+#define LOB_SDT_ARG(n, x)                                                    \
+  [s##n] "n"(::lob::sdt_arg_size<typename std::decay<decltype(x)>::type>()), \
+      [a##n] "nor"(x)
+
+#define LOB_PROBE0(name) __asm__ __volatile__(LOB_SDT_ASM(name, ""))
+#define LOB_PROBE1(name, a1)                                                 \
+  __asm__ __volatile__(LOB_SDT_ASM(name, LOB_SDT_FMT1)                       \
+                       :                                                     \
+                       : LOB_SDT_ARG(1, a1))
+#define LOB_PROBE2(name, a1, a2)                                             \
+  __asm__ __volatile__(LOB_SDT_ASM(name, LOB_SDT_FMT2)                       \
+                       :                                                     \
+                       : LOB_SDT_ARG(1, a1), LOB_SDT_ARG(2, a2))
+#define LOB_PROBE3(name, a1, a2, a3)                                         \
+  __asm__ __volatile__(LOB_SDT_ASM(name, LOB_SDT_FMT3)                       \
+                       :                                                     \
+                       : LOB_SDT_ARG(1, a1), LOB_SDT_ARG(2, a2),             \
+                         LOB_SDT_ARG(3, a3))
+#define LOB_PROBE4(name, a1, a2, a3, a4)                                     \
+  __asm__ __volatile__(LOB_SDT_ASM(name, LOB_SDT_FMT4)                       \
+                       :                                                     \
+                       : LOB_SDT_ARG(1, a1), LOB_SDT_ARG(2, a2),             \
+                         LOB_SDT_ARG(3, a3), LOB_SDT_ARG(4, a4))
+#define LOB_PROBE5(name, a1, a2, a3, a4, a5)                                 \
+  __asm__ __volatile__(LOB_SDT_ASM(name, LOB_SDT_FMT5)                       \
+                       :                                                     \
+                       : LOB_SDT_ARG(1, a1), LOB_SDT_ARG(2, a2),             \
+                         LOB_SDT_ARG(3, a3), LOB_SDT_ARG(4, a4),             \
+                         LOB_SDT_ARG(5, a5))
+#define LOB_PROBE6(name, a1, a2, a3, a4, a5, a6)                             \
+  __asm__ __volatile__(LOB_SDT_ASM(name, LOB_SDT_FMT6)                       \
+                       :                                                     \
+                       : LOB_SDT_ARG(1, a1), LOB_SDT_ARG(2, a2),             \
+                         LOB_SDT_ARG(3, a3), LOB_SDT_ARG(4, a4),             \
+                         LOB_SDT_ARG(5, a5), LOB_SDT_ARG(6, a6))
+
+#else
+
+#define LOB_PROBE0(name) ((void)0)
+#define LOB_PROBE1(name, a1) ((void)0)
+#define LOB_PROBE2(name, a1, a2) ((void)0)
+#define LOB_PROBE3(name, a1, a2, a3) ((void)0)
+#define LOB_PROBE4(name, a1, a2, a3, a4) ((void)0)
+#define LOB_PROBE5(name, a1, a2, a3, a4, a5) ((void)0)
+#define LOB_PROBE6(name, a1, a2, a3, a4, a5, a6) ((void)0)
+
+#endif
@@ -0,0 +1,159 @@
+#include "Trace.h"
+
+#if LOB_TRACING
+
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace lob {
+
+std::atomic<bool> g_tracing_enabled{false};
+
+namespace {
+
+struct TraceRecord {
+  const char *name;
+  uint64_t begin;
+  uint64_t end;
+};
+
+// One per recording thread; owned by the registry so spans survive the
+// thread (walk-forward and bootstrap workers are joined before export)
+struct TraceRing {
+  static constexpr size_t kCapacity = 1 << 18; // 6 MiB
+
+  std::unique_ptr<TraceRecord[]> records{new TraceRecord[kCapacity]};
+  std::atomic<uint64_t> head{0}; // Total spans ever recorded
+  uint32_t tid = 0;
+  std::string name;
+};
+
+struct TraceRegistry {
+  std::mutex mutex;
+  std::vector<std::unique_ptr<TraceRing>> rings;
+
+  // Clock pairing taken when tracing is first enabled, to convert raw
+  // timestamps to microseconds at export
+  uint64_t origin_ticks = 0;
+  std::chrono::steady_clock::time_point origin_time;
+};
+
+TraceRegistry &registry() {
+  static TraceRegistry instance;
+  return instance;
+}
+
+thread_local TraceRing *t_ring = nullptr;
+
+TraceRing &thread_ring() {
+  if (!t_ring) {
+    TraceRegistry &reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    reg.rings.push_back(std::make_unique<TraceRing>());
+    t_ring = reg.rings.back().get();
+    t_ring->tid = static_cast<uint32_t>(reg.rings.size());
+    t_ring->name = "thread " + std::to_string(t_ring->tid);
+  }
+  return *t_ring;
+}
+
+void write_escaped(std::ostream &out, const char *text) {
+  for (; *text; ++text) {
+    if (*text == '"' || *text == '\\')
+      out << '\\';
+    out << *text;
+  }
+}
+
+} // namespace
+
+void set_tracing(bool enabled) {
+  if (enabled) {
+    TraceRegistry &reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    if (reg.origin_ticks == 0) {
+      reg.origin_time = std::chrono::steady_clock::now();
+      reg.origin_ticks = trace_clock();
+    }
+  }
+  g_tracing_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool tracing_enabled() {
+  return g_tracing_enabled.load(std::memory_order_relaxed);
+}
+
+void set_trace_thread_name(const char *name) { thread_ring().name = name; }
+
+void trace_record(const char *name, uint64_t begin, uint64_t end) {
+  TraceRing &ring = thread_ring();
+  uint64_t head = ring.head.load(std::memory_order_relaxed);
+  ring.records[head & (TraceRing::kCapacity - 1)] = TraceRecord{name, begin,
+                                                                end};
+  ring.head.store(head + 1, std::memory_order_release);
+}
+
+bool write_chrome_trace(const std::string &path) {
+  TraceRegistry &reg = registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+
+  std::ofstream out(path);
+  if (!out)
+    return false;
+
+  // Raw ticks per microsecond over the whole traced interval
+  double ticks_per_us = 1000.0;
+  auto elapsed_us = std::chrono::duration<double, std::micro>(
+                        std::chrono::steady_clock::now() - reg.origin_time)
+                        .count();
+  uint64_t elapsed_ticks = trace_clock() - reg.origin_ticks;
+  if (reg.origin_ticks != 0 && elapsed_us > 0.0 && elapsed_ticks > 0)
+    ticks_per_us = elapsed_ticks / elapsed_us;
+
+  out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+  out << std::fixed << std::setprecision(3);
+  const char *separator = "\n";
+  for (const auto &ring : reg.rings) {
+    out << separator << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,"
+        << "\"tid\":" << ring->tid << ",\"args\":{\"name\":\"";
+    write_escaped(out, ring->name.c_str());
+    out << "\"}}";
+    separator = ",\n";
+
+    uint64_t head = ring->head.load(std::memory_order_acquire);
+    uint64_t first = head > TraceRing::kCapacity ? head - TraceRing::kCapacity
+                                                 : 0;
+    for (uint64_t i = first; i < head; ++i) {
+      const TraceRecord &record =
+          ring->records[i & (TraceRing::kCapacity - 1)];
+      if (record.begin < reg.origin_ticks)
+        continue;
+      double ts = (record.begin - reg.origin_ticks) / ticks_per_us;
+      double dur = (record.end - record.begin) / ticks_per_us;
+      out << separator << "{\"name\":\"";
+      write_escaped(out, record.name);
+      out << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << ring->tid
+          << ",\"ts\":" << ts << ",\"dur\":" << dur << "}";
+    }
+  }
+  out << "\n]}\n";
+  return static_cast<bool>(out);
+}
+
+} // namespace lob
+
+#else
+
+namespace lob {
+
+void set_tracing(bool) {}
+bool tracing_enabled() { return false; }
+void set_trace_thread_name(const char *) {}
+bool write_chrome_trace(const std::string &) { return false; }
+
+} // namespace lob
+
+#endif
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+// Span tracing is compiled in only with -DLOB_TRACING=1 (CMake option
+// LOB_ENABLE_TRACING). Otherwise LOB_TRACE_SPAN expands to nothing and the
+// functions below are inert.
+#ifndef LOB_TRACING
+#define LOB_TRACING 0
+#endif
+
+#if LOB_TRACING
+#include <atomic>
+#include <chrono>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#endif
+
+namespace lob {
+
+constexpr bool kTracingCompiled = LOB_TRACING != 0;
+
+// Runtime switch; spans are only recorded while enabled
+void set_tracing(bool enabled);
+bool tracing_enabled();
+
+// Label for the calling thread in the exported trace
+void set_trace_thread_name(const char *name);
+
+// Write every span recorded so far as Chrome/Perfetto trace-event JSON
+// (load in chrome://tracing or ui.perfetto.dev). Rings are read without
+// locking, so call it from a recording thread at a quiet point or after
+// the other recording threads have finished. False on I/O error or when
+// tracing is compiled out.
+bool write_chrome_trace(const std::string &path);
+
+#if LOB_TRACING
+
+extern std::atomic<bool> g_tracing_enabled;
+
+// Raw timestamp: TSC where available, steady clock nanoseconds elsewhere.
+// Converted to microseconds against the steady clock at export time.
+inline uint64_t trace_clock() {
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  return static_cast<uint64_t>(
+      std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+// Append [begin, end) to the calling thread's ring (oldest overwritten)
+void trace_record(const char *name, uint64_t begin, uint64_t end);
+
+// Scoped span; name must be a string literal (the pointer is kept)
+class TraceSpan {
+public:
+  explicit TraceSpan(const char *name)
+      : name_(name),
+        begin_(g_tracing_enabled.load(std::memory_order_relaxed)
+                   ? trace_clock()
+                   : 0) {}
+  ~TraceSpan() {
+    if (begin_ != 0)
+      trace_record(name_, begin_, trace_clock());
+  }
+
+  TraceSpan(const TraceSpan &) = delete;
+  TraceSpan &operator=(const TraceSpan &) = delete;
+
+private:
+  const char *name_;
+  uint64_t begin_;
+};
+
+#define LOB_TRACE_CONCAT_(a, b) a##b
+#define LOB_TRACE_CONCAT(a, b) LOB_TRACE_CONCAT_(a, b)
+#define LOB_TRACE_SPAN(name)                                                 \
+  ::lob::TraceSpan LOB_TRACE_CONCAT(lob_trace_span_, __LINE__)(name)
+
+#else
+
+#define LOB_TRACE_SPAN(name) ((void)0)
+
+#endif
+
+} // namespace lob
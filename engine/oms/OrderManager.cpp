@@ -0,0 +1,217 @@
+#include "OrderManager.h"
+#include "../metrics/Probes.h"
+
+namespace lob {
+
+const char *to_string(OrderKind kind) {
+  switch (kind) {
+  case OrderKind::LIMIT:
+    return "LIMIT";
+  case OrderKind::MARKET:
+    return "MARKET";
+  default:
+    return "IOC";
+  }
+}
+
+const char *to_string(OrderState state) {
+  switch (state) {
+  case OrderState::NEW:
+    return "NEW";
+  case OrderState::ACKED:
+    return "ACKED";
+  case OrderState::PARTIALLY_FILLED:
+    return "PARTIALLY_FILLED";
+  case OrderState::FILLED:
+    return "FILLED";
+  case OrderState::CANCELLED:
+    return "CANCELLED";
+  default:
+    return "REJECTED";
+  }
+}
+
+namespace {
+
+// Transition table: one bit per source state allowed for each operation
+constexpr uint32_t bit(OrderState state) {
+  return 1u << static_cast<uint32_t>(state);
+}
+
+constexpr uint32_t kCanAck = bit(OrderState::NEW);
+constexpr uint32_t kCanReject = bit(OrderState::NEW);
+constexpr uint32_t kCanFill =
+    bit(OrderState::ACKED) | bit(OrderState::PARTIALLY_FILLED);
+constexpr uint32_t kCanAmend = bit(OrderState::NEW) | bit(OrderState::ACKED) |
+                               bit(OrderState::PARTIALLY_FILLED);
+constexpr uint32_t kCanCancel = kCanAmend;
+
+constexpr double kQtyEpsilon = 1e-12;
+
+inline bool allowed(uint32_t mask, OrderState state) {
+  return (mask & bit(state)) != 0;
+}
+
+} // namespace
+
+OrderManager::OrderManager(size_t capacity)
+    : orders_(capacity), free_head_(kNullSlot), live_head_(kNullSlot),
+      live_count_(0), position_(0.0), cash_(0.0), submitted_(0), fills_(0),
+      cancels_(0), rejects_(0) {
+  // Thread every slot onto the free list, lowest slot first; generations
+  // start at 1 so no handle equals kInvalidOrderId
+  for (size_t i = capacity; i-- > 0;) {
+    OmsOrder &order = orders_[i];
+    order.generation = 1;
+    order.state = OrderState::CANCELLED;
+    order.next = free_head_;
+    free_head_ = static_cast<uint32_t>(i);
+  }
+}
+
+OrderId OrderManager::submit(OrderKind kind, Side side, int64_t price_ticks,
+                             double quantity, uint64_t client_id,
+                             uint64_t timestamp) {
+  if (free_head_ == kNullSlot || !(quantity > kQtyEpsilon))
+    return kInvalidOrderId;
+
+  uint32_t slot = free_head_;
+  OmsOrder &order = orders_[slot];
+  free_head_ = order.next;
+
+  order.client_id = client_id;
+  order.price_ticks = price_ticks;
+  order.quantity = quantity;
+  order.filled = 0.0;
+  order.created_ts = timestamp;
+  order.updated_ts = timestamp;
+  order.side = side;
+  order.kind = kind;
+  order.state = OrderState::NEW;
+
+  // Push onto the live list
+  order.prev = kNullSlot;
+  order.next = live_head_;
+  if (live_head_ != kNullSlot)
+    orders_[live_head_].prev = slot;
+  live_head_ = slot;
+  live_count_++;
+  submitted_++;
+
+  return make_id(slot);
+}
+
+OmsResult OrderManager::acknowledge(OrderId id, uint64_t timestamp) {
+  OmsOrder *order = lookup(id);
+  if (!order)
+    return OmsResult::UNKNOWN_ORDER;
+  if (!allowed(kCanAck, order->state))
+    return OmsResult::INVALID_TRANSITION;
+
+  order->state = OrderState::ACKED;
+  order->updated_ts = timestamp;
+  return OmsResult::OK;
+}
+
+OmsResult OrderManager::reject(OrderId id, uint64_t timestamp) {
+  OmsOrder *order = lookup(id);
+  if (!order)
+    return OmsResult::UNKNOWN_ORDER;
+  if (!allowed(kCanReject, order->state))
+    return OmsResult::INVALID_TRANSITION;
+
+  rejects_++;
+  retire(*order, OrderState::REJECTED, timestamp);
+  return OmsResult::OK;
+}
+
+OmsResult OrderManager::fill(OrderId id, double quantity, double price,
+                             uint64_t timestamp) {
+  OmsOrder *order = lookup(id);
+  if (!order)
+    return OmsResult::UNKNOWN_ORDER;
+  if (!allowed(kCanFill, order->state))
+    return OmsResult::INVALID_TRANSITION;
+  if (!(quantity > kQtyEpsilon) || quantity > order->leaves() + kQtyEpsilon)
+    return OmsResult::INVALID_QUANTITY;
+
+  double signed_qty = order->side == Side::BID ? quantity : -quantity;
+  position_ += signed_qty;
+  cash_ -= signed_qty * price;
+  fills_++;
+  LOB_PROBE4(fill, id, order->side,
+             static_cast<int64_t>(quantity * kProbeScale),
+             static_cast<int64_t>(price * kProbeScale));
+
+  order->filled += quantity;
+  if (order->leaves() <= kQtyEpsilon) {
+    retire(*order, OrderState::FILLED, timestamp);
+  } else {
+    order->state = OrderState::PARTIALLY_FILLED;
+    order->updated_ts = timestamp;
+  }
+  return OmsResult::OK;
+}
+
+OmsResult OrderManager::amend(OrderId id, int64_t price_ticks,
+                              double quantity, uint64_t timestamp) {
+  OmsOrder *order = lookup(id);
+  if (!order)
+    return OmsResult::UNKNOWN_ORDER;
+  if (order->kind != OrderKind::LIMIT || !allowed(kCanAmend, order->state))
+    return OmsResult::INVALID_TRANSITION;
+  if (!(quantity > order->filled + kQtyEpsilon))
+    return OmsResult::INVALID_QUANTITY;
+
+  order->price_ticks = price_ticks;
+  order->quantity = quantity;
+  order->updated_ts = timestamp;
+  return OmsResult::OK;
+}
+
+OmsResult OrderManager::cancel(OrderId id, uint64_t timestamp) {
+  OmsOrder *order = lookup(id);
+  if (!order)
+    return OmsResult::UNKNOWN_ORDER;
+  if (!allowed(kCanCancel, order->state))
+    return OmsResult::INVALID_TRANSITION;
+
+  cancels_++;
+  retire(*order, OrderState::CANCELLED, timestamp);
+  return OmsResult::OK;
+}
+
+size_t OrderManager::cancel_all(uint64_t timestamp) {
+  size_t cancelled = 0;
+  while (live_head_ != kNullSlot) {
+    cancels_++;
+    retire(orders_[live_head_], OrderState::CANCELLED, timestamp);
+    cancelled++;
+  }
+  return cancelled;
+}
+
+void OrderManager::retire(OmsOrder &order, OrderState state,
+                          uint64_t timestamp) {
+  uint32_t slot = static_cast<uint32_t>(&order - orders_.data());
+
+  // Unlink from the live list
+  if (order.prev != kNullSlot)
+    orders_[order.prev].next = order.next;
+  else
+    live_head_ = order.next;
+  if (order.next != kNullSlot)
+    orders_[order.next].prev = order.prev;
+  live_count_--;
+
+  // Stale handles stop resolving once the generation moves on
+  order.state = state;
+  order.updated_ts = timestamp;
+  if (++order.generation == 0)
+    order.generation = 1;
+
+  order.next = free_head_;
+  free_head_ = slot;
+}
+
+} // namespace lob
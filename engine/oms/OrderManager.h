@@ -0,0 +1,152 @@
+#pragma once
+
+#include "../order_book/Order.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace lob {
+
+enum class OrderKind : uint8_t {
+  LIMIT,  // Rests until filled or cancelled
+  MARKET, // Fills against the book, remainder cancelled
+  IOC     // Limit price, remainder cancelled
+};
+
+enum class OrderState : uint8_t {
+  NEW,              // Submitted, not yet acknowledged
+  ACKED,            // Live at the (simulated) venue
+  PARTIALLY_FILLED, // Live with some quantity filled
+  FILLED,           // Terminal
+  CANCELLED,        // Terminal (includes IOC/market remainders)
+  REJECTED          // Terminal
+};
+
+inline bool is_terminal(OrderState state) {
+  return state == OrderState::FILLED || state == OrderState::CANCELLED ||
+         state == OrderState::REJECTED;
+}
+
+const char *to_string(OrderKind kind);
+const char *to_string(OrderState state);
+
+// Handle to a pooled order: slot in the low 32 bits, slot generation in the
+// high 32 bits, so a handle to a recycled slot is detected as stale
+using OrderId = uint64_t;
+constexpr OrderId kInvalidOrderId = 0;
+
+enum class OmsResult : uint8_t {
+  OK,
+  UNKNOWN_ORDER,      // Stale or never-issued id
+  INVALID_TRANSITION, // Not allowed from the current state
+  INVALID_QUANTITY
+};
+
+struct OmsOrder {
+  uint64_t client_id;
+  int64_t price_ticks; // Ignored for MARKET
+  double quantity;     // Total (amend changes it)
+  double filled;
+  uint64_t created_ts;
+  uint64_t updated_ts;
+  uint32_t generation;
+  uint32_t prev; // Live list / free list links (slots)
+  uint32_t next;
+  Side side;
+  OrderKind kind;
+  OrderState state;
+
+  double leaves() const { return quantity - filled; }
+};
+
+// Order management with a fixed pool and an O(1) state machine. Orders are
+// addressed by dense slot (plus generation) so every operation is an array
+// index; terminal orders return their slot to a free list immediately.
+// Live orders are kept on an intrusive list for iteration and mass cancel.
+// Nothing is allocated after construction.
+class OrderManager {
+public:
+  static constexpr uint32_t kNullSlot = UINT32_MAX;
+
+  explicit OrderManager(size_t capacity = 1 << 16);
+
+  // kInvalidOrderId when the pool is exhausted or quantity <= 0
+  OrderId submit(OrderKind kind, Side side, int64_t price_ticks,
+                 double quantity, uint64_t client_id, uint64_t timestamp);
+
+  OmsResult acknowledge(OrderId id, uint64_t timestamp);
+  OmsResult reject(OrderId id, uint64_t timestamp);
+
+  // Execute quantity at price; FILLED once nothing is left
+  OmsResult fill(OrderId id, double quantity, double price,
+                 uint64_t timestamp);
+
+  // New total quantity (must exceed what has filled) and limit price
+  OmsResult amend(OrderId id, int64_t price_ticks, double quantity,
+                  uint64_t timestamp);
+
+  OmsResult cancel(OrderId id, uint64_t timestamp);
+  size_t cancel_all(uint64_t timestamp);
+
+  // nullptr for stale/unknown ids (including orders that have completed)
+  const OmsOrder *find(OrderId id) const {
+    uint32_t slot = static_cast<uint32_t>(id);
+    if (slot >= orders_.size())
+      return nullptr;
+    const OmsOrder &order = orders_[slot];
+    if (order.generation != static_cast<uint32_t>(id >> 32) ||
+        is_terminal(order.state))
+      return nullptr;
+    return &order;
+  }
+
+  template <typename Fn> void for_each_live(Fn &&fn) const {
+    for (uint32_t slot = live_head_; slot != kNullSlot;) {
+      const OmsOrder &order = orders_[slot];
+      uint32_t next = order.next;
+      fn(make_id(slot), order);
+      slot = next;
+    }
+  }
+
+  size_t live() const { return live_count_; }
+  size_t capacity() const { return orders_.size(); }
+
+  // Net fills
+  double position() const { return position_; }
+  double cash() const { return cash_; }
+
+  // Lifetime counters
+  uint64_t submitted() const { return submitted_; }
+  uint64_t fills() const { return fills_; }
+  uint64_t cancels() const { return cancels_; }
+  uint64_t rejects() const { return rejects_; }
+
+private:
+  std::vector<OmsOrder> orders_;
+  uint32_t free_head_;
+  uint32_t live_head_;
+  size_t live_count_;
+
+  double position_;
+  double cash_;
+  uint64_t submitted_;
+  uint64_t fills_;
+  uint64_t cancels_;
+  uint64_t rejects_;
+
+  OrderId make_id(uint32_t slot) const {
+    return (static_cast<uint64_t>(orders_[slot].generation) << 32) | slot;
+  }
+
+  // Live order for id, or nullptr
+  OmsOrder *lookup(OrderId id) {
+    return const_cast<OmsOrder *>(
+        static_cast<const OrderManager *>(this)->find(id));
+  }
+
+  // Move to a terminal state and recycle the slot
+  void retire(OmsOrder &order, OrderState state, uint64_t timestamp);
+};
+
+} // namespace lob
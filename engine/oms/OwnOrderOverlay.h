@@ -0,0 +1,260 @@
+#pragma once
+
+#include "../order_book/OrderBook.h"
+#include "OrderManager.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace lob {
+
+// Our resting volume at one price
+struct OwnLevel {
+  int64_t price_ticks;
+  double volume;
+  uint32_t order_count;
+};
+
+// One side of our resting orders, aggregated per price. A flat vector
+// sorted best first: we quote a handful of levels, so this beats a map.
+template <Side S> class OwnHalf {
+public:
+  using const_iterator = typename std::vector<OwnLevel>::const_iterator;
+
+  void add(int64_t ticks, double volume) {
+    auto it = locate(ticks);
+    if (it == levels_.end() || it->price_ticks != ticks)
+      it = levels_.insert(it, OwnLevel{ticks, 0.0, 0});
+    it->volume += volume;
+    it->order_count++;
+  }
+
+  // Take volume off a level; order_done when the order left the level
+  void reduce(int64_t ticks, double volume, bool order_done) {
+    auto it = locate(ticks);
+    if (it == levels_.end() || it->price_ticks != ticks)
+      return;
+    it->volume -= volume;
+    if (order_done && it->order_count > 0)
+      it->order_count--;
+    if (it->order_count == 0 || it->volume <= 1e-12)
+      levels_.erase(it);
+  }
+
+  double volume_at(int64_t ticks) const {
+    auto it = const_cast<OwnHalf *>(this)->locate(ticks);
+    return it != levels_.end() && it->price_ticks == ticks ? it->volume : 0.0;
+  }
+
+  void clear() { levels_.clear(); }
+  bool empty() const { return levels_.empty(); }
+  size_t size() const { return levels_.size(); }
+  const_iterator begin() const { return levels_.begin(); }
+  const_iterator end() const { return levels_.end(); }
+
+private:
+  std::vector<OwnLevel> levels_;
+
+  typename std::vector<OwnLevel>::iterator locate(int64_t ticks) {
+    return std::lower_bound(levels_.begin(), levels_.end(), ticks,
+                            [](const OwnLevel &level, int64_t t) {
+                              return HalfBook<S>::better(level.price_ticks, t);
+                            });
+  }
+};
+
+// Whether the feed's absolute L2 volume already counts our resting orders
+// (live trading) or not (simulated quotes never sent to the venue)
+enum class FeedOwnership { EXCLUDES_OWN, INCLUDES_OWN };
+
+// Our resting limit orders per (side, price), kept apart from the
+// feed-built OrderBook. Mirror OMS events into it as they happen.
+class OwnOrderOverlay {
+public:
+  void add(Side side, int64_t ticks, double volume) {
+    if (side == Side::BID)
+      bids_.add(ticks, volume);
+    else
+      asks_.add(ticks, volume);
+  }
+
+  void reduce(Side side, int64_t ticks, double volume, bool order_done) {
+    if (side == Side::BID)
+      bids_.reduce(ticks, volume, order_done);
+    else
+      asks_.reduce(ticks, volume, order_done);
+  }
+
+  // Rebuild from the OMS's live limit orders (e.g. after a reconnect)
+  void rebuild(const OrderManager &oms) {
+    clear();
+    oms.for_each_live([this](OrderId, const OmsOrder &order) {
+      if (order.kind == OrderKind::LIMIT)
+        add(order.side, order.price_ticks, order.leaves());
+    });
+  }
+
+  void clear() {
+    bids_.clear();
+    asks_.clear();
+  }
+
+  template <Side S> const OwnHalf<S> &half() const {
+    if constexpr (S == Side::BID)
+      return bids_;
+    else
+      return asks_;
+  }
+
+private:
+  OwnHalf<Side::BID> bids_;
+  OwnHalf<Side::ASK> asks_;
+};
+
+// Market book with our orders added (weight +1), removed (weight -1) or
+// ignored (weight 0). Nothing is copied: each query merges the two sorted
+// sides on the fly and stops after the requested depth.
+class OverlayView {
+public:
+  OverlayView(const OrderBook &market, const OwnOrderOverlay &own,
+              double own_weight)
+      : market_(&market), own_(&own), weight_(own_weight) {}
+
+  // Visit the best n merged levels of side S; returns how many
+  template <Side S, typename Fn>
+  size_t for_each_level(size_t n, Fn &&fn) const {
+    const HalfBook<S> &market = market_->template half<S>();
+    auto m = market.begin();
+    auto m_end = market.end();
+
+    const OwnHalf<S> &own = own_->template half<S>();
+    auto o = own.begin();
+    auto o_end = weight_ != 0.0 ? own.end() : own.begin();
+
+    size_t visited = 0;
+    while (visited < n && (m != m_end || o != o_end)) {
+      LevelInfo level;
+      bool from_market = o == o_end ||
+                         (m != m_end && !HalfBook<S>::better(o->price_ticks,
+                                                             m->first));
+      if (from_market && o != o_end && m->first == o->price_ticks) {
+        level.price = m->second.price;
+        level.volume = m->second.total_volume + weight_ * o->volume;
+        level.order_count = merged_count(m->second.order_count,
+                                         o->order_count);
+        ++m;
+        ++o;
+      } else if (from_market) {
+        level = LevelInfo{m->second.price, m->second.total_volume,
+                          m->second.order_count};
+        ++m;
+      } else {
+        level.price = market_->codec().ticks_to_price(o->price_ticks);
+        level.volume = weight_ * o->volume;
+        level.order_count = weight_ > 0.0 ? o->order_count : 0;
+        ++o;
+      }
+
+      // Fully our own volume (or inconsistent data) vanishes when removed
+      if (level.volume <= 1e-12)
+        continue;
+      fn(level);
+      visited++;
+    }
+    return visited;
+  }
+
+  size_t bid_depth(LevelInfo *out, size_t capacity) const {
+    size_t count = 0;
+    for_each_level<Side::BID>(
+        capacity, [&](const LevelInfo &level) { out[count++] = level; });
+    return count;
+  }
+  size_t ask_depth(LevelInfo *out, size_t capacity) const {
+    size_t count = 0;
+    for_each_level<Side::ASK>(
+        capacity, [&](const LevelInfo &level) { out[count++] = level; });
+    return count;
+  }
+
+  template <size_t N> size_t bid_depth(DepthArray<N> &out) const {
+    out.count = bid_depth(out.levels.data(), N);
+    return out.count;
+  }
+  template <size_t N> size_t ask_depth(DepthArray<N> &out) const {
+    out.count = ask_depth(out.levels.data(), N);
+    return out.count;
+  }
+
+  double total_bid_volume(size_t depth) const {
+    double total = 0.0;
+    for_each_level<Side::BID>(
+        depth, [&](const LevelInfo &level) { total += level.volume; });
+    return total;
+  }
+  double total_ask_volume(size_t depth) const {
+    double total = 0.0;
+    for_each_level<Side::ASK>(
+        depth, [&](const LevelInfo &level) { total += level.volume; });
+    return total;
+  }
+
+  // Same definition as OrderBook::calculate_imbalance
+  double imbalance(size_t depth = 5) const {
+    double bid_volume = total_bid_volume(depth);
+    double ask_volume = total_ask_volume(depth);
+    double total_volume = bid_volume + ask_volume;
+    if (total_volume < 1e-8)
+      return 0.0;
+    return (bid_volume - ask_volume) / total_volume;
+  }
+
+  TopOfBook top() const {
+    if (weight_ == 0.0)
+      return market_->get_top_of_book();
+
+    TopOfBook top;
+    for_each_level<Side::BID>(1, [&](const LevelInfo &level) {
+      top.has_bid = true;
+      top.bid_price = level.price;
+      top.bid_size = level.volume;
+    });
+    for_each_level<Side::ASK>(1, [&](const LevelInfo &level) {
+      top.has_ask = true;
+      top.ask_price = level.price;
+      top.ask_size = level.volume;
+    });
+    top.update_derived();
+    return top;
+  }
+
+private:
+  const OrderBook *market_;
+  const OwnOrderOverlay *own_;
+  double weight_;
+
+  uint32_t merged_count(uint32_t market, uint32_t own) const {
+    if (weight_ > 0.0)
+      return market + own;
+    return market > own ? market - own : 0;
+  }
+};
+
+// The book as everyone else sees it and as it stands including us
+struct BookViews {
+  OverlayView with_own;
+  OverlayView without_own;
+};
+
+inline BookViews book_views(const OrderBook &market,
+                            const OwnOrderOverlay &own,
+                            FeedOwnership ownership) {
+  if (ownership == FeedOwnership::INCLUDES_OWN)
+    return BookViews{OverlayView(market, own, 0.0),
+                     OverlayView(market, own, -1.0)};
+  return BookViews{OverlayView(market, own, 1.0),
+                   OverlayView(market, own, 0.0)};
+}
+
+} // namespace lob
@@ -0,0 +1,106 @@
+#include "RiskGate.h"
+#include <algorithm>
+#include <cmath>
+
+namespace lob {
+
+const char *to_string(RiskCheck check) {
+  switch (check) {
+  case RiskCheck::PASSED:
+    return "PASSED";
+  case RiskCheck::KILL_SWITCH:
+    return "KILL_SWITCH";
+  case RiskCheck::ORDER_SIZE:
+    return "ORDER_SIZE";
+  case RiskCheck::POSITION:
+    return "POSITION";
+  case RiskCheck::NOTIONAL:
+    return "NOTIONAL";
+  case RiskCheck::RATE:
+    return "RATE";
+  case RiskCheck::PRICE_BAND:
+    return "PRICE_BAND";
+  default:
+    return "NO_MARKET";
+  }
+}
+
+RiskGate::RiskGate(const RiskLimits &limits)
+    : limits_(limits),
+      tokens_per_ms_(limits.max_orders_per_sec > 0.0
+                         ? limits.max_orders_per_sec / 1000.0
+                         : 0.0),
+      band_fraction_(limits.price_band_bps > 0.0
+                         ? limits.price_band_bps / 10000.0
+                         : 0.0),
+      kill_switch_(false), tokens_(limits.burst), last_refill_ms_(0),
+      position_(0.0), open_buy_(0.0), open_sell_(0.0), checked_(0),
+      passed_(0) {
+  rejections_.fill(0);
+}
+
+RiskCheck RiskGate::check(Side side, OrderKind kind, double price,
+                          double quantity, const TopOfBook &top,
+                          uint64_t timestamp_ms) {
+  checked_++;
+
+  if (kill_switch())
+    return reject(RiskCheck::KILL_SWITCH);
+  if (!(quantity > 0.0) || quantity > limits_.max_order_qty)
+    return reject(RiskCheck::ORDER_SIZE);
+  if (!top.valid())
+    return reject(RiskCheck::NO_MARKET);
+
+  // Worst case: everything open on this side fills, plus this order
+  double worst = side == Side::BID ? position_ + open_buy_ + quantity
+                                   : position_ - open_sell_ - quantity;
+  if (std::abs(worst) > limits_.max_position)
+    return reject(RiskCheck::POSITION);
+
+  double reference = kind == OrderKind::MARKET ? top.mid : price;
+  if (std::abs(worst) * reference > limits_.max_notional)
+    return reject(RiskCheck::NOTIONAL);
+
+  if (band_fraction_ > 0.0 && kind != OrderKind::MARKET &&
+      std::abs(price - top.mid) > band_fraction_ * top.mid)
+    return reject(RiskCheck::PRICE_BAND);
+
+  // Token bucket, refilled lazily from the order's own timestamp
+  if (tokens_per_ms_ > 0.0) {
+    if (timestamp_ms > last_refill_ms_) {
+      tokens_ = std::min(limits_.burst,
+                         tokens_ + (timestamp_ms - last_refill_ms_) *
+                                       tokens_per_ms_);
+      last_refill_ms_ = timestamp_ms;
+    }
+    if (tokens_ < 1.0)
+      return reject(RiskCheck::RATE);
+    tokens_ -= 1.0;
+  }
+
+  if (side == Side::BID)
+    open_buy_ += quantity;
+  else
+    open_sell_ += quantity;
+  passed_++;
+  return RiskCheck::PASSED;
+}
+
+void RiskGate::on_fill(Side side, double quantity) {
+  if (side == Side::BID) {
+    open_buy_ = std::max(0.0, open_buy_ - quantity);
+    position_ += quantity;
+  } else {
+    open_sell_ = std::max(0.0, open_sell_ - quantity);
+    position_ -= quantity;
+  }
+}
+
+void RiskGate::on_release(Side side, double quantity) {
+  if (side == Side::BID)
+    open_buy_ = std::max(0.0, open_buy_ - quantity);
+  else
+    open_sell_ = std::max(0.0, open_sell_ - quantity);
+}
+
+} // namespace lob
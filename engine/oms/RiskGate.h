@@ -0,0 +1,101 @@
+#pragma once
+
+#include "../order_book/LevelView.h"
+#include "OrderManager.h"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace lob {
+
+// Outcome of a pre-trade check; every value but PASSED is a rejection
+enum class RiskCheck : uint8_t {
+  PASSED,
+  KILL_SWITCH, // Trading halted
+  ORDER_SIZE,  // Single order too large
+  POSITION,    // Worst-case position after the order exceeds the limit
+  NOTIONAL,    // Worst-case exposure at the reference price exceeds the limit
+  RATE,        // Order-rate throttle empty
+  PRICE_BAND,  // Limit price too far from mid
+  NO_MARKET    // No two-sided book to price against
+};
+
+constexpr size_t kRiskCheckCount = 8;
+
+const char *to_string(RiskCheck check);
+
+// Limits are "off" at their defaults
+struct RiskLimits {
+  double max_order_qty = std::numeric_limits<double>::infinity();
+  double max_position = std::numeric_limits<double>::infinity();
+  double max_notional = std::numeric_limits<double>::infinity();
+  double max_orders_per_sec = 0.0; // Token refill rate (0 = unthrottled)
+  double burst = 10.0;             // Token bucket depth
+  double price_band_bps = 0.0;     // Max |price - mid| / mid (0 = off)
+};
+
+// Pre-trade risk stage between signal and order submission. Every check
+// is a handful of compares against limits precomputed at construction,
+// the cached top of book and counters kept up to date incrementally, so
+// the cost per order is constant no matter how many orders are live.
+//
+// The gate tracks the worst case: filled position plus all open quantity
+// on the order's side. Callers report fills and released quantity
+// (cancel, reject, IOC remainder) so the open totals stay current.
+class RiskGate {
+public:
+  explicit RiskGate(const RiskLimits &limits = RiskLimits());
+
+  // price is ignored for MARKET orders (they are valued at mid).
+  // PASSED reserves the quantity as open and takes a rate token.
+  RiskCheck check(Side side, OrderKind kind, double price, double quantity,
+                  const TopOfBook &top, uint64_t timestamp_ms);
+
+  void on_fill(Side side, double quantity);
+  void on_release(Side side, double quantity);
+
+  // May be flipped from any thread; checked first on every order
+  void set_kill_switch(bool engaged) {
+    kill_switch_.store(engaged, std::memory_order_relaxed);
+  }
+  bool kill_switch() const {
+    return kill_switch_.load(std::memory_order_relaxed);
+  }
+
+  const RiskLimits &limits() const { return limits_; }
+  double position() const { return position_; }
+  double open_buy() const { return open_buy_; }
+  double open_sell() const { return open_sell_; }
+
+  uint64_t checked() const { return checked_; }
+  uint64_t rejected() const { return checked_ - passed_; }
+  uint64_t rejections(RiskCheck check) const {
+    return rejections_[static_cast<size_t>(check)];
+  }
+
+private:
+  RiskLimits limits_;
+  double tokens_per_ms_; // 0 = unthrottled
+  double band_fraction_; // 0 = off
+
+  std::atomic<bool> kill_switch_;
+  double tokens_;
+  uint64_t last_refill_ms_;
+
+  double position_;
+  double open_buy_;
+  double open_sell_;
+
+  uint64_t checked_;
+  uint64_t passed_;
+  std::array<uint64_t, kRiskCheckCount> rejections_;
+
+  RiskCheck reject(RiskCheck check) {
+    rejections_[static_cast<size_t>(check)]++;
+    return check;
+  }
+};
+
+} // namespace lob
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <vector>
+
+namespace lob {
+
+// Flat copy of an OrderBook (OrderBook::save_state / restore_state):
+// levels best first per side, and every level's queue, front first, in
+// one shared array (bid levels' queues, then ask levels'). Restoring it
+// reproduces the book exactly, queue positions and id counter included,
+// so replay can resume from it.
+struct BookState {
+  struct Level {
+    int64_t ticks;
+    double price;
+    double volume;
+    uint32_t orders; // Queue entries belonging to this level
+  };
+
+  struct QueuedOrder {
+    uint64_t order_id;
+    double quantity;
+    uint64_t timestamp;
+  };
+
+  std::vector<Level> bids;
+  std::vector<Level> asks;
+  std::vector<QueuedOrder> queue;
+  uint64_t next_order_id = 1; // Synthetic id counter
+  bool l3 = false;            // Queues are true L3 orders
+
+  void clear() {
+    bids.clear();
+    asks.clear();
+    queue.clear();
+    next_order_id = 1;
+    l3 = false;
+  }
+
+  // Serialized size
+  size_t bytes() const {
+    return sizeof(uint64_t) * 5 + (bids.size() + asks.size()) * sizeof(Level) +
+           queue.size() * sizeof(QueuedOrder);
+  }
+
+  // Native-layout binary (same build reads it back; not an interchange
+  // format)
+  void write(std::ostream &out) const {
+    uint64_t header[5] = {bids.size(), asks.size(), queue.size(),
+                          next_order_id, l3 ? 1u : 0u};
+    out.write(reinterpret_cast<const char *>(header), sizeof(header));
+    write_array(out, bids);
+    write_array(out, asks);
+    write_array(out, queue);
+  }
+
+  bool read(std::istream &in) {
+    uint64_t header[5];
+    if (!in.read(reinterpret_cast<char *>(header), sizeof(header)))
+      return false;
+    bids.resize(header[0]);
+    asks.resize(header[1]);
+    queue.resize(header[2]);
+    next_order_id = header[3];
+    l3 = header[4] != 0;
+    return read_array(in, bids) && read_array(in, asks) &&
+           read_array(in, queue);
+  }
+
+private:
+  template <typename T>
+  static void write_array(std::ostream &out, const std::vector<T> &items) {
+    out.write(reinterpret_cast<const char *>(items.data()),
+              static_cast<std::streamsize>(items.size() * sizeof(T)));
+  }
+  template <typename T>
+  static bool read_array(std::istream &in, std::vector<T> &items) {
+    return static_cast<bool>(
+        in.read(reinterpret_cast<char *>(items.data()),
+                static_cast<std::streamsize>(items.size() * sizeof(T))));
+  }
+};
+
+} // namespace lob
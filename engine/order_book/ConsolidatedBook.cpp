@@ -0,0 +1,39 @@
+#include "ConsolidatedBook.h"
+
+namespace lob {
+
+ConsolidatedBook::ConsolidatedBook(const std::string &symbol,
+                                   const InstrumentSpec &spec)
+    : symbol_(symbol), spec_(spec) {}
+
+size_t ConsolidatedBook::add_venue(const std::string &name) {
+  if (venues_.size() >= kMaxVenues)
+    return kNoVenue;
+  venues_.push_back(Venue{name, std::make_unique<OrderBook>(symbol_, spec_)});
+  return venues_.size() - 1;
+}
+
+double ConsolidatedBook::calculate_imbalance(size_t depth) const {
+  double bid_volume = bids_.total_volume(depth);
+  double ask_volume = asks_.total_volume(depth);
+  double total_volume = bid_volume + ask_volume;
+  if (total_volume < 1e-8)
+    return 0.0;
+  return (bid_volume - ask_volume) / total_volume;
+}
+
+void ConsolidatedBook::rebuild() {
+  bids_.clear();
+  asks_.clear();
+  for (size_t v = 0; v < venues_.size(); ++v) {
+    const OrderBook &book = *venues_[v].book;
+    for (const auto &[ticks, limit] : book.half<Side::BID>())
+      bids_.set(v, ticks, limit.price, limit.total_volume);
+    for (const auto &[ticks, limit] : book.half<Side::ASK>())
+      asks_.set(v, ticks, limit.price, limit.total_volume);
+  }
+  bids_.refresh_touch(top_);
+  asks_.refresh_touch(top_);
+}
+
+} // namespace lob
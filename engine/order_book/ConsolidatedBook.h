@@ -0,0 +1,318 @@
+#pragma once
+
+#include "../io/EventApply.h"
+#include "OrderBook.h"
+#include <array>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace lob {
+
+constexpr size_t kMaxVenues = 8;
+constexpr size_t kNoVenue = static_cast<size_t>(-1);
+
+// One price of the consolidated book: summed volume plus each venue's
+// share (venue_mask bit v is set while venue v quotes here)
+struct ConsolidatedLevel {
+  double price = 0.0;
+  double volume = 0.0;
+  uint32_t venue_mask = 0;
+  std::array<double, kMaxVenues> venue_volume{};
+
+  uint32_t venue_count() const {
+    return static_cast<uint32_t>(__builtin_popcount(venue_mask));
+  }
+};
+
+// One side of the consolidated book, keyed by ticks on the shared grid.
+// Levels hold absolute per-venue volumes, so re-syncing a level from its
+// venue is idempotent and the total never drifts.
+template <Side S> class ConsolidatedHalf {
+public:
+  using Traits = SideTraits<S>;
+  using Compare = typename Traits::Compare;
+  using Map = std::map<int64_t, ConsolidatedLevel, Compare>;
+  using const_iterator = typename Map::const_iterator;
+
+  static bool better(int64_t a, int64_t b) { return Compare()(a, b); }
+
+  // Set venue's volume at a price (0 removes its share)
+  void set(size_t venue, int64_t ticks, double price, double volume) {
+    auto it = levels_.find(ticks);
+    if (it == levels_.end()) {
+      if (volume <= 0.0)
+        return;
+      it = levels_.try_emplace(ticks).first;
+      it->second.price = price;
+    }
+    update(it, venue, volume);
+  }
+
+  // Drop venue's share of every level strictly better than ticks, or of
+  // every level when limited is false. Used when a venue loses levels at
+  // its touch that the triggering event did not name (crossed repair).
+  size_t clear_venue_better_than(size_t venue, bool limited, int64_t ticks) {
+    const uint32_t bit = 1u << venue;
+    size_t cleared = 0;
+    auto it = levels_.begin();
+    while (it != levels_.end() && (!limited || better(it->first, ticks))) {
+      if (!(it->second.venue_mask & bit)) {
+        ++it;
+        continue;
+      }
+      cleared++;
+      it = update(it, venue, 0.0);
+    }
+    return cleared;
+  }
+
+  bool empty() const { return levels_.empty(); }
+  size_t size() const { return levels_.size(); }
+  const_iterator begin() const { return levels_.begin(); }
+  const_iterator end() const { return levels_.end(); }
+
+  const ConsolidatedLevel *find(int64_t ticks) const {
+    auto it = levels_.find(ticks);
+    return it != levels_.end() ? &it->second : nullptr;
+  }
+
+  // Best level; only valid when !empty()
+  const ConsolidatedLevel &best() const { return levels_.begin()->second; }
+
+  // Best first; order_count is the number of venues at the price
+  size_t depth(LevelInfo *out, size_t capacity) const {
+    size_t count = 0;
+    for (auto it = levels_.begin(); it != levels_.end() && count < capacity;
+         ++it) {
+      out[count++] = LevelInfo{it->second.price, it->second.volume,
+                               it->second.venue_count()};
+    }
+    return count;
+  }
+
+  double total_volume(size_t depth) const {
+    double total = 0.0;
+    for (auto it = levels_.begin(); it != levels_.end() && depth > 0;
+         ++it, --depth)
+      total += it->second.volume;
+    return total;
+  }
+
+  void refresh_touch(TopOfBook &top) const {
+    if (levels_.empty()) {
+      Traits::set_touch(top, false, 0.0, 0.0);
+    } else {
+      const ConsolidatedLevel &level = best();
+      Traits::set_touch(top, true, level.price, level.volume);
+    }
+    top.update_derived();
+  }
+
+  void clear() { levels_.clear(); }
+
+private:
+  Map levels_;
+
+  typename Map::iterator update(typename Map::iterator it, size_t venue,
+                                double volume) {
+    ConsolidatedLevel &level = it->second;
+    const uint32_t bit = 1u << venue;
+    level.venue_volume[venue] = volume;
+    if (volume > 0.0)
+      level.venue_mask |= bit;
+    else
+      level.venue_mask &= ~bit;
+    if (level.venue_mask == 0)
+      return levels_.erase(it);
+
+    // Re-sum the (few) quoting venues rather than accumulate deltas
+    double total = 0.0;
+    for (uint32_t mask = level.venue_mask; mask; mask &= mask - 1)
+      total += level.venue_volume[__builtin_ctz(mask)];
+    level.volume = total;
+    return std::next(it);
+  }
+};
+
+// Consolidated view of one instrument quoted on several venues. Each venue
+// keeps its own OrderBook (hybrid L2/L3, crossed-book repair and all);
+// after an event is applied to its venue, only the prices that event could
+// have changed are re-synced into the aggregate. A consolidated update is
+// the venue update plus one level lookup in the venue book and one in the
+// aggregate (never a rebuild), and the consolidated touch is current after
+// every event. All venues must share the instrument's tick grid.
+class ConsolidatedBook {
+public:
+  ConsolidatedBook(const std::string &symbol, const InstrumentSpec &spec);
+
+  // Index of the new venue, or kNoVenue once kMaxVenues are registered
+  size_t add_venue(const std::string &name);
+
+  // Apply one venue event and fold its effect into the aggregate
+  template <typename Policy = FifoPolicy>
+  void apply(size_t venue, const Event &event);
+
+  size_t venue_count() const { return venues_.size(); }
+  const std::string &venue_name(size_t venue) const {
+    return venues_[venue].name;
+  }
+  const OrderBook &venue(size_t venue) const { return *venues_[venue].book; }
+
+  template <Side S> const ConsolidatedHalf<S> &half() const;
+
+  // Consolidated touch: best price across venues, size summed over the
+  // venues quoting it
+  TopOfBook get_top_of_book() const { return top_; }
+
+  // Venues at the consolidated best bid/ask (bit per venue)
+  uint32_t best_bid_venues() const {
+    return bids_.empty() ? 0 : bids_.best().venue_mask;
+  }
+  uint32_t best_ask_venues() const {
+    return asks_.empty() ? 0 : asks_.best().venue_mask;
+  }
+
+  // Best bid on one venue strictly above the best ask on another: venue
+  // books repair strict crosses, so this is always a cross-venue
+  // opportunity
+  bool crossed() const {
+    return top_.valid() && top_.bid_price > top_.ask_price;
+  }
+
+  // Best bid equal to best ask (zero spread). Venues only repair strict
+  // crosses, so one venue can be locked on its own; reported apart from
+  // crossed()
+  bool locked() const {
+    return top_.valid() && top_.bid_price == top_.ask_price;
+  }
+
+  size_t get_bid_depth(LevelInfo *out, size_t capacity) const {
+    return bids_.depth(out, capacity);
+  }
+  size_t get_ask_depth(LevelInfo *out, size_t capacity) const {
+    return asks_.depth(out, capacity);
+  }
+  template <size_t N> size_t get_bid_depth(DepthArray<N> &out) const {
+    out.count = bids_.depth(out.levels.data(), N);
+    return out.count;
+  }
+  template <size_t N> size_t get_ask_depth(DepthArray<N> &out) const {
+    out.count = asks_.depth(out.levels.data(), N);
+    return out.count;
+  }
+
+  double calculate_imbalance(size_t depth = 5) const;
+
+  // Rebuild the aggregate from the venue books (after direct edits to a
+  // venue, or to verify the incremental path)
+  void rebuild();
+
+  const std::string &get_symbol() const { return symbol_; }
+
+private:
+  struct Venue {
+    std::string name;
+    std::unique_ptr<OrderBook> book;
+  };
+
+  std::string symbol_;
+  InstrumentSpec spec_;
+  std::vector<Venue> venues_;
+  ConsolidatedHalf<Side::BID> bids_;
+  ConsolidatedHalf<Side::ASK> asks_;
+  TopOfBook top_;
+
+  template <Side S> ConsolidatedHalf<S> &half_mut();
+
+  // Copy venue's current volume at one price into the aggregate
+  template <Side S> void sync_level(size_t venue, int64_t ticks);
+
+  // Drop the aggregate's stale copies of levels the venue lost above its
+  // new touch; had/old_best describe the venue's touch before the event
+  template <Side S> void sync_touch(size_t venue, bool had, int64_t old_best);
+};
+
+template <> inline const ConsolidatedHalf<Side::BID> &
+ConsolidatedBook::half<Side::BID>() const {
+  return bids_;
+}
+template <> inline const ConsolidatedHalf<Side::ASK> &
+ConsolidatedBook::half<Side::ASK>() const {
+  return asks_;
+}
+template <> inline ConsolidatedHalf<Side::BID> &
+ConsolidatedBook::half_mut<Side::BID>() {
+  return bids_;
+}
+template <> inline ConsolidatedHalf<Side::ASK> &
+ConsolidatedBook::half_mut<Side::ASK>() {
+  return asks_;
+}
+
+template <Side S>
+void ConsolidatedBook::sync_level(size_t venue, int64_t ticks) {
+  const OrderBook &book = *venues_[venue].book;
+  const Limit *limit = book.half<S>().find(ticks);
+  half_mut<S>().set(venue, ticks, limit ? limit->price : 0.0,
+                    limit ? limit->total_volume : 0.0);
+}
+
+template <Side S>
+void ConsolidatedBook::sync_touch(size_t venue, bool had, int64_t old_best) {
+  if (!had)
+    return;
+  const HalfBook<S> &side = venues_[venue].book->half<S>();
+  if (side.empty()) {
+    half_mut<S>().clear_venue_better_than(venue, false, 0);
+  } else if (HalfBook<S>::better(old_best, side.best_ticks())) {
+    half_mut<S>().clear_venue_better_than(venue, true, side.best_ticks());
+  }
+}
+
+template <typename Policy>
+void ConsolidatedBook::apply(size_t venue, const Event &event) {
+  OrderBook &book = *venues_[venue].book;
+
+  // Venue state the event can change besides its own price: the touch of
+  // either side (crossed-book repair) and, for L3 modify/cancel, the
+  // level the order rests at now
+  const bool had_bid = !book.half<Side::BID>().empty();
+  const bool had_ask = !book.half<Side::ASK>().empty();
+  const int64_t old_bid = had_bid ? book.half<Side::BID>().best_ticks() : 0;
+  const int64_t old_ask = had_ask ? book.half<Side::ASK>().best_ticks() : 0;
+  bool resting = false;
+  Side resting_side = Side::BID;
+  int64_t resting_ticks = 0;
+  if (event.event_type == EventType::MODIFY ||
+      event.event_type == EventType::CANCEL) {
+    if (const L3Order *order = book.find_l3_order(event.order_id)) {
+      resting = true;
+      resting_side = order->side;
+      resting_ticks = order->price_ticks;
+    }
+  }
+
+  apply_event<Policy>(book, event);
+
+  // A modified order stays on its side whatever the message says
+  Side side = resting ? resting_side : event.side;
+  if (side == Side::BID)
+    sync_level<Side::BID>(venue, event.price_ticks);
+  else
+    sync_level<Side::ASK>(venue, event.price_ticks);
+  if (resting) {
+    if (resting_side == Side::BID)
+      sync_level<Side::BID>(venue, resting_ticks);
+    else
+      sync_level<Side::ASK>(venue, resting_ticks);
+  }
+  sync_touch<Side::BID>(venue, had_bid, old_bid);
+  sync_touch<Side::ASK>(venue, had_ask, old_ask);
+
+  bids_.refresh_touch(top_);
+  asks_.refresh_touch(top_);
+}
+
+} // namespace lob
@@ -0,0 +1,172 @@
+#pragma once
+
+#include "../metrics/Probes.h"
+#include "LevelView.h"
+#include "Order.h"
+#include "QueuePolicy.h"
+#include <functional>
+#include <map>
+
+namespace lob {
+
+// Compile-time side properties: price ordering (best level first) and
+// which TopOfBook fields the side owns.
+template <Side S> struct SideTraits;
+
+template <> struct SideTraits<Side::BID> {
+  using Compare = std::greater<int64_t>; // highest price first
+
+  static void set_touch(TopOfBook &top, bool present, double price,
+                        double size) {
+    top.has_bid = present;
+    top.bid_price = price;
+    top.bid_size = size;
+  }
+};
+
+template <> struct SideTraits<Side::ASK> {
+  using Compare = std::less<int64_t>; // lowest price first
+
+  static void set_touch(TopOfBook &top, bool present, double price,
+                        double size) {
+    top.has_ask = present;
+    top.ask_price = price;
+    top.ask_size = size;
+  }
+};
+
+// One side of the book, keyed by integer price ticks. Every operation is
+// specialized on the side at compile time, so there are no per-operation
+// side branches. Limit::price keeps the decimal price for reporting.
+template <Side S> class HalfBook {
+public:
+  using Traits = SideTraits<S>;
+  using Compare = typename Traits::Compare;
+  using Map = std::map<int64_t, Limit, Compare>;
+  using const_iterator = typename Map::const_iterator;
+
+  static constexpr Side side = S;
+
+  // Apply absolute L2 volume at a price (hybrid L2/L3 delta semantics):
+  // increases append a synthetic order, decreases are allocated across the
+  // queue by Policy (FIFO by default, see QueuePolicy.h).
+  template <typename Policy = FifoPolicy>
+  void apply(int64_t ticks, double price, double quantity, uint64_t timestamp,
+             uint64_t &next_order_id) {
+    auto [it, inserted] = levels_.try_emplace(ticks, price);
+    Limit &limit = it->second;
+
+    if (inserted) {
+      // New level: create with single synthetic order
+      LOB_PROBE2(level_created, S, ticks);
+      limit.add_synthetic_order(next_order_id++, quantity, S, timestamp);
+    } else {
+      double delta = quantity - limit.total_volume;
+
+      if (delta > 1e-8) {
+        // Volume increase: add synthetic order
+        limit.add_synthetic_order(next_order_id++, delta, S, timestamp);
+      } else if (delta < -1e-8) {
+        // Volume decrease: allocate across the queue per the policy
+        DecreaseContext context{it == levels_.begin(), timestamp};
+        Policy::reduce(limit, -delta, context);
+      }
+      // else: delta ~= 0, no change
+    }
+
+    limit.validate_invariants();
+  }
+
+  // Find or create an empty level (true L3 mode links orders into it)
+  Limit &level(int64_t ticks, double price) {
+    auto [it, inserted] = levels_.try_emplace(ticks, price);
+    if (inserted)
+      LOB_PROBE2(level_created, S, ticks);
+    return it->second;
+  }
+
+  void erase(int64_t ticks) {
+    if (levels_.erase(ticks))
+      LOB_PROBE2(level_erased, S, ticks);
+  }
+  void clear() { levels_.clear(); }
+
+  bool empty() const { return levels_.empty(); }
+  size_t size() const { return levels_.size(); }
+
+  // True if price a is strictly better than price b on this side
+  static bool better(int64_t a, int64_t b) { return Compare()(a, b); }
+
+  const Limit *find(int64_t ticks) const {
+    auto it = levels_.find(ticks);
+    return it != levels_.end() ? &it->second : nullptr;
+  }
+  Limit *find(int64_t ticks) {
+    auto it = levels_.find(ticks);
+    return it != levels_.end() ? &it->second : nullptr;
+  }
+
+  double volume_at(int64_t ticks) const {
+    const Limit *limit = find(ticks);
+    return limit ? limit->total_volume : 0.0;
+  }
+
+  // Raw level iteration, best first (key = tick price)
+  const_iterator begin() const { return levels_.begin(); }
+  const_iterator end() const { return levels_.end(); }
+
+  LevelRange<const_iterator> levels(size_t n = kAllLevels) const {
+    return LevelRange<const_iterator>(levels_.begin(), levels_.end(), n);
+  }
+
+  size_t depth(LevelInfo *out, size_t capacity) const {
+    size_t count = 0;
+    for (const LevelInfo &level : levels(capacity)) {
+      out[count++] = level;
+    }
+    return count;
+  }
+
+  double total_volume(size_t depth) const {
+    double total = 0.0;
+    for (const LevelInfo &level : levels(depth)) {
+      total += level.volume;
+    }
+    return total;
+  }
+
+  // Best level's tick price; only valid when !empty()
+  int64_t best_ticks() const { return levels_.begin()->first; }
+
+  // Remove every level strictly better than ticks (crossed-book repair).
+  // on_erase(limit) is called for each level before it is removed.
+  template <typename OnErase>
+  size_t erase_better_than(int64_t ticks, OnErase &&on_erase) {
+    size_t removed = 0;
+    auto it = levels_.begin();
+    while (it != levels_.end() && better(it->first, ticks)) {
+      on_erase(it->second);
+      LOB_PROBE2(level_erased, S, it->first);
+      it = levels_.erase(it);
+      removed++;
+    }
+    return removed;
+  }
+
+  // Write this side's touch into the shared snapshot
+  void refresh_touch(TopOfBook &top) const {
+    if (levels_.empty()) {
+      Traits::set_touch(top, false, 0.0, 0.0);
+    } else {
+      const auto &best = *levels_.begin();
+      Traits::set_touch(top, true, best.second.price,
+                        best.second.total_volume);
+    }
+    top.update_derived();
+  }
+
+private:
+  Map levels_;
+};
+
+} // namespace lob
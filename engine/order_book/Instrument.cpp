@@ -0,0 +1,110 @@
+#include "Instrument.h"
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <unordered_map>
+
+namespace lob {
+
+namespace {
+
+std::unordered_map<std::string, InstrumentSpec> &registry() {
+  static std::unordered_map<std::string, InstrumentSpec> specs = {
+      {"BTCUSDT", instruments::BTCUSDT},
+  };
+  return specs;
+}
+
+// A tick/lot must be a positive whole number of 10^-decimals units, or
+// tick_units()/lot_units() round to the wrong grid (or to 0)
+bool on_decimal_grid(double step, int decimals) {
+  if (!(step > 0.0) || decimals < 0 || decimals > 18)
+    return false;
+  double scaled = step * static_cast<double>(InstrumentSpec::pow10(decimals));
+  double units = std::round(scaled);
+  return units >= 1.0 && std::abs(scaled - units) <= 1e-6 * units;
+}
+
+// Empty if the spec is usable, else what is wrong with it
+std::string validate(const InstrumentSpec &spec) {
+  if (!on_decimal_grid(spec.tick_size, spec.price_decimals))
+    return "tick_size must be > 0 and a multiple of 10^-price_decimals";
+  if (!on_decimal_grid(spec.lot_size, spec.qty_decimals))
+    return "lot_size must be > 0 and a multiple of 10^-qty_decimals";
+  if (!(spec.min_price < spec.max_price))
+    return "min_price must be below max_price";
+  return {};
+}
+
+} // namespace
+
+const InstrumentSpec &instrument_for(const std::string &symbol) {
+  auto it = registry().find(symbol);
+  if (it != registry().end()) {
+    return it->second;
+  }
+  return instruments::GENERIC;
+}
+
+void register_instrument(const std::string &symbol,
+                         const InstrumentSpec &spec) {
+  registry()[symbol] = spec;
+}
+
+size_t load_instrument_specs(const std::string &filepath) {
+  std::ifstream file(filepath);
+  if (!file.is_open()) {
+    std::cerr << "[ERROR] Failed to open instrument file: " << filepath
+              << std::endl;
+    return 0;
+  }
+
+  size_t loaded = 0;
+  size_t line_number = 0;
+  std::string line;
+  while (std::getline(file, line)) {
+    line_number++;
+    if (line.empty() || line[0] == '#')
+      continue;
+
+    std::istringstream ss(line);
+    std::string symbol, token;
+    InstrumentSpec spec = instruments::GENERIC;
+
+    try {
+      std::getline(ss, symbol, '|');
+      std::getline(ss, token, '|');
+      spec.tick_size = std::stod(token);
+      std::getline(ss, token, '|');
+      spec.lot_size = std::stod(token);
+      std::getline(ss, token, '|');
+      spec.price_decimals = std::stoi(token);
+      std::getline(ss, token, '|');
+      spec.qty_decimals = std::stoi(token);
+      if (std::getline(ss, token, '|'))
+        spec.min_price = std::stod(token);
+      if (std::getline(ss, token, '|'))
+        spec.max_price = std::stod(token);
+    } catch (const std::exception &) {
+      std::cerr << "[ERROR] Invalid instrument spec at " << filepath << ":"
+                << line_number << ": " << line << std::endl;
+      continue;
+    }
+
+    std::string problem = validate(spec);
+    if (!problem.empty()) {
+      std::cerr << "[ERROR] Invalid instrument spec at " << filepath << ":"
+                << line_number << " (" << problem << "): " << line
+                << std::endl;
+      continue;
+    }
+
+    register_instrument(symbol, spec);
+    loaded++;
+  }
+
+  return loaded;
+}
+
+} // namespace lob
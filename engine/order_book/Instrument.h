@@ -0,0 +1,202 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <string>
+
+namespace lob {
+
+// Static description of a tradable instrument's price/quantity grid.
+// Literal type: hot symbols are declared constexpr below and passed as
+// template arguments so tick arithmetic constant-folds; everything else is
+// registered or loaded at runtime.
+struct InstrumentSpec {
+  double tick_size;   // Minimum price increment
+  double lot_size;    // Minimum quantity increment
+  int price_decimals; // Decimal places needed to express any tick
+  int qty_decimals;   // Decimal places needed to express any lot
+  double min_price;   // Typical trading range (presizing, sanity checks)
+  double max_price;
+
+  static constexpr int64_t pow10(int n) {
+    return n <= 0 ? 1 : 10 * pow10(n - 1);
+  }
+
+  // Integer scale of the decimal grid (10^decimals)
+  constexpr int64_t price_scale() const { return pow10(price_decimals); }
+  constexpr int64_t qty_scale() const { return pow10(qty_decimals); }
+
+  // Size of one tick/lot in decimal grid units (1 when tick == 10^-decimals)
+  constexpr int64_t tick_units() const {
+    return static_cast<int64_t>(tick_size * price_scale() + 0.5);
+  }
+  constexpr int64_t lot_units() const {
+    return static_cast<int64_t>(lot_size * qty_scale() + 0.5);
+  }
+
+  constexpr bool in_typical_range(double price) const {
+    return price >= min_price && price <= max_price;
+  }
+
+  constexpr bool operator==(const InstrumentSpec &other) const {
+    return tick_size == other.tick_size && lot_size == other.lot_size &&
+           price_decimals == other.price_decimals &&
+           qty_decimals == other.qty_decimals &&
+           min_price == other.min_price && max_price == other.max_price;
+  }
+  constexpr bool operator!=(const InstrumentSpec &other) const {
+    return !(*this == other);
+  }
+};
+
+namespace instruments {
+
+// Binance spot BTCUSDT: tick 0.01, lot 0.00001
+inline constexpr InstrumentSpec BTCUSDT{0.01,   0.00001, 2, 5,
+                                       1000.0, 1000000.0};
+
+// Fallback for unknown symbols: Binance text feeds carry 8 decimals
+inline constexpr InstrumentSpec GENERIC{1e-8, 1e-8, 8, 8, 0.0, 1e7};
+
+} // namespace instruments
+
+// Instrument known at compile time: spec() is a constant expression
+template <const InstrumentSpec &Spec> struct StaticInstrument {
+  static constexpr const InstrumentSpec &spec() { return Spec; }
+};
+
+// Instrument known only at runtime (registry or file)
+struct DynamicInstrument {
+  InstrumentSpec value;
+
+  DynamicInstrument() : value(instruments::GENERIC) {}
+  explicit DynamicInstrument(const InstrumentSpec &spec) : value(spec) {}
+  const InstrumentSpec &spec() const { return value; }
+};
+
+using BtcUsdtInstrument = StaticInstrument<instruments::BTCUSDT>;
+
+// Parse an unsigned/signed decimal ("91359.99000000") into integer units of
+// 10^-decimals without going through floating point. Digits beyond the
+// grid are rounded half-up. Returns false on malformed input.
+inline bool parse_fixed_point(const char *begin, const char *end, int decimals,
+                              int64_t &out) {
+  if (begin == end)
+    return false;
+
+  bool negative = false;
+  if (*begin == '-' || *begin == '+') {
+    negative = (*begin == '-');
+    ++begin;
+  }
+
+  int64_t value = 0;
+  bool any_digit = false;
+  while (begin != end && *begin >= '0' && *begin <= '9') {
+    value = value * 10 + (*begin - '0');
+    any_digit = true;
+    ++begin;
+  }
+
+  int frac_digits = 0;
+  if (begin != end && *begin == '.') {
+    ++begin;
+    while (begin != end && *begin >= '0' && *begin <= '9') {
+      if (frac_digits < decimals) {
+        value = value * 10 + (*begin - '0');
+        frac_digits++;
+      } else if (frac_digits == decimals) {
+        // First digit past the grid decides rounding; the rest are ignored
+        if (*begin >= '5')
+          value++;
+        frac_digits++;
+      }
+      any_digit = true;
+      ++begin;
+    }
+  }
+
+  if (!any_digit)
+    return false;
+
+  // Trailing garbage (including exponent notation) is rejected
+  if (begin != end)
+    return false;
+
+  for (int i = frac_digits; i < decimals; ++i)
+    value *= 10;
+
+  out = negative ? -value : value;
+  return true;
+}
+
+// Price/quantity <-> tick/lot conversion specialized on the instrument.
+// With a StaticInstrument every scale below is a compile-time constant.
+template <typename Instrument> class PriceCodec : private Instrument {
+public:
+  PriceCodec() = default;
+  explicit PriceCodec(const Instrument &instrument) : Instrument(instrument) {}
+
+  using Instrument::spec;
+
+  int64_t price_to_ticks(double price) const {
+    int64_t units = std::llround(price * spec().price_scale());
+    return to_grid(units, spec().tick_units());
+  }
+
+  double ticks_to_price(int64_t ticks) const {
+    // Integer numerator and power-of-ten denominator: the division is
+    // correctly rounded, so this reproduces strtod() of the decimal text
+    return static_cast<double>(ticks * spec().tick_units()) /
+           static_cast<double>(spec().price_scale());
+  }
+
+  int64_t qty_to_lots(double quantity) const {
+    int64_t units = std::llround(quantity * spec().qty_scale());
+    return to_grid(units, spec().lot_units());
+  }
+
+  double lots_to_qty(int64_t lots) const {
+    return static_cast<double>(lots * spec().lot_units()) /
+           static_cast<double>(spec().qty_scale());
+  }
+
+  // Decimal text straight to ticks/lots (no strtod)
+  bool parse_price_ticks(const char *begin, const char *end,
+                         int64_t &ticks) const {
+    int64_t units;
+    if (!parse_fixed_point(begin, end, spec().price_decimals, units))
+      return false;
+    ticks = to_grid(units, spec().tick_units());
+    return true;
+  }
+
+  bool parse_qty_lots(const char *begin, const char *end,
+                      int64_t &lots) const {
+    int64_t units;
+    if (!parse_fixed_point(begin, end, spec().qty_decimals, units))
+      return false;
+    lots = to_grid(units, spec().lot_units());
+    return true;
+  }
+
+private:
+  // Snap decimal-grid units onto the tick/lot grid (nearest)
+  static int64_t to_grid(int64_t units, int64_t step) {
+    if (step == 1)
+      return units;
+    return (units + (units >= 0 ? step / 2 : -step / 2)) / step;
+  }
+};
+
+// Runtime instrument registry. Built-in constexpr specs are preregistered;
+// unknown symbols resolve to instruments::GENERIC.
+const InstrumentSpec &instrument_for(const std::string &symbol);
+void register_instrument(const std::string &symbol, const InstrumentSpec &spec);
+
+// Load specs from a pipe-delimited file, one instrument per line:
+// symbol|tick_size|lot_size|price_decimals|qty_decimals|min_price|max_price
+// Returns the number of instruments registered.
+size_t load_instrument_specs(const std::string &filepath);
+
+} // namespace lob
@@ -0,0 +1,256 @@
+#include "L3OrderStore.h"
+#include <algorithm>
+
+namespace lob {
+
+// ---------------------------------------------------------------------------
+// L3OrderPool
+// ---------------------------------------------------------------------------
+
+L3OrderPool::L3OrderPool(size_t max_orders)
+    : max_orders_(std::min<size_t>(max_orders, kNullOrderSlot)),
+      next_unused_(0), free_head_(kNullOrderSlot), live_(0) {}
+
+uint32_t L3OrderPool::allocate() {
+  uint32_t slot;
+
+  if (free_head_ != kNullOrderSlot) {
+    slot = free_head_;
+    free_head_ = (*this)[slot].next;
+  } else {
+    if (next_unused_ >= max_orders_)
+      return kNullOrderSlot;
+
+    if ((next_unused_ >> kChunkBits) >= chunks_.size()) {
+      chunks_.emplace_back(new L3Order[kChunkSize]);
+    }
+    slot = next_unused_++;
+  }
+
+  live_++;
+  return slot;
+}
+
+void L3OrderPool::release(uint32_t slot) {
+  (*this)[slot].next = free_head_;
+  free_head_ = slot;
+  live_--;
+}
+
+void L3OrderPool::reserve(size_t orders) {
+  size_t slots = std::min(orders, max_orders_);
+  size_t chunks = (slots + kChunkSize - 1) >> kChunkBits;
+  while (chunks_.size() < chunks)
+    chunks_.emplace_back(new L3Order[kChunkSize]);
+}
+
+void L3OrderPool::clear() {
+  // Keep allocated chunks for reuse; just forget every slot
+  next_unused_ = 0;
+  free_head_ = kNullOrderSlot;
+  live_ = 0;
+}
+
+// ---------------------------------------------------------------------------
+// L3OrderIndex
+// ---------------------------------------------------------------------------
+
+namespace {
+
+size_t next_pow2(size_t n) {
+  size_t p = 1;
+  while (p < n)
+    p <<= 1;
+  return p;
+}
+
+constexpr size_t kInitialIndexSize = 1024;
+
+} // namespace
+
+L3OrderIndex::L3OrderIndex(size_t max_orders)
+    : mask_(0), size_(0),
+      max_table_size_(std::max(kInitialIndexSize, next_pow2(max_orders * 2))) {
+  table_.assign(std::min(kInitialIndexSize, max_table_size_),
+                Entry{kEmptyKey, kNullOrderSlot});
+  mask_ = table_.size() - 1;
+}
+
+bool L3OrderIndex::insert(uint64_t order_id, uint32_t slot) {
+  if (order_id == kEmptyKey)
+    return false;
+
+  if ((size_ + 1) * 2 > table_.size() && table_.size() < max_table_size_) {
+    grow();
+  }
+
+  size_t i = home(order_id);
+  while (table_[i].key != kEmptyKey) {
+    if (table_[i].key == order_id)
+      return false;
+    i = (i + 1) & mask_;
+  }
+
+  table_[i] = Entry{order_id, slot};
+  size_++;
+  return true;
+}
+
+uint32_t L3OrderIndex::find(uint64_t order_id) const {
+  size_t i = home(order_id);
+  while (table_[i].key != kEmptyKey) {
+    if (table_[i].key == order_id)
+      return table_[i].slot;
+    i = (i + 1) & mask_;
+  }
+  return kNullOrderSlot;
+}
+
+bool L3OrderIndex::erase(uint64_t order_id) {
+  size_t i = home(order_id);
+  while (table_[i].key != order_id) {
+    if (table_[i].key == kEmptyKey)
+      return false;
+    i = (i + 1) & mask_;
+  }
+
+  // Backward-shift deletion: pull later entries of the probe run into the
+  // hole so lookups never need tombstones.
+  size_t j = i;
+  while (true) {
+    j = (j + 1) & mask_;
+    if (table_[j].key == kEmptyKey)
+      break;
+
+    size_t h = home(table_[j].key);
+    if (((j - h) & mask_) >= ((j - i) & mask_)) {
+      table_[i] = table_[j];
+      i = j;
+    }
+  }
+
+  table_[i] = Entry{kEmptyKey, kNullOrderSlot};
+  size_--;
+  return true;
+}
+
+void L3OrderIndex::reserve(size_t orders) {
+  size_t target = std::min(max_table_size_, next_pow2(orders * 2));
+  while (table_.size() < target)
+    grow();
+}
+
+void L3OrderIndex::clear() {
+  std::fill(table_.begin(), table_.end(), Entry{kEmptyKey, kNullOrderSlot});
+  size_ = 0;
+}
+
+void L3OrderIndex::grow() {
+  std::vector<Entry> old;
+  old.swap(table_);
+
+  table_.assign(old.size() * 2, Entry{kEmptyKey, kNullOrderSlot});
+  mask_ = table_.size() - 1;
+
+  for (const Entry &entry : old) {
+    if (entry.key == kEmptyKey)
+      continue;
+    size_t i = home(entry.key);
+    while (table_[i].key != kEmptyKey)
+      i = (i + 1) & mask_;
+    table_[i] = entry;
+  }
+}
+
+// ---------------------------------------------------------------------------
+// L3OrderStore
+// ---------------------------------------------------------------------------
+
+L3OrderStore::L3OrderStore(size_t max_orders)
+    : pool_(max_orders), index_(max_orders) {}
+
+uint32_t L3OrderStore::insert(uint64_t order_id, int64_t price_ticks,
+                              double quantity, Side side, uint64_t timestamp,
+                              Limit &level) {
+  uint32_t slot = pool_.allocate();
+  if (slot == kNullOrderSlot)
+    return kNullOrderSlot;
+
+  if (!index_.insert(order_id, slot)) {
+    pool_.release(slot);
+    return kNullOrderSlot;
+  }
+
+  L3Order &order = pool_[slot];
+  order.order_id = order_id;
+  order.price_ticks = price_ticks;
+  order.quantity = quantity;
+  order.timestamp = timestamp;
+  order.level = &level;
+  order.side = side;
+
+  // Link at the back of the level's FIFO queue
+  order.prev = level.l3_tail;
+  order.next = kNullOrderSlot;
+  if (level.l3_tail != kNullOrderSlot) {
+    pool_[level.l3_tail].next = slot;
+  } else {
+    level.l3_head = slot;
+  }
+  level.l3_tail = slot;
+
+  level.total_volume += quantity;
+  level.order_count++;
+  return slot;
+}
+
+void L3OrderStore::remove(uint32_t slot) {
+  L3Order &order = pool_[slot];
+  Limit &level = *order.level;
+
+  if (order.prev != kNullOrderSlot) {
+    pool_[order.prev].next = order.next;
+  } else {
+    level.l3_head = order.next;
+  }
+  if (order.next != kNullOrderSlot) {
+    pool_[order.next].prev = order.prev;
+  } else {
+    level.l3_tail = order.prev;
+  }
+
+  level.order_count--;
+  // Snap to exact zero when the level drains (no accumulated FP residue)
+  level.total_volume =
+      level.order_count == 0 ? 0.0 : level.total_volume - order.quantity;
+
+  index_.erase(order.order_id);
+  pool_.release(slot);
+}
+
+void L3OrderStore::reduce(uint32_t slot, double new_quantity) {
+  L3Order &order = pool_[slot];
+  order.level->total_volume -= order.quantity - new_quantity;
+  order.quantity = new_quantity;
+}
+
+void L3OrderStore::release_level(Limit &level) {
+  uint32_t slot = level.l3_head;
+  while (slot != kNullOrderSlot) {
+    uint32_t next = pool_[slot].next;
+    index_.erase(pool_[slot].order_id);
+    pool_.release(slot);
+    slot = next;
+  }
+
+  level.l3_head = level.l3_tail = kNullOrderSlot;
+  level.total_volume = 0.0;
+  level.order_count = 0;
+}
+
+void L3OrderStore::clear() {
+  pool_.clear();
+  index_.clear();
+}
+
+} // namespace lob
@@ -0,0 +1,196 @@
+#pragma once
+
+#include "Order.h"
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+namespace lob {
+
+// One exchange order tracked in true L3 (market-by-order) mode
+struct L3Order {
+  uint64_t order_id;
+  int64_t price_ticks;
+  double quantity;
+  uint64_t timestamp;
+  Limit *level;  // Owning price level (std::map nodes never move)
+  uint32_t prev; // Intrusive FIFO links (pool slots)
+  uint32_t next;
+  Side side;
+};
+
+// Bounded slab of L3 orders addressed by 32-bit slot. Nodes are allocated
+// in fixed-size chunks on demand (never more than max_orders) and recycled
+// through an intrusive free list, so steady-state churn never allocates.
+class L3OrderPool {
+public:
+  static constexpr uint32_t kChunkBits = 16;
+  static constexpr uint32_t kChunkSize = 1u << kChunkBits;
+
+  explicit L3OrderPool(size_t max_orders);
+
+  // Returns kNullOrderSlot when the pool is exhausted
+  uint32_t allocate();
+  void release(uint32_t slot);
+  void clear();
+
+  // Allocate chunks for the first orders slots up front
+  void reserve(size_t orders);
+
+  L3Order &operator[](uint32_t slot) {
+    return chunks_[slot >> kChunkBits][slot & (kChunkSize - 1)];
+  }
+  const L3Order &operator[](uint32_t slot) const {
+    return chunks_[slot >> kChunkBits][slot & (kChunkSize - 1)];
+  }
+
+  size_t live() const { return live_; }
+  size_t capacity() const { return max_orders_; }
+  size_t reserved() const { return chunks_.size() * kChunkSize; }
+
+private:
+  std::vector<std::unique_ptr<L3Order[]>> chunks_;
+  size_t max_orders_;
+  uint32_t next_unused_; // First never-used slot
+  uint32_t free_head_;   // Recycled slots, linked through L3Order::next
+  size_t live_;
+};
+
+// Open-addressing (linear probing) map from exchange order id to pool slot.
+// Flat 16-byte entries, load factor <= 0.5, backward-shift deletion (no
+// tombstones), so lookups stay short under heavy add/cancel churn. The
+// table grows by doubling but never beyond what max_orders requires.
+class L3OrderIndex {
+public:
+  explicit L3OrderIndex(size_t max_orders);
+
+  // False if the id is already present (or is the reserved empty key)
+  bool insert(uint64_t order_id, uint32_t slot);
+  uint32_t find(uint64_t order_id) const; // kNullOrderSlot if absent
+  bool erase(uint64_t order_id);
+  void clear();
+
+  // Grow now so that orders ids fit without rehashing
+  void reserve(size_t orders);
+
+  size_t size() const { return size_; }
+  size_t table_size() const { return table_.size(); }
+
+private:
+  static constexpr uint64_t kEmptyKey = UINT64_MAX;
+
+  struct Entry {
+    uint64_t key;
+    uint32_t slot;
+  };
+
+  std::vector<Entry> table_;
+  size_t mask_;
+  size_t size_;
+  size_t max_table_size_;
+
+  size_t home(uint64_t key) const {
+    // Finalizer from splitmix64: spreads sequential exchange ids
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    return static_cast<size_t>(key) & mask_;
+  }
+
+  void grow();
+};
+
+// Read-only FIFO view of the L3 orders resting at one price level
+class L3QueueView {
+public:
+  class iterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = L3Order;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const L3Order *;
+    using reference = const L3Order &;
+
+    iterator(const L3OrderPool *pool, uint32_t slot)
+        : pool_(pool), slot_(slot) {}
+
+    const L3Order &operator*() const { return (*pool_)[slot_]; }
+    const L3Order *operator->() const { return &(*pool_)[slot_]; }
+    iterator &operator++() {
+      slot_ = (*pool_)[slot_].next;
+      return *this;
+    }
+    bool operator==(const iterator &other) const {
+      return slot_ == other.slot_;
+    }
+    bool operator!=(const iterator &other) const {
+      return slot_ != other.slot_;
+    }
+
+  private:
+    const L3OrderPool *pool_;
+    uint32_t slot_;
+  };
+
+  L3QueueView() : pool_(nullptr), head_(kNullOrderSlot), size_(0) {}
+  L3QueueView(const L3OrderPool *pool, uint32_t head, size_t size)
+      : pool_(pool), head_(head), size_(size) {}
+
+  iterator begin() const { return iterator(pool_, head_); }
+  iterator end() const { return iterator(pool_, kNullOrderSlot); }
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+private:
+  const L3OrderPool *pool_;
+  uint32_t head_;
+  size_t size_;
+};
+
+// Pool + id index + per-level intrusive queues. Keeps each level's
+// total_volume/order_count in sync so L2 depth queries keep working.
+class L3OrderStore {
+public:
+  static constexpr size_t kDefaultMaxOrders = size_t(1) << 22;
+
+  explicit L3OrderStore(size_t max_orders = kDefaultMaxOrders);
+
+  // Append a new order to the back of level's queue. Returns the slot, or
+  // kNullOrderSlot if the id already exists or the pool is exhausted.
+  uint32_t insert(uint64_t order_id, int64_t price_ticks, double quantity,
+                  Side side, uint64_t timestamp, Limit &level);
+
+  // Unlink and free an order (O(1)); its level is left possibly empty
+  void remove(uint32_t slot);
+
+  // Shrink an order in place, keeping queue priority
+  void reduce(uint32_t slot, double new_quantity);
+
+  // Free every order resting at a level (level erased by the caller)
+  void release_level(Limit &level);
+
+  uint32_t find(uint64_t order_id) const { return index_.find(order_id); }
+  const L3Order &operator[](uint32_t slot) const { return pool_[slot]; }
+
+  L3QueueView queue(const Limit &level) const {
+    return L3QueueView(&pool_, level.l3_head, level.order_count);
+  }
+
+  void clear();
+
+  // Presize pool and index for orders live orders
+  void reserve(size_t orders) {
+    pool_.reserve(orders);
+    index_.reserve(orders);
+  }
+
+  size_t size() const { return pool_.live(); }
+  size_t capacity() const { return pool_.capacity(); }
+
+private:
+  L3OrderPool pool_;
+  L3OrderIndex index_;
+};
+
+} // namespace lob
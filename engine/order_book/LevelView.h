@@ -0,0 +1,161 @@
+#pragma once
+
+#include "Order.h"
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+
+namespace lob {
+
+// Aggregated view of one price level, returned by value from depth queries
+struct LevelInfo {
+  double price;
+  double volume;
+  uint32_t order_count;
+};
+
+// Touch snapshot maintained incrementally by the book on every change.
+// Derived fields (mid, spread, microprice) are only meaningful when valid().
+struct TopOfBook {
+  double bid_price = 0.0;
+  double bid_size = 0.0;
+  double ask_price = 0.0;
+  double ask_size = 0.0;
+  double mid = 0.0;
+  double spread = 0.0;
+  double microprice = 0.0;
+  bool has_bid = false;
+  bool has_ask = false;
+
+  bool valid() const { return has_bid && has_ask; }
+
+  // Recompute mid/spread/microprice from the touch fields
+  void update_derived() {
+    if (!valid()) {
+      mid = spread = microprice = 0.0;
+      return;
+    }
+    mid = (bid_price + ask_price) / 2.0;
+    spread = ask_price - bid_price;
+    double touch_volume = bid_size + ask_size;
+    microprice = touch_volume > 1e-12
+                     ? (bid_price * ask_size + ask_price * bid_size) /
+                           touch_volume
+                     : mid;
+  }
+};
+
+// Fixed-capacity depth buffer owned by the caller (no heap allocation)
+template <size_t N> struct DepthArray {
+  std::array<LevelInfo, N> levels;
+  size_t count = 0;
+
+  static constexpr size_t capacity() { return N; }
+  size_t size() const { return count; }
+  bool empty() const { return count == 0; }
+
+  const LevelInfo &operator[](size_t i) const { return levels[i]; }
+  const LevelInfo *begin() const { return levels.data(); }
+  const LevelInfo *end() const { return levels.data() + count; }
+};
+
+// Forward iterator over the best N levels of one side of the book.
+// Yields LevelInfo by value so callers never see the underlying container.
+template <typename MapIt> class LevelIterator {
+public:
+  using iterator_category = std::forward_iterator_tag;
+  using value_type = LevelInfo;
+  using difference_type = std::ptrdiff_t;
+  using pointer = void;
+  using reference = LevelInfo;
+
+  LevelIterator() : it_(), end_(), remaining_(0) {}
+  LevelIterator(MapIt it, MapIt end, size_t remaining)
+      : it_(it), end_(end), remaining_(remaining) {}
+
+  LevelInfo operator*() const {
+    const auto &limit = it_->second;
+    return LevelInfo{limit.price, limit.total_volume, limit.order_count};
+  }
+
+  LevelIterator &operator++() {
+    ++it_;
+    --remaining_;
+    return *this;
+  }
+
+  LevelIterator operator++(int) {
+    LevelIterator tmp = *this;
+    ++(*this);
+    return tmp;
+  }
+
+  bool operator==(const LevelIterator &other) const {
+    return done() == other.done() && (done() || it_ == other.it_);
+  }
+  bool operator!=(const LevelIterator &other) const {
+    return !(*this == other);
+  }
+
+private:
+  MapIt it_;
+  MapIt end_;
+  size_t remaining_;
+
+  bool done() const { return remaining_ == 0 || it_ == end_; }
+};
+
+// Range over the best N levels of one side (range-for compatible)
+template <typename MapIt> class LevelRange {
+public:
+  LevelRange(MapIt begin, MapIt end, size_t n)
+      : begin_(begin), end_(end), n_(n) {}
+
+  LevelIterator<MapIt> begin() const {
+    return LevelIterator<MapIt>(begin_, end_, n_);
+  }
+  LevelIterator<MapIt> end() const { return LevelIterator<MapIt>(); }
+  bool empty() const { return n_ == 0 || begin_ == end_; }
+
+private:
+  MapIt begin_;
+  MapIt end_;
+  size_t n_;
+};
+
+// Read-only view of the synthetic order queue at one price level.
+// Invalidated by any update to that level.
+class OrderQueueView {
+public:
+  using const_iterator = SyntheticQueue::const_iterator;
+
+  OrderQueueView() : orders_(nullptr) {}
+  explicit OrderQueueView(const SyntheticQueue *orders) : orders_(orders) {}
+
+  size_t size() const { return orders_ ? orders_->size() : 0; }
+  bool empty() const { return size() == 0; }
+
+  Order operator[](size_t i) const { return (*orders_)[i]; }
+  Order front() const { return orders_->front(); }
+  Order back() const { return orders_->back(); }
+
+  // Contiguous quantities, front first (size() entries)
+  const double *quantities() const {
+    return orders_ ? orders_->quantities() : nullptr;
+  }
+
+  const_iterator begin() const {
+    return orders_ ? orders_->begin() : const_iterator();
+  }
+  const_iterator end() const {
+    return orders_ ? orders_->end() : const_iterator();
+  }
+
+private:
+  const SyntheticQueue *orders_;
+};
+
+constexpr size_t kAllLevels = std::numeric_limits<size_t>::max();
+
+} // namespace lob
@@ -1,8 +1,10 @@
 #pragma once
 
+#include "SimdScan.h"
 #include <cstdint>
 #include <string>
-#include <deque>
+#include <vector>
+#include <iterator>
 #include <cmath>
 #include <cassert>
 
@@ -11,6 +13,9 @@ namespace lob {
 // Order side enumeration
 enum class Side { BID, ASK };
 
+// Null link for L3 intrusive queues (see L3OrderStore)
+constexpr uint32_t kNullOrderSlot = UINT32_MAX;
+
 // Individual order structure
 struct Order {
   uint64_t order_id;
@@ -23,23 +28,169 @@ struct Order {
       : order_id(id), price(p), quantity(q), side(s), timestamp(ts) {}
 };
 
+// Synthetic L3 queue of one price level, stored as contiguous arrays
+// (structure of arrays) so FIFO consumption can scan quantities with
+// vector ops. Orders are dropped from the front by advancing head_; the
+// consumed prefix is reclaimed once it dominates the buffer.
+class SyntheticQueue {
+public:
+  SyntheticQueue() : head_(0), price_(0.0), side_(Side::BID) {}
+
+  size_t size() const { return qty_.size() - head_; }
+  bool empty() const { return size() == 0; }
+
+  // Materialize entry i (0 = front) as an Order
+  Order operator[](size_t i) const {
+    return Order(ids_[head_ + i], price_, qty_[head_ + i], side_,
+                 ts_[head_ + i]);
+  }
+  Order front() const { return (*this)[0]; }
+  Order back() const { return (*this)[size() - 1]; }
+
+  // Contiguous quantities, front first
+  const double *quantities() const { return qty_.data() + head_; }
+  double *quantities() { return qty_.data() + head_; }
+
+  double quantity(size_t i) const { return qty_[head_ + i]; }
+  uint64_t order_id(size_t i) const { return ids_[head_ + i]; }
+  uint64_t timestamp(size_t i) const { return ts_[head_ + i]; }
+
+  void push_back(uint64_t order_id, double price, double qty, Side side,
+                 uint64_t timestamp) {
+    price_ = price;
+    side_ = side;
+    ids_.push_back(order_id);
+    qty_.push_back(qty);
+    ts_.push_back(timestamp);
+  }
+
+  // Drop the first n orders in O(1) (amortized)
+  void pop_front(size_t n = 1) {
+    head_ += n;
+    if (head_ == qty_.size()) {
+      clear();
+    } else if (head_ >= 64 && head_ * 2 >= qty_.size()) {
+      reclaim();
+    }
+  }
+
+  void pop_back() {
+    ids_.pop_back();
+    qty_.pop_back();
+    ts_.pop_back();
+    if (head_ == qty_.size())
+      clear();
+  }
+
+  // Remove entry i, keeping the order of the rest
+  void erase(size_t i) {
+    size_t at = head_ + i;
+    ids_.erase(ids_.begin() + at);
+    qty_.erase(qty_.begin() + at);
+    ts_.erase(ts_.begin() + at);
+    if (head_ == qty_.size())
+      clear();
+  }
+
+  // Remove every order whose quantity is <= epsilon (stable)
+  void remove_drained(double epsilon) {
+    size_t out = head_;
+    for (size_t i = head_; i < qty_.size(); ++i) {
+      if (qty_[i] > epsilon) {
+        ids_[out] = ids_[i];
+        qty_[out] = qty_[i];
+        ts_[out] = ts_[i];
+        out++;
+      }
+    }
+    ids_.resize(out);
+    qty_.resize(out);
+    ts_.resize(out);
+    if (head_ == qty_.size())
+      clear();
+  }
+
+  // Keeps capacity: a level that refills does not reallocate
+  void clear() {
+    ids_.clear();
+    qty_.clear();
+    ts_.clear();
+    head_ = 0;
+  }
+
+  class const_iterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = Order;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = Order;
+
+    const_iterator() : queue_(nullptr), i_(0) {}
+    const_iterator(const SyntheticQueue *queue, size_t i)
+        : queue_(queue), i_(i) {}
+
+    Order operator*() const { return (*queue_)[i_]; }
+    const_iterator &operator++() {
+      ++i_;
+      return *this;
+    }
+    bool operator==(const const_iterator &other) const {
+      return i_ == other.i_;
+    }
+    bool operator!=(const const_iterator &other) const {
+      return i_ != other.i_;
+    }
+
+  private:
+    const SyntheticQueue *queue_;
+    size_t i_;
+  };
+
+  const_iterator begin() const { return const_iterator(this, 0); }
+  const_iterator end() const { return const_iterator(this, size()); }
+
+private:
+  std::vector<uint64_t> ids_;
+  std::vector<double> qty_;
+  std::vector<uint64_t> ts_;
+  size_t head_; // Index of the front order
+  double price_;
+  Side side_;
+
+  void reclaim() {
+    ids_.erase(ids_.begin(), ids_.begin() + head_);
+    qty_.erase(qty_.begin(), qty_.begin() + head_);
+    ts_.erase(ts_.begin(), ts_.begin() + head_);
+    head_ = 0;
+  }
+};
+
 // Price level (Limit) structure with L3 simulation
 struct Limit {
   double price;
   double total_volume;
   uint32_t order_count;
   
-  // L3 simulation: deque of individual orders (FIFO semantics)
-  std::deque<Order> orders;
+  // L3 simulation: queue of individual orders (FIFO semantics)
+  SyntheticQueue orders;
+
+  // True L3 mode: head/tail of the intrusive queue in L3OrderStore
+  uint32_t l3_head;
+  uint32_t l3_tail;
 
   // Default constructor (needed for std::map::operator[])
-  Limit() : price(0.0), total_volume(0.0), order_count(0) {}
+  Limit()
+      : price(0.0), total_volume(0.0), order_count(0),
+        l3_head(kNullOrderSlot), l3_tail(kNullOrderSlot) {}
 
-  Limit(double p) : price(p), total_volume(0.0), order_count(0) {}
+  Limit(double p)
+      : price(p), total_volume(0.0), order_count(0), l3_head(kNullOrderSlot),
+        l3_tail(kNullOrderSlot) {}
 
   // Add a synthetic order to the back of the queue
   void add_synthetic_order(uint64_t order_id, double qty, Side side, uint64_t timestamp) {
-    orders.emplace_back(order_id, price, qty, side, timestamp);
+    orders.push_back(order_id, price, qty, side, timestamp);
     total_volume += qty;
     order_count = static_cast<uint32_t>(orders.size());
   }
@@ -47,24 +198,26 @@ struct Limit {
   // Reduce volume from front of queue (FIFO)
   // Returns the amount actually removed
   double reduce_volume_fifo(double qty_to_remove) {
-    double removed = 0.0;
-    
-    while (qty_to_remove > 1e-8 && !orders.empty()) {
-      Order& front = orders.front();
-      
-      if (front.quantity <= qty_to_remove) {
-        // Remove entire order
-        removed += front.quantity;
-        qty_to_remove -= front.quantity;
-        orders.pop_front();
+    // One vector scan finds the whole orders the decrease covers; they are
+    // dropped in bulk and the boundary order is trimmed by the remainder
+    PrefixCut cut = prefix_cut(orders.quantities(), orders.size(),
+                               qty_to_remove);
+    orders.pop_front(cut.count);
+
+    double removed = cut.consumed;
+    double remaining = qty_to_remove - cut.consumed;
+    if (remaining > 1e-8 && !orders.empty()) {
+      double front = orders.quantities()[0];
+      if (front > remaining) {
+        orders.quantities()[0] = front - remaining;
+        removed = qty_to_remove;
       } else {
-        // Partial reduction
-        front.quantity -= qty_to_remove;
-        removed += qty_to_remove;
-        qty_to_remove = 0.0;
+        // Sum rounding put the cut one order early
+        removed += front;
+        orders.pop_front();
       }
     }
-    
+
     total_volume -= removed;
     order_count = static_cast<uint32_t>(orders.size());
     return removed;
@@ -80,12 +233,16 @@ struct Limit {
   // Validate invariants (debug builds)
   void validate_invariants() const {
     #ifndef NDEBUG
+    // L3 levels keep their queue in L3OrderStore, not in the deque
+    if (l3_head != kNullOrderSlot)
+      return;
+
     // Invariant 1: Volume consistency
     double sum = 0.0;
-    for (const auto& order : orders) {
-      sum += order.quantity;
+    for (size_t i = 0; i < orders.size(); ++i) {
+      sum += orders.quantity(i);
       // Invariant 2: Non-negative quantities
-      assert(order.quantity >= 0.0);
+      assert(orders.quantity(i) >= 0.0);
     }
     assert(std::abs(sum - total_volume) < 1e-6);
     
@@ -1,160 +1,85 @@
 #include "OrderBook.h"
+#include "../metrics/Diagnostics.h"
 #include <algorithm>
 #include <cmath>
-#include <iostream>
+#include <type_traits>
 
 namespace lob {
 
 OrderBook::OrderBook(const std::string &symbol)
-    : symbol_(symbol), next_order_id_(1) {}
+    : OrderBook(symbol, instrument_for(symbol)) {}
+
+OrderBook::OrderBook(const std::string &symbol, const InstrumentSpec &spec)
+    : symbol_(symbol), codec_(DynamicInstrument(spec)), next_order_id_(1),
+      l3_reserve_(0) {}
+
+// Runtime side entry points: dispatch once, then run the specialized path
 
 void OrderBook::add_order(double price, double quantity, Side side,
                           uint64_t timestamp) {
-  // HYBRID L2/L3 SEMANTICS:
-  // L2 input: absolute volume at price level
-  // L3 simulation: maintain deque of synthetic orders
-  // Delta calculation: new_qty - old_qty determines add/remove
-
   if (side == Side::BID) {
-    auto it = bids_.find(price);
-    if (it != bids_.end()) {
-      // Existing level: calculate delta
-      double old_volume = it->second.total_volume;
-      double delta = quantity - old_volume;
-
-      if (delta > 1e-8) {
-        // Volume increase: add synthetic order
-        it->second.add_synthetic_order(next_order_id_++, delta, side,
-                                       timestamp);
-      } else if (delta < -1e-8) {
-        // Volume decrease: remove from front (FIFO)
-        it->second.reduce_volume_fifo(-delta);
-      }
-      // else: delta ~= 0, no change
-
-      it->second.validate_invariants();
-    } else {
-      // New level: create with single synthetic order
-      Limit limit(price);
-      limit.add_synthetic_order(next_order_id_++, quantity, side, timestamp);
-      limit.validate_invariants();
-      bids_[price] = limit;
-    }
+    add<Side::BID>(price, quantity, timestamp);
   } else {
-    auto it = asks_.find(price);
-    if (it != asks_.end()) {
-      // Existing level: calculate delta
-      double old_volume = it->second.total_volume;
-      double delta = quantity - old_volume;
-
-      if (delta > 1e-8) {
-        // Volume increase: add synthetic order
-        it->second.add_synthetic_order(next_order_id_++, delta, side,
-                                       timestamp);
-      } else if (delta < -1e-8) {
-        // Volume decrease: remove from front (FIFO)
-        it->second.reduce_volume_fifo(-delta);
-      }
-      // else: delta ~= 0, no change
-
-      it->second.validate_invariants();
-    } else {
-      // New level: create with single synthetic order
-      Limit limit(price);
-      limit.add_synthetic_order(next_order_id_++, quantity, side, timestamp);
-      limit.validate_invariants();
-      asks_[price] = limit;
-    }
+    add<Side::ASK>(price, quantity, timestamp);
   }
 }
 
 void OrderBook::clear_price_level(double price, Side side) {
   if (side == Side::BID) {
-    bids_.erase(price);
+    clear_level<Side::BID>(price);
   } else {
-    asks_.erase(price);
+    clear_level<Side::ASK>(price);
   }
 }
 
 void OrderBook::update_order(double price, double quantity, Side side,
                              uint64_t timestamp) {
-  // BINANCE L2 UPDATE SEMANTICS:
-  // - quantity == 0: Remove price level immediately
-  // - quantity > 0: Replace volume at this price level (delta-based L3
-  // simulation)
-
-  // Zero quantity: remove the level immediately
-  if (quantity == 0.0 || std::abs(quantity) < 1e-8) {
-    clear_price_level(price, side);
-    return;
+  if (side == Side::BID) {
+    update<Side::BID>(price, quantity, timestamp);
+  } else {
+    update<Side::ASK>(price, quantity, timestamp);
   }
-
-  // Non-zero quantity: use delta-based add_order (Hybrid L2/L3)
-  add_order(price, quantity, side, timestamp);
-
-  // Validate book integrity after update
-  validate_book_integrity();
 }
 
 std::optional<double> OrderBook::get_best_bid() const {
-  if (bids_.empty())
+  if (!top_.has_bid)
     return std::nullopt;
-  return bids_.begin()->first;
+  return top_.bid_price;
 }
 
 std::optional<double> OrderBook::get_best_ask() const {
-  if (asks_.empty())
+  if (!top_.has_ask)
     return std::nullopt;
-  return asks_.begin()->first;
+  return top_.ask_price;
 }
 
 std::optional<double> OrderBook::get_mid_price() const {
-  auto best_bid = get_best_bid();
-  auto best_ask = get_best_ask();
-
-  if (!best_bid || !best_ask)
+  if (!top_.valid())
     return std::nullopt;
-
-  return (*best_bid + *best_ask) / 2.0;
+  return top_.mid;
 }
 
 std::optional<double> OrderBook::get_spread() const {
-  auto best_bid = get_best_bid();
-  auto best_ask = get_best_ask();
-
-  if (!best_bid || !best_ask)
+  if (!top_.valid())
     return std::nullopt;
-
-  return *best_ask - *best_bid;
+  return top_.spread;
 }
 
 double OrderBook::get_bid_volume(double price) const {
-  auto it = bids_.find(price);
-  if (it != bids_.end()) {
-    return it->second.total_volume;
-  }
-  return 0.0;
+  return bids_.volume_at(codec_.price_to_ticks(price));
 }
 
 double OrderBook::get_ask_volume(double price) const {
-  auto it = asks_.find(price);
-  if (it != asks_.end()) {
-    return it->second.total_volume;
-  }
-  return 0.0;
+  return asks_.volume_at(codec_.price_to_ticks(price));
 }
 
 std::vector<std::pair<double, double>>
 OrderBook::get_bid_depth(size_t n) const {
   std::vector<std::pair<double, double>> result;
-  result.reserve(n);
-
-  size_t count = 0;
-  for (const auto &[price, limit] : bids_) {
-    if (count >= n)
-      break;
-    result.emplace_back(price, limit.total_volume);
-    count++;
+  result.reserve(std::min(n, bids_.size()));
+
+  for (const LevelInfo &level : bid_levels(n)) {
+    result.emplace_back(level.price, level.volume);
   }
 
   return result;
@@ -163,45 +88,29 @@ OrderBook::get_bid_depth(size_t n) const {
 std::vector<std::pair<double, double>>
 OrderBook::get_ask_depth(size_t n) const {
   std::vector<std::pair<double, double>> result;
-  result.reserve(n);
-
-  size_t count = 0;
-  for (const auto &[price, limit] : asks_) {
-    if (count >= n)
-      break;
-    result.emplace_back(price, limit.total_volume);
-    count++;
+  result.reserve(std::min(n, asks_.size()));
+
+  for (const LevelInfo &level : ask_levels(n)) {
+    result.emplace_back(level.price, level.volume);
   }
 
   return result;
 }
 
-double OrderBook::get_total_bid_volume(size_t depth) const {
-  double total = 0.0;
-  size_t count = 0;
-
-  for (const auto &[price, limit] : bids_) {
-    if (count >= depth)
-      break;
-    total += limit.total_volume;
-    count++;
-  }
+size_t OrderBook::get_bid_depth(LevelInfo *out, size_t capacity) const {
+  return bids_.depth(out, capacity);
+}
 
-  return total;
+size_t OrderBook::get_ask_depth(LevelInfo *out, size_t capacity) const {
+  return asks_.depth(out, capacity);
 }
 
-double OrderBook::get_total_ask_volume(size_t depth) const {
-  double total = 0.0;
-  size_t count = 0;
-
-  for (const auto &[price, limit] : asks_) {
-    if (count >= depth)
-      break;
-    total += limit.total_volume;
-    count++;
-  }
+double OrderBook::get_total_bid_volume(size_t depth) const {
+  return bids_.total_volume(depth);
+}
 
-  return total;
+double OrderBook::get_total_ask_volume(size_t depth) const {
+  return asks_.total_volume(depth);
 }
 
 double OrderBook::calculate_imbalance(size_t depth) const {
@@ -221,42 +130,46 @@ void OrderBook::validate_book_integrity() const {
   // In a valid order book: best_bid < best_ask
   // Note: best_bid == best_ask is acceptable during rapid updates
 
-  auto best_bid = get_best_bid();
-  auto best_ask = get_best_ask();
-
-  if (best_bid && best_ask) {
+  if (top_.valid()) {
     // Only fix if STRICTLY crossed (bid > ask), not equal
-    if (*best_bid > *best_ask) {
-      std::cerr << "[WARN] Crossed book detected for " << symbol_
-                << ": best_bid=" << *best_bid << " > best_ask=" << *best_ask
-                << std::endl;
-      std::cerr << "[WARN] Auto-fixing by clearing crossed levels..."
-                << std::endl;
+    if (bids_.best_ticks() > asks_.best_ticks()) {
+      int64_t bid_ticks = bids_.best_ticks();
+      int64_t ask_ticks = asks_.best_ticks();
+      double bid_price = top_.bid_price;
+      double ask_price = top_.ask_price;
+      size_t removed = 0;
 
       // Auto-fix: Remove crossed levels
       OrderBook *mutable_this = const_cast<OrderBook *>(this);
 
       // Remove all bids STRICTLY > best ask (not >=)
-      auto bid_it = mutable_this->bids_.begin();
-      while (bid_it != mutable_this->bids_.end() && bid_it->first > *best_ask) {
-        std::cerr << "[WARN] Removing crossed bid level: " << bid_it->first
-                  << std::endl;
-        bid_it = mutable_this->bids_.erase(bid_it);
-      }
+      removed += mutable_this->bids_.erase_better_than(
+          asks_.best_ticks(), [mutable_this](Limit &limit) {
+            LOB_DIAG(DiagLevel::DEBUG, DiagCategory::CROSSED_LEVEL,
+                     "Removing crossed bid level: " << limit.price);
+            if (mutable_this->l3_)
+              mutable_this->l3_->release_level(limit);
+          });
+      mutable_this->bids_.refresh_touch(mutable_this->top_);
 
       // Remove all asks STRICTLY < best bid (not <=)
-      auto new_best_bid = mutable_this->get_best_bid();
-      if (new_best_bid) {
-        auto ask_it = mutable_this->asks_.begin();
-        while (ask_it != mutable_this->asks_.end() &&
-               ask_it->first < *new_best_bid) {
-          std::cerr << "[WARN] Removing crossed ask level: " << ask_it->first
-                    << std::endl;
-          ask_it = mutable_this->asks_.erase(ask_it);
-        }
+      if (top_.has_bid) {
+        removed += mutable_this->asks_.erase_better_than(
+            bids_.best_ticks(), [mutable_this](Limit &limit) {
+              LOB_DIAG(DiagLevel::DEBUG, DiagCategory::CROSSED_LEVEL,
+                       "Removing crossed ask level: " << limit.price);
+              if (mutable_this->l3_)
+                mutable_this->l3_->release_level(limit);
+            });
+        mutable_this->asks_.refresh_touch(mutable_this->top_);
       }
 
-      std::cerr << "[INFO] Book fixed. Continuing..." << std::endl;
+      LOB_DIAG(DiagLevel::WARN, DiagCategory::CROSSED_BOOK,
+               "Crossed book for " << symbol_ << ": best_bid=" << bid_price
+                                   << " > best_ask=" << ask_price
+                                   << ", removed " << removed
+                                   << " crossed levels");
+      LOB_PROBE3(crossed_book_repaired, bid_ticks, ask_ticks, removed);
     }
   }
 }
@@ -264,26 +177,196 @@ void OrderBook::validate_book_integrity() const {
 void OrderBook::clear() {
   bids_.clear();
   asks_.clear();
+  top_ = TopOfBook();
+  if (l3_)
+    l3_->clear();
   reset_order_ids();
 }
 
-const std::deque<Order> &OrderBook::get_orders_at_price(double price,
-                                                        Side side) const {
-  static const std::deque<Order> empty_deque;
+void OrderBook::save_state(BookState &state) const {
+  state.clear();
+  state.next_order_id = next_order_id_;
+  state.l3 = l3_ != nullptr;
+
+  auto save = [&](const auto &half, std::vector<BookState::Level> &levels) {
+    levels.reserve(half.size());
+    for (const auto &[ticks, limit] : half) {
+      size_t first = state.queue.size();
+      if (l3_) {
+        for (const L3Order &order : l3_->queue(limit))
+          state.queue.push_back(
+              {order.order_id, order.quantity, order.timestamp});
+      } else {
+        const SyntheticQueue &orders = limit.orders;
+        for (size_t i = 0; i < orders.size(); ++i)
+          state.queue.push_back(
+              {orders.order_id(i), orders.quantity(i), orders.timestamp(i)});
+      }
+      levels.push_back({ticks, limit.price, limit.total_volume,
+                        static_cast<uint32_t>(state.queue.size() - first)});
+    }
+  };
+  save(bids_, state.bids);
+  save(asks_, state.asks);
+}
+
+void OrderBook::restore_state(const BookState &state) {
+  clear();
+  if (state.l3)
+    enable_l3();
+  else
+    l3_.reset();
+
+  size_t next = 0;
+  auto restore = [&](auto &half, const std::vector<BookState::Level> &levels) {
+    constexpr Side side = std::decay_t<decltype(half)>::side;
+    for (const BookState::Level &saved : levels) {
+      Limit &limit = half.level(saved.ticks, saved.price);
+      for (uint32_t i = 0; i < saved.orders; ++i, ++next) {
+        const BookState::QueuedOrder &order = state.queue[next];
+        if (l3_)
+          l3_->insert(order.order_id, saved.ticks, order.quantity, side,
+                      order.timestamp, limit);
+        else
+          limit.add_synthetic_order(order.order_id, order.quantity, side,
+                                    order.timestamp);
+      }
+      // The running total, not the re-summed one (bit-exact replay)
+      limit.total_volume = saved.volume;
+    }
+    half.refresh_touch(top_);
+  };
+  restore(bids_, state.bids);
+  restore(asks_, state.asks);
+  next_order_id_ = state.next_order_id;
+}
+
+// ---------------------------------------------------------------------------
+// True L3 mode
+// ---------------------------------------------------------------------------
+
+void OrderBook::enable_l3(size_t max_orders) {
+  if (!l3_) {
+    l3_ = std::make_unique<L3OrderStore>(max_orders);
+    l3_->reserve(l3_reserve_);
+  }
+}
+
+void OrderBook::reserve_l3(size_t orders) {
+  l3_reserve_ = orders;
+  if (l3_)
+    l3_->reserve(orders);
+}
+
+bool OrderBook::add_l3_order(uint64_t order_id, double price, double quantity,
+                             Side side, uint64_t timestamp) {
+  return add_l3_order_ticks(order_id, codec_.price_to_ticks(price), quantity,
+                            side, timestamp);
+}
+
+bool OrderBook::add_l3_order_ticks(uint64_t order_id, int64_t price_ticks,
+                                   double quantity, Side side,
+                                   uint64_t timestamp) {
+  if (!l3_ || quantity < 1e-8)
+    return false;
 
   if (side == Side::BID) {
-    auto it = bids_.find(price);
-    if (it != bids_.end()) {
-      return it->second.orders;
+    return add_l3<Side::BID>(order_id, price_ticks, quantity, timestamp);
+  }
+  return add_l3<Side::ASK>(order_id, price_ticks, quantity, timestamp);
+}
+
+bool OrderBook::modify_l3_order(uint64_t order_id, double quantity,
+                                uint64_t timestamp) {
+  const L3Order *order = find_l3_order(order_id);
+  if (!order)
+    return false;
+  return modify_l3_order_ticks(order_id, order->price_ticks, quantity,
+                               timestamp);
+}
+
+bool OrderBook::modify_l3_order_ticks(uint64_t order_id, int64_t price_ticks,
+                                      double quantity, uint64_t timestamp) {
+  if (!l3_)
+    return false;
+
+  uint32_t slot = l3_->find(order_id);
+  if (slot == kNullOrderSlot)
+    return false;
+
+  const L3Order &order = (*l3_)[slot];
+  Side side = order.side;
+
+  // Modify to zero is a cancel
+  if (quantity < 1e-8) {
+    return cancel_l3_order(order_id);
+  }
+
+  // Same price, smaller size: shrink in place, keep queue priority
+  if (price_ticks == order.price_ticks && quantity <= order.quantity) {
+    l3_->reduce(slot, quantity);
+    if (side == Side::BID) {
+      bids_.refresh_touch(top_);
+    } else {
+      asks_.refresh_touch(top_);
     }
+    return true;
+  }
+
+  // Priority lost: re-queue at the back (possibly at a new price)
+  if (side == Side::BID) {
+    remove_l3<Side::BID>(slot);
+    return add_l3<Side::BID>(order_id, price_ticks, quantity, timestamp);
+  }
+  remove_l3<Side::ASK>(slot);
+  return add_l3<Side::ASK>(order_id, price_ticks, quantity, timestamp);
+}
+
+bool OrderBook::cancel_l3_order(uint64_t order_id) {
+  if (!l3_)
+    return false;
+
+  uint32_t slot = l3_->find(order_id);
+  if (slot == kNullOrderSlot)
+    return false;
+
+  if ((*l3_)[slot].side == Side::BID) {
+    remove_l3<Side::BID>(slot);
   } else {
-    auto it = asks_.find(price);
-    if (it != asks_.end()) {
-      return it->second.orders;
-    }
+    remove_l3<Side::ASK>(slot);
   }
+  return true;
+}
+
+const L3Order *OrderBook::find_l3_order(uint64_t order_id) const {
+  if (!l3_)
+    return nullptr;
+
+  uint32_t slot = l3_->find(order_id);
+  return slot != kNullOrderSlot ? &(*l3_)[slot] : nullptr;
+}
+
+L3QueueView OrderBook::get_l3_queue(double price, Side side) const {
+  if (!l3_)
+    return L3QueueView();
+
+  int64_t price_ticks = codec_.price_to_ticks(price);
+  const Limit *limit =
+      (side == Side::BID) ? bids_.find(price_ticks) : asks_.find(price_ticks);
+  return limit ? l3_->queue(*limit) : L3QueueView();
+}
+
+std::deque<Order> OrderBook::get_orders_at_price(double price,
+                                                 Side side) const {
+  OrderQueueView queue = get_order_queue(price, side);
+  return std::deque<Order>(queue.begin(), queue.end());
+}
 
-  return empty_deque;
+OrderQueueView OrderBook::get_order_queue(double price, Side side) const {
+  int64_t price_ticks = codec_.price_to_ticks(price);
+  const Limit *limit =
+      (side == Side::BID) ? bids_.find(price_ticks) : asks_.find(price_ticks);
+  return limit ? OrderQueueView(&limit->orders) : OrderQueueView();
 }
 
 } // namespace lob
@@ -1,16 +1,33 @@
 #pragma once
 
+#include "BookState.h"
+#include "HalfBook.h"
+#include "Instrument.h"
+#include "L3OrderStore.h"
+#include "LevelView.h"
 #include "Order.h"
-#include <map>
+#include <cassert>
+#include <cmath>
+#include <deque>
 #include <memory>
 #include <optional>
+#include <type_traits>
 #include <vector>
 
 namespace lob {
 
 class OrderBook {
 public:
+  using BidBook = HalfBook<Side::BID>;
+  using AskBook = HalfBook<Side::ASK>;
+  using BidLevels = LevelRange<BidBook::const_iterator>;
+  using AskLevels = LevelRange<AskBook::const_iterator>;
+
+  using Codec = PriceCodec<DynamicInstrument>;
+
+  // Instrument spec is looked up from the registry by symbol
   OrderBook(const std::string &symbol);
+  OrderBook(const std::string &symbol, const InstrumentSpec &spec);
   ~OrderBook() = default;
 
   // Core operations (Binance L2 semantics: replace, not add)
@@ -19,7 +36,75 @@ public:
   void update_order(double price, double quantity, Side side,
                     uint64_t timestamp);
 
+  // Side-specialized variants: callers that know the side statically
+  // (or dispatch once per batch) skip the runtime side branch entirely.
+  // Policy selects the L3 decrease-allocation model (QueuePolicy.h).
+  template <Side S, typename Policy = FifoPolicy>
+  void update(double price, double quantity, uint64_t timestamp);
+  template <Side S, typename Policy = FifoPolicy>
+  void add(double price, double quantity, uint64_t timestamp);
+  template <Side S> void clear_level(double price);
+
+  // Tick-native entry points: prices already on this book's tick grid
+  // (e.g. produced by a PriceCodec specialized on the same instrument)
+  // skip the double -> tick conversion. Instrument names the grid for the
+  // tick -> price conversion of new levels: a StaticInstrument (which must
+  // match the book's spec) constant-folds it, DynamicInstrument uses the
+  // book's runtime codec.
+  template <typename Policy = FifoPolicy,
+            typename Instrument = DynamicInstrument>
+  void update_order_ticks(int64_t price_ticks, double quantity, Side side,
+                          uint64_t timestamp);
+  template <Side S, typename Policy = FifoPolicy,
+            typename Instrument = DynamicInstrument>
+  void update_ticks(int64_t price_ticks, double quantity, uint64_t timestamp);
+
+  // Apply a run of same-side L2 updates sharing one timestamp. The touch
+  // is refreshed and integrity checked once at the end of the batch.
+  template <Side S, typename Policy = FifoPolicy>
+  void update_batch(const double *prices, const double *quantities,
+                    size_t count, uint64_t timestamp);
+  template <Side S, typename Policy = FifoPolicy,
+            typename Instrument = DynamicInstrument>
+  void update_batch(const int64_t *price_ticks, const double *quantities,
+                    size_t count, uint64_t timestamp);
+
+  // True L3 (market-by-order) mode: orders tracked by exchange id in a
+  // bounded pool + open-addressing index, queued FIFO per level. Add is
+  // O(log levels) for the level lookup; cancel and modify are O(1) apart
+  // from erasing a level that becomes empty. Depth, touch and imbalance
+  // queries work unchanged. Do not mix with L2 updates on the same book.
+  void enable_l3(size_t max_orders = L3OrderStore::kDefaultMaxOrders);
+  bool l3_enabled() const { return l3_ != nullptr; }
+
+  // Expected live L3 orders: the store is presized for this many when L3
+  // mode is (or already was) enabled, instead of growing during replay
+  void reserve_l3(size_t orders);
+
+  // Each returns false if the order is rejected (unknown/duplicate id,
+  // pool exhausted, L3 mode not enabled)
+  bool add_l3_order(uint64_t order_id, double price, double quantity,
+                    Side side, uint64_t timestamp);
+  bool add_l3_order_ticks(uint64_t order_id, int64_t price_ticks,
+                          double quantity, Side side, uint64_t timestamp);
+  // Quantity decrease at the same price keeps queue priority; a price
+  // change or quantity increase re-queues the order at the back.
+  bool modify_l3_order(uint64_t order_id, double quantity, uint64_t timestamp);
+  bool modify_l3_order_ticks(uint64_t order_id, int64_t price_ticks,
+                             double quantity, uint64_t timestamp);
+  bool cancel_l3_order(uint64_t order_id);
+
+  const L3Order *find_l3_order(uint64_t order_id) const;
+  L3QueueView get_l3_queue(double price, Side side) const;
+  size_t get_l3_order_count() const { return l3_ ? l3_->size() : 0; }
+
+  // Direct access to one side of the book
+  template <Side S> const HalfBook<S> &half() const;
+
   // Query operations
+  // O(1) touch snapshot, maintained on every book change
+  TopOfBook get_top_of_book() const { return top_; }
+
   std::optional<double> get_best_bid() const;
   std::optional<double> get_best_ask() const;
   std::optional<double> get_mid_price() const;
@@ -33,8 +118,31 @@ public:
   std::vector<std::pair<double, double>> get_bid_depth(size_t n) const;
   std::vector<std::pair<double, double>> get_ask_depth(size_t n) const;
 
-  // L3 data access
-  const std::deque<Order> &get_orders_at_price(double price, Side side) const;
+  // Allocation-free depth: fill caller-owned buffer, return levels written
+  size_t get_bid_depth(LevelInfo *out, size_t capacity) const;
+  size_t get_ask_depth(LevelInfo *out, size_t capacity) const;
+
+  template <size_t N> size_t get_bid_depth(DepthArray<N> &out) const {
+    out.count = get_bid_depth(out.levels.data(), N);
+    return out.count;
+  }
+  template <size_t N> size_t get_ask_depth(DepthArray<N> &out) const {
+    out.count = get_ask_depth(out.levels.data(), N);
+    return out.count;
+  }
+
+  // Lightweight level iteration (best first, at most n levels)
+  BidLevels bid_levels(size_t n = kAllLevels) const {
+    return bids_.levels(n);
+  }
+  AskLevels ask_levels(size_t n = kAllLevels) const {
+    return asks_.levels(n);
+  }
+
+  // L3 data access: get_orders_at_price copies the queue out, the view
+  // reads it in place
+  std::deque<Order> get_orders_at_price(double price, Side side) const;
+  OrderQueueView get_order_queue(double price, Side side) const;
 
   // Market microstructure metrics
   double calculate_imbalance(size_t depth = 5) const;
@@ -44,22 +152,225 @@ public:
   // Utility
   void clear();
   void reset_order_ids() { next_order_id_ = 1; }
+
+  // Checkpoint/restore of the whole book (see BookState). Restoring into a
+  // book of the same instrument reproduces this one exactly, so later
+  // updates are allocated across the queues just as they would have been.
+  void save_state(BookState &state) const;
+  void restore_state(const BookState &state);
   std::string get_symbol() const { return symbol_; }
+  const InstrumentSpec &instrument() const { return codec_.spec(); }
+  const Codec &codec() const { return codec_; }
 
 private:
   std::string symbol_;
 
+  // Price/quantity grid of the instrument (book levels are keyed by ticks)
+  Codec codec_;
+
   // Order ID counter for synthetic L3 orders
   uint64_t next_order_id_;
 
   // Bid book: sorted descending (highest price first)
-  std::map<double, Limit, std::greater<double>> bids_;
+  BidBook bids_;
 
   // Ask book: sorted ascending (lowest price first)
-  std::map<double, Limit, std::less<double>> asks_;
+  AskBook asks_;
+
+  // Cached touch (refreshed by whichever side changed)
+  TopOfBook top_;
+
+  // True L3 order storage (null until enable_l3)
+  std::unique_ptr<L3OrderStore> l3_;
+  size_t l3_reserve_;
+
+  template <Side S> HalfBook<S> &half_mut();
+  template <typename Instrument> double tick_price(int64_t price_ticks) const;
+  template <Side S, typename Policy, typename Instrument = DynamicInstrument>
+  void apply_level(int64_t price_ticks, double quantity, uint64_t timestamp);
+  template <Side S> void erase_level(int64_t price_ticks);
+  template <Side S>
+  bool add_l3(uint64_t order_id, int64_t price_ticks, double quantity,
+              uint64_t timestamp);
+  template <Side S> void remove_l3(uint32_t slot);
 
   // Validation
   void validate_book_integrity() const;
 };
 
+// ---------------------------------------------------------------------------
+// Side-specialized operations
+// ---------------------------------------------------------------------------
+
+template <Side S> const HalfBook<S> &OrderBook::half() const {
+  if constexpr (S == Side::BID) {
+    return bids_;
+  } else {
+    return asks_;
+  }
+}
+
+template <Side S> HalfBook<S> &OrderBook::half_mut() {
+  if constexpr (S == Side::BID) {
+    return bids_;
+  } else {
+    return asks_;
+  }
+}
+
+template <typename Instrument>
+double OrderBook::tick_price(int64_t price_ticks) const {
+  if constexpr (std::is_same_v<Instrument, DynamicInstrument>) {
+    return codec_.ticks_to_price(price_ticks);
+  } else {
+    assert(Instrument::spec() == codec_.spec());
+    return PriceCodec<Instrument>().ticks_to_price(price_ticks);
+  }
+}
+
+template <Side S, typename Policy, typename Instrument>
+void OrderBook::apply_level(int64_t price_ticks, double quantity,
+                            uint64_t timestamp) {
+  // HYBRID L2/L3 SEMANTICS:
+  // L2 input: absolute volume at price level
+  // L3 simulation: maintain deque of synthetic orders
+  // Delta calculation: new_qty - old_qty determines add/remove
+  half_mut<S>().template apply<Policy>(price_ticks,
+                                       tick_price<Instrument>(price_ticks),
+                                       quantity, timestamp, next_order_id_);
+}
+
+template <typename Policy, typename Instrument>
+void OrderBook::update_order_ticks(int64_t price_ticks, double quantity,
+                                   Side side, uint64_t timestamp) {
+  if (side == Side::BID) {
+    update_ticks<Side::BID, Policy, Instrument>(price_ticks, quantity,
+                                                timestamp);
+  } else {
+    update_ticks<Side::ASK, Policy, Instrument>(price_ticks, quantity,
+                                                timestamp);
+  }
+}
+
+template <Side S> void OrderBook::erase_level(int64_t price_ticks) {
+  HalfBook<S> &book = half_mut<S>();
+  if (l3_) {
+    // Return any true L3 orders at this level to the pool first
+    if (Limit *limit = book.find(price_ticks)) {
+      l3_->release_level(*limit);
+    }
+  }
+  book.erase(price_ticks);
+}
+
+template <Side S>
+bool OrderBook::add_l3(uint64_t order_id, int64_t price_ticks,
+                       double quantity, uint64_t timestamp) {
+  HalfBook<S> &book = half_mut<S>();
+  Limit &limit = book.level(price_ticks, codec_.ticks_to_price(price_ticks));
+
+  uint32_t slot =
+      l3_->insert(order_id, price_ticks, quantity, S, timestamp, limit);
+  if (slot == kNullOrderSlot) {
+    if (limit.order_count == 0)
+      book.erase(price_ticks);
+    return false;
+  }
+
+  book.refresh_touch(top_);
+  validate_book_integrity();
+  return true;
+}
+
+template <Side S> void OrderBook::remove_l3(uint32_t slot) {
+  HalfBook<S> &book = half_mut<S>();
+  const L3Order &order = (*l3_)[slot];
+  int64_t price_ticks = order.price_ticks;
+  const Limit *limit = order.level;
+
+  l3_->remove(slot);
+  if (limit->order_count == 0)
+    book.erase(price_ticks);
+  book.refresh_touch(top_);
+}
+
+template <Side S, typename Policy>
+void OrderBook::add(double price, double quantity, uint64_t timestamp) {
+  apply_level<S, Policy>(codec_.price_to_ticks(price), quantity, timestamp);
+  half<S>().refresh_touch(top_);
+}
+
+template <Side S> void OrderBook::clear_level(double price) {
+  erase_level<S>(codec_.price_to_ticks(price));
+  half<S>().refresh_touch(top_);
+}
+
+template <Side S, typename Policy>
+void OrderBook::update(double price, double quantity, uint64_t timestamp) {
+  update_ticks<S, Policy>(codec_.price_to_ticks(price), quantity, timestamp);
+}
+
+template <Side S, typename Policy, typename Instrument>
+void OrderBook::update_ticks(int64_t price_ticks, double quantity,
+                             uint64_t timestamp) {
+  // BINANCE L2 UPDATE SEMANTICS:
+  // - quantity == 0: Remove price level immediately
+  // - quantity > 0: Replace volume at this price level (delta-based L3
+  // simulation)
+  HalfBook<S> &book = half_mut<S>();
+
+  // Zero quantity: remove the level immediately
+  if (quantity == 0.0 || std::abs(quantity) < 1e-8) {
+    erase_level<S>(price_ticks);
+    book.refresh_touch(top_);
+    return;
+  }
+
+  // Non-zero quantity: use delta-based add (Hybrid L2/L3)
+  apply_level<S, Policy, Instrument>(price_ticks, quantity, timestamp);
+  book.refresh_touch(top_);
+
+  // Validate book integrity after update
+  validate_book_integrity();
+}
+
+template <Side S, typename Policy, typename Instrument>
+void OrderBook::update_batch(const int64_t *price_ticks,
+                             const double *quantities, size_t count,
+                             uint64_t timestamp) {
+  HalfBook<S> &book = half_mut<S>();
+
+  for (size_t i = 0; i < count; ++i) {
+    if (quantities[i] == 0.0 || std::abs(quantities[i]) < 1e-8) {
+      erase_level<S>(price_ticks[i]);
+    } else {
+      apply_level<S, Policy, Instrument>(price_ticks[i], quantities[i],
+                                         timestamp);
+    }
+  }
+
+  book.refresh_touch(top_);
+  validate_book_integrity();
+  LOB_PROBE4(batch_applied, S, count, timestamp, book.size());
+}
+
+template <Side S, typename Policy>
+void OrderBook::update_batch(const double *prices, const double *quantities,
+                             size_t count, uint64_t timestamp) {
+  HalfBook<S> &book = half_mut<S>();
+
+  for (size_t i = 0; i < count; ++i) {
+    int64_t price_ticks = codec_.price_to_ticks(prices[i]);
+    if (quantities[i] == 0.0 || std::abs(quantities[i]) < 1e-8) {
+      erase_level<S>(price_ticks);
+    } else {
+      apply_level<S, Policy>(price_ticks, quantities[i], timestamp);
+    }
+  }
+
+  book.refresh_touch(top_);
+  validate_book_integrity();
+  LOB_PROBE4(batch_applied, S, count, timestamp, book.size());
+}
+
 } // namespace lob
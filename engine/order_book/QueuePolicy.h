@@ -0,0 +1,165 @@
+#pragma once
+
+#include "Order.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace lob {
+
+// Compile-time models for how an L2 volume decrease is allocated across the
+// synthetic L3 queue at a level. The book's update paths take the policy as
+// a template argument (FifoPolicy by default), so the chosen model is
+// inlined with no runtime dispatch.
+//
+// A policy is a type with:
+//   static constexpr const char *name;
+//   static double reduce(Limit &limit, double qty, const DecreaseContext &);
+// returning the volume actually removed. Implementations must keep
+// total_volume/order_count consistent (Limit::validate_invariants).
+
+// What the book knows about a decrease when it happens
+struct DecreaseContext {
+  bool at_touch;      // Level is the best bid/ask
+  uint64_t timestamp; // Update timestamp
+};
+
+namespace detail {
+
+// Drop orders that were reduced to (numerically) nothing and resync counts
+inline void compact_queue(Limit &limit) {
+  limit.orders.remove_drained(1e-8);
+  limit.order_count = static_cast<uint32_t>(limit.orders.size());
+  if (limit.orders.empty())
+    limit.total_volume = 0.0;
+}
+
+} // namespace detail
+
+// Every decrease is a trade/cancel at the front of the queue (default)
+struct FifoPolicy {
+  static constexpr const char *name = "fifo";
+
+  static double reduce(Limit &limit, double qty, const DecreaseContext &) {
+    return limit.reduce_volume_fifo(qty);
+  }
+};
+
+// Every decrease is a cancel of the most recently added volume
+struct LifoCancelPolicy {
+  static constexpr const char *name = "lifo";
+
+  static double reduce(Limit &limit, double qty, const DecreaseContext &) {
+    double removed = 0.0;
+
+    while (qty > 1e-8 && !limit.orders.empty()) {
+      double &back = limit.orders.quantities()[limit.orders.size() - 1];
+
+      if (back <= qty) {
+        removed += back;
+        qty -= back;
+        limit.orders.pop_back();
+      } else {
+        back -= qty;
+        removed += qty;
+        qty = 0.0;
+      }
+    }
+
+    limit.total_volume -= removed;
+    limit.order_count = static_cast<uint32_t>(limit.orders.size());
+    return removed;
+  }
+};
+
+// Every resting order shrinks by the same fraction of its size
+struct ProRataPolicy {
+  static constexpr const char *name = "prorata";
+
+  static double reduce(Limit &limit, double qty, const DecreaseContext &) {
+    if (limit.total_volume <= 1e-12)
+      return 0.0;
+
+    double removed = std::min(qty, limit.total_volume);
+    double keep = 1.0 - removed / limit.total_volume;
+
+    double *q = limit.orders.quantities();
+    for (size_t i = 0, n = limit.orders.size(); i < n; ++i) {
+      q[i] *= keep;
+    }
+
+    limit.total_volume -= removed;
+    detail::compact_queue(limit);
+    return removed;
+  }
+};
+
+// Decrease allocated in proportion to squared order size: large resting
+// orders (more likely to be cancelled/re-priced) absorb most of it, small
+// orders are nearly untouched. Orders that would go negative are removed
+// and the remainder is redistributed.
+struct SizeWeightedPolicy {
+  static constexpr const char *name = "size";
+
+  static double reduce(Limit &limit, double qty, const DecreaseContext &) {
+    double removed = 0.0;
+    qty = std::min(qty, limit.total_volume);
+
+    while (qty > 1e-8 && !limit.orders.empty()) {
+      double *q = limit.orders.quantities();
+      size_t n = limit.orders.size();
+
+      double weight_sum = 0.0;
+      for (size_t i = 0; i < n; ++i) {
+        weight_sum += q[i] * q[i];
+      }
+      if (weight_sum <= 1e-16)
+        break;
+
+      double allocated = 0.0;
+      for (size_t i = 0; i < n; ++i) {
+        double share = qty * (q[i] * q[i]) / weight_sum;
+        double take = std::min(share, q[i]);
+        q[i] -= take;
+        allocated += take;
+      }
+
+      removed += allocated;
+      qty -= allocated;
+      detail::compact_queue(limit);
+    }
+
+    limit.total_volume =
+        limit.orders.empty() ? 0.0 : limit.total_volume - removed;
+    limit.order_count = static_cast<uint32_t>(limit.orders.size());
+    return removed;
+  }
+};
+
+// Heuristic mix: at the touch a decrease is most likely a trade (FIFO);
+// deeper in the book it is a cancel - of an order whose size matches
+// exactly if there is one, otherwise of the newest volume (LIFO).
+struct MixedTradeCancelPolicy {
+  static constexpr const char *name = "mixed";
+
+  static double reduce(Limit &limit, double qty,
+                       const DecreaseContext &context) {
+    if (context.at_touch) {
+      return FifoPolicy::reduce(limit, qty, context);
+    }
+
+    for (size_t i = limit.orders.size(); i-- > 0;) {
+      if (std::abs(limit.orders.quantity(i) - qty) <= 1e-8) {
+        double removed = limit.orders.quantity(i);
+        limit.orders.erase(i);
+        limit.total_volume -= removed;
+        limit.order_count = static_cast<uint32_t>(limit.orders.size());
+        return removed;
+      }
+    }
+
+    return LifoCancelPolicy::reduce(limit, qty, context);
+  }
+};
+
+} // namespace lob
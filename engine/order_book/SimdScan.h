@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstddef>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace lob {
+
+// Result of a FIFO prefix scan over a queue's quantities
+struct PrefixCut {
+  size_t count;    // Leading entries whose running sum stays <= limit
+  double consumed; // Running sum of those entries
+};
+
+// Find how many leading quantities can be consumed whole by `limit`.
+// Quantities are non-negative, so the running sum is monotonic and the scan
+// stops at the first block containing the cut. Vector blocks compute an
+// in-register prefix sum, add the carry from the previous block and compare
+// all lanes at once.
+inline PrefixCut prefix_cut(const double *q, size_t n, double limit) {
+  size_t i = 0;
+  double carry = 0.0;
+
+#if defined(__AVX2__)
+  const __m256d zero = _mm256_setzero_pd();
+  const __m256d bound = _mm256_set1_pd(limit);
+  __m256d run = zero;
+
+  for (; i + 4 <= n; i += 4) {
+    __m256d x = _mm256_loadu_pd(q + i);
+    // [a b c d] -> [a a+b b+c c+d] -> [a a+b a+b+c a+b+c+d]
+    x = _mm256_add_pd(
+        x, _mm256_blend_pd(_mm256_permute4x64_pd(x, 0x90), zero, 0x1));
+    x = _mm256_add_pd(
+        x, _mm256_blend_pd(_mm256_permute4x64_pd(x, 0x40), zero, 0x3));
+    x = _mm256_add_pd(x, run);
+
+    int fits = _mm256_movemask_pd(_mm256_cmp_pd(x, bound, _CMP_LE_OQ));
+    if (fits != 0xF) {
+      int lanes = __builtin_ctz(~fits);
+      double sums[4];
+      _mm256_storeu_pd(sums, x);
+      carry = lanes > 0 ? sums[lanes - 1] : _mm256_cvtsd_f64(run);
+      return PrefixCut{i + lanes, carry};
+    }
+    run = _mm256_permute4x64_pd(x, 0xFF); // Broadcast the block total
+  }
+  carry = _mm256_cvtsd_f64(run);
+#elif defined(__SSE2__)
+  const __m128d bound = _mm_set1_pd(limit);
+  __m128d run = _mm_setzero_pd();
+
+  for (; i + 2 <= n; i += 2) {
+    __m128d x = _mm_loadu_pd(q + i);
+    // [a b] -> [a a+b]
+    x = _mm_add_pd(x, _mm_unpacklo_pd(_mm_setzero_pd(), x));
+    x = _mm_add_pd(x, run);
+
+    int fits = _mm_movemask_pd(_mm_cmple_pd(x, bound));
+    if (fits != 0x3) {
+      if (fits & 0x1)
+        return PrefixCut{i + 1, _mm_cvtsd_f64(x)};
+      return PrefixCut{i, _mm_cvtsd_f64(run)};
+    }
+    run = _mm_unpackhi_pd(x, x);
+  }
+  carry = _mm_cvtsd_f64(run);
+#endif
+
+  for (; i < n; ++i) {
+    double next = carry + q[i];
+    if (next > limit)
+      break;
+    carry = next;
+  }
+  return PrefixCut{i, carry};
+}
+
+} // namespace lob
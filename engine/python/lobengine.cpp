@@ -0,0 +1,599 @@
+// lobengine: CPython extension driving the C++ replay from Python.
+//
+//   import lobengine, numpy as np
+//   replay = lobengine.Replay("data/x.events", depth=10, strategy="imbalance")
+//   replay.step(1000)                 # apply up to 1000 events
+//   book = np.asarray(replay.depth)   # (depth, 4) view, updated in place
+//   replay.run()                      # replay to the end
+//   series = {k: np.asarray(v) for k, v in replay.metrics().items()}
+//
+// Every array is exported through the buffer protocol over memory owned by
+// the Replay object, so numpy.asarray/frombuffer never copies. The depth
+// and feature buffers are fixed; recorded series may grow, so the replay
+// refuses to reallocate them while views are alive (BufferError, as with
+// bytearray).
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include "../features/BookFeatures.h"
+#include "../io/EventApply.h"
+#include "../io/EventReader.h"
+#include "../order_book/OrderBook.h"
+#include "../strategy/Strategy.h"
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+using namespace lob;
+
+// Depth buffer columns, one row per level (best first)
+constexpr int kDepthColumns = 4; // bid_price, bid_size, ask_price, ask_size
+
+// Current feature vector
+enum FeatureIndex {
+  F_MID,
+  F_SPREAD,
+  F_MICROPRICE,
+  F_IMBALANCE,
+  F_OFI,
+  F_OFI_TOTAL,
+  kFeatureCount
+};
+const char *const kFeatureNames[kFeatureCount] = {
+    "mid", "spread", "microprice", "imbalance", "ofi", "ofi_total"};
+
+// Recorded series: two timestamp columns (uint64) then double columns
+enum TimestampColumn { T_EXCHANGE_TS, T_LOCAL_TS, kTimestampColumns };
+const char *const kTimestampNames[kTimestampColumns] = {"exchange_ts",
+                                                        "local_ts"};
+
+enum SeriesColumn {
+  S_MID,
+  S_SPREAD,
+  S_MICROPRICE,
+  S_IMBALANCE,
+  S_OFI,
+  S_BID_PRICE,
+  S_BID_SIZE,
+  S_ASK_PRICE,
+  S_ASK_SIZE,
+  S_POSITION,
+  S_PNL,
+  kSeriesColumns
+};
+const char *const kSeriesNames[kSeriesColumns] = {
+    "mid",      "spread",   "microprice", "imbalance", "ofi",     "bid_price",
+    "bid_size", "ask_price", "ask_size",  "position",  "pnl"};
+
+struct ReplayState {
+  OrderBook book;
+  EventReader reader;
+  FeatureTracker tracker;
+  ApplyEventFn apply;
+  std::unique_ptr<Strategy> strategy;
+  uint64_t eval_every;
+  uint64_t record_every;
+  uint64_t events_processed;
+
+  std::vector<double> depth; // depth rows x kDepthColumns
+  std::vector<LevelInfo> level_scratch;
+  std::array<double, kFeatureCount> features;
+
+  std::array<std::vector<uint64_t>, kTimestampColumns> timestamps;
+  std::array<std::vector<double>, kSeriesColumns> series;
+  Py_ssize_t exports; // Live buffer views on the recorded series
+
+  ReplayState(const std::string &path, const std::string &symbol,
+              size_t depth_levels, size_t imbalance_depth)
+      : book(symbol), reader(path, DynamicInstrument(instrument_for(symbol))),
+        tracker(imbalance_depth), apply(nullptr), eval_every(10),
+        record_every(1), events_processed(0),
+        depth(depth_levels * kDepthColumns, 0.0),
+        level_scratch(depth_levels), features(), exports(0) {}
+
+  size_t depth_levels() const { return level_scratch.size(); }
+  size_t recorded() const { return timestamps[T_EXCHANGE_TS].size(); }
+
+  // Appending would move the series while numpy views point into them
+  bool would_reallocate() const {
+    const auto &column = timestamps[T_EXCHANGE_TS];
+    return column.size() == column.capacity();
+  }
+
+  void record(const Event &event, const BookFeatures &f) {
+    timestamps[T_EXCHANGE_TS].push_back(event.exchange_ts);
+    timestamps[T_LOCAL_TS].push_back(event.local_ts);
+    series[S_MID].push_back(f.mid);
+    series[S_SPREAD].push_back(f.spread);
+    series[S_MICROPRICE].push_back(f.microprice);
+    series[S_IMBALANCE].push_back(f.imbalance);
+    series[S_OFI].push_back(f.ofi);
+    series[S_BID_PRICE].push_back(f.bid_price);
+    series[S_BID_SIZE].push_back(f.bid_size);
+    series[S_ASK_PRICE].push_back(f.ask_price);
+    series[S_ASK_SIZE].push_back(f.ask_size);
+    series[S_POSITION].push_back(strategy ? strategy->get_position() : 0.0);
+    series[S_PNL].push_back(strategy ? strategy->get_pnl() : 0.0);
+  }
+
+  // Same trading rule as the engine's replay loop
+  void evaluate_strategy(const Event &event) {
+    int signal = strategy->evaluate(book, event.local_ts);
+    if (signal == 0)
+      return;
+
+    TopOfBook top = book.get_top_of_book();
+    if (top.valid())
+      strategy->update_position(signal * 0.01, top.mid);
+  }
+
+  // Refresh the fixed depth/feature buffers exposed to Python
+  void publish() {
+    size_t levels = depth_levels();
+    std::fill(depth.begin(), depth.end(), 0.0);
+
+    size_t bids = book.get_bid_depth(level_scratch.data(), levels);
+    for (size_t i = 0; i < bids; ++i) {
+      depth[i * kDepthColumns + 0] = level_scratch[i].price;
+      depth[i * kDepthColumns + 1] = level_scratch[i].volume;
+    }
+    size_t asks = book.get_ask_depth(level_scratch.data(), levels);
+    for (size_t i = 0; i < asks; ++i) {
+      depth[i * kDepthColumns + 2] = level_scratch[i].price;
+      depth[i * kDepthColumns + 3] = level_scratch[i].volume;
+    }
+
+    const BookFeatures &f = tracker.features();
+    features[F_MID] = f.mid;
+    features[F_SPREAD] = f.spread;
+    features[F_MICROPRICE] = f.microprice;
+    features[F_IMBALANCE] = f.imbalance;
+    features[F_OFI] = f.ofi;
+    features[F_OFI_TOTAL] = f.ofi_total;
+  }
+};
+
+// ---------------------------------------------------------------------------
+// ArrayRef: buffer exporter for one engine-owned array
+// ---------------------------------------------------------------------------
+
+enum class ArrayKind { DEPTH, FEATURES, TIMESTAMP, SERIES };
+
+struct ReplayObject {
+  PyObject_HEAD ReplayState *state;
+};
+
+struct ArrayRefObject {
+  PyObject_HEAD ReplayObject *owner; // Strong reference
+  ArrayKind kind;
+  int column;
+  Py_ssize_t shape[2];
+  Py_ssize_t strides[2];
+};
+
+int ArrayRef_getbuffer(PyObject *self, Py_buffer *view, int flags) {
+  auto *ref = reinterpret_cast<ArrayRefObject *>(self);
+  ReplayState *state = ref->owner->state;
+
+  if ((flags & PyBUF_WRITABLE) == PyBUF_WRITABLE) {
+    PyErr_SetString(PyExc_BufferError, "engine arrays are read-only");
+    return -1;
+  }
+
+  void *data = nullptr;
+  int ndim = 1;
+  Py_ssize_t itemsize = sizeof(double);
+  const char *format = "d";
+
+  switch (ref->kind) {
+  case ArrayKind::DEPTH:
+    data = state->depth.data();
+    ndim = 2;
+    ref->shape[0] = static_cast<Py_ssize_t>(state->depth_levels());
+    ref->shape[1] = kDepthColumns;
+    break;
+  case ArrayKind::FEATURES:
+    data = state->features.data();
+    ref->shape[0] = kFeatureCount;
+    break;
+  case ArrayKind::TIMESTAMP:
+    data = state->timestamps[ref->column].data();
+    ref->shape[0] = static_cast<Py_ssize_t>(state->recorded());
+    itemsize = sizeof(uint64_t);
+    format = "Q";
+    break;
+  case ArrayKind::SERIES:
+    data = state->series[ref->column].data();
+    ref->shape[0] = static_cast<Py_ssize_t>(state->recorded());
+    break;
+  }
+
+  ref->strides[ndim - 1] = itemsize;
+  if (ndim == 2)
+    ref->strides[0] = ref->shape[1] * itemsize;
+
+  view->buf = data;
+  view->obj = self;
+  Py_INCREF(self);
+  view->len = itemsize * ref->shape[0] * (ndim == 2 ? ref->shape[1] : 1);
+  view->readonly = 1;
+  view->itemsize = itemsize;
+  view->format =
+      (flags & PyBUF_FORMAT) ? const_cast<char *>(format) : nullptr;
+  view->ndim = ndim;
+  view->shape = (flags & PyBUF_ND) ? ref->shape : nullptr;
+  view->strides = (flags & PyBUF_STRIDES) == PyBUF_STRIDES ? ref->strides
+                                                           : nullptr;
+  view->suboffsets = nullptr;
+  view->internal = nullptr;
+
+  if (ref->kind == ArrayKind::TIMESTAMP || ref->kind == ArrayKind::SERIES)
+    state->exports++;
+  return 0;
+}
+
+void ArrayRef_releasebuffer(PyObject *self, Py_buffer *) {
+  auto *ref = reinterpret_cast<ArrayRefObject *>(self);
+  if (ref->kind == ArrayKind::TIMESTAMP || ref->kind == ArrayKind::SERIES)
+    ref->owner->state->exports--;
+}
+
+void ArrayRef_dealloc(PyObject *self) {
+  auto *ref = reinterpret_cast<ArrayRefObject *>(self);
+  Py_XDECREF(ref->owner);
+  Py_TYPE(self)->tp_free(self);
+}
+
+PyBufferProcs ArrayRef_as_buffer = {ArrayRef_getbuffer,
+                                    ArrayRef_releasebuffer};
+
+PyTypeObject ArrayRefType = {PyVarObject_HEAD_INIT(nullptr, 0)};
+
+// memoryview over one engine array (numpy.asarray wraps it without a copy)
+PyObject *export_array(ReplayObject *owner, ArrayKind kind, int column) {
+  auto *ref = PyObject_New(ArrayRefObject, &ArrayRefType);
+  if (!ref)
+    return nullptr;
+  Py_INCREF(owner);
+  ref->owner = owner;
+  ref->kind = kind;
+  ref->column = column;
+
+  PyObject *view = PyMemoryView_FromObject(reinterpret_cast<PyObject *>(ref));
+  Py_DECREF(ref);
+  return view;
+}
+
+// ---------------------------------------------------------------------------
+// Replay
+// ---------------------------------------------------------------------------
+
+void Replay_dealloc(PyObject *self) {
+  auto *replay = reinterpret_cast<ReplayObject *>(self);
+  delete replay->state;
+  Py_TYPE(self)->tp_free(self);
+}
+
+PyObject *Replay_new(PyTypeObject *type, PyObject *, PyObject *) {
+  auto *replay = reinterpret_cast<ReplayObject *>(type->tp_alloc(type, 0));
+  if (replay)
+    replay->state = nullptr;
+  return reinterpret_cast<PyObject *>(replay);
+}
+
+int Replay_init(PyObject *self, PyObject *args, PyObject *kwargs) {
+  static const char *keywords[] = {"path",       "symbol",
+                                   "depth",      "queue_model",
+                                   "imbalance_depth", "strategy",
+                                   "eval_every", "record_every",
+                                   nullptr};
+  const char *path = nullptr;
+  const char *symbol = "BTCUSDT";
+  Py_ssize_t depth = 10;
+  const char *queue_model = FifoPolicy::name;
+  Py_ssize_t imbalance_depth = 5;
+  const char *strategy = nullptr;
+  Py_ssize_t eval_every = 10;
+  Py_ssize_t record_every = 1;
+
+  if (!PyArg_ParseTupleAndKeywords(
+          args, kwargs, "s|snsnznn", const_cast<char **>(keywords), &path,
+          &symbol, &depth, &queue_model, &imbalance_depth, &strategy,
+          &eval_every, &record_every))
+    return -1;
+
+  if (depth < 1 || imbalance_depth < 1 || eval_every < 1 ||
+      record_every < 0) {
+    PyErr_SetString(PyExc_ValueError,
+                    "depth, imbalance_depth and eval_every must be >= 1, "
+                    "record_every >= 0");
+    return -1;
+  }
+
+  ApplyEventFn apply = apply_event_for(queue_model);
+  if (!apply) {
+    PyErr_Format(PyExc_ValueError, "unknown queue model: %s", queue_model);
+    return -1;
+  }
+
+  std::unique_ptr<Strategy> chosen;
+  if (strategy) {
+    std::string name = strategy;
+    if (name == "imbalance") {
+      chosen = std::make_unique<ImbalanceStrategy>(0.3, 5);
+    } else if (name == "market_making") {
+      chosen = std::make_unique<MarketMakingStrategy>(0.1, 10.0);
+    } else {
+      PyErr_Format(PyExc_ValueError, "unknown strategy: %s", strategy);
+      return -1;
+    }
+  }
+
+  auto state = std::make_unique<ReplayState>(path, symbol, depth,
+                                             imbalance_depth);
+  if (!state->reader.is_open()) {
+    PyErr_Format(PyExc_OSError, "cannot open event file: %s", path);
+    return -1;
+  }
+  state->apply = apply;
+  state->strategy = std::move(chosen);
+  state->eval_every = static_cast<uint64_t>(eval_every);
+  state->record_every = static_cast<uint64_t>(record_every);
+
+  auto *replay = reinterpret_cast<ReplayObject *>(self);
+  delete replay->state;
+  replay->state = state.release();
+  return 0;
+}
+
+ReplayState *checked_state(PyObject *self) {
+  ReplayState *state = reinterpret_cast<ReplayObject *>(self)->state;
+  if (!state)
+    PyErr_SetString(PyExc_RuntimeError, "Replay is not initialized");
+  return state;
+}
+
+// Apply up to max_events (negative: until end of file)
+PyObject *advance(PyObject *self, Py_ssize_t max_events) {
+  ReplayState *state = checked_state(self);
+  if (!state)
+    return nullptr;
+
+  Py_ssize_t applied = 0;
+  while ((max_events < 0 || applied < max_events) &&
+         state->reader.has_more()) {
+    auto event_opt = state->reader.read_next();
+    if (!event_opt)
+      continue;
+    const Event &event = *event_opt;
+
+    bool record = state->record_every > 0 &&
+                  state->events_processed % state->record_every == 0;
+    if (record && state->exports > 0 && state->would_reallocate()) {
+      state->publish();
+      PyErr_SetString(PyExc_BufferError,
+                      "metrics() views are still alive; release them "
+                      "before replaying further");
+      return nullptr;
+    }
+
+    state->apply(state->book, event);
+    const BookFeatures &features = state->tracker.update(state->book);
+
+    if (state->strategy && state->events_processed % state->eval_every == 0)
+      state->evaluate_strategy(event);
+    if (record)
+      state->record(event, features);
+
+    state->events_processed++;
+    applied++;
+  }
+
+  state->publish();
+  return PyLong_FromSsize_t(applied);
+}
+
+PyObject *Replay_step(PyObject *self, PyObject *args) {
+  Py_ssize_t n = 1;
+  if (!PyArg_ParseTuple(args, "|n", &n))
+    return nullptr;
+  if (n < 0) {
+    PyErr_SetString(PyExc_ValueError, "n must be >= 0");
+    return nullptr;
+  }
+  return advance(self, n);
+}
+
+PyObject *Replay_run(PyObject *self, PyObject *) { return advance(self, -1); }
+
+PyObject *Replay_metrics(PyObject *self, PyObject *) {
+  ReplayState *state = checked_state(self);
+  if (!state)
+    return nullptr;
+
+  auto *owner = reinterpret_cast<ReplayObject *>(self);
+  PyObject *result = PyDict_New();
+  if (!result)
+    return nullptr;
+
+  for (int i = 0; i < kTimestampColumns; ++i) {
+    PyObject *view = export_array(owner, ArrayKind::TIMESTAMP, i);
+    if (!view || PyDict_SetItemString(result, kTimestampNames[i], view) < 0) {
+      Py_XDECREF(view);
+      Py_DECREF(result);
+      return nullptr;
+    }
+    Py_DECREF(view);
+  }
+  for (int i = 0; i < kSeriesColumns; ++i) {
+    PyObject *view = export_array(owner, ArrayKind::SERIES, i);
+    if (!view || PyDict_SetItemString(result, kSeriesNames[i], view) < 0) {
+      Py_XDECREF(view);
+      Py_DECREF(result);
+      return nullptr;
+    }
+    Py_DECREF(view);
+  }
+  return result;
+}
+
+PyObject *Replay_clear_metrics(PyObject *self, PyObject *) {
+  ReplayState *state = checked_state(self);
+  if (!state)
+    return nullptr;
+  if (state->exports > 0) {
+    PyErr_SetString(PyExc_BufferError,
+                    "metrics() views are still alive; release them first");
+    return nullptr;
+  }
+  for (auto &column : state->timestamps)
+    column.clear();
+  for (auto &column : state->series)
+    column.clear();
+  Py_RETURN_NONE;
+}
+
+PyObject *Replay_reserve(PyObject *self, PyObject *args) {
+  Py_ssize_t n;
+  if (!PyArg_ParseTuple(args, "n", &n))
+    return nullptr;
+  ReplayState *state = checked_state(self);
+  if (!state)
+    return nullptr;
+  if (state->exports > 0) {
+    PyErr_SetString(PyExc_BufferError,
+                    "metrics() views are still alive; release them first");
+    return nullptr;
+  }
+  for (auto &column : state->timestamps)
+    column.reserve(static_cast<size_t>(n));
+  for (auto &column : state->series)
+    column.reserve(static_cast<size_t>(n));
+  Py_RETURN_NONE;
+}
+
+PyObject *Replay_get_depth(PyObject *self, void *) {
+  if (!checked_state(self))
+    return nullptr;
+  return export_array(reinterpret_cast<ReplayObject *>(self),
+                      ArrayKind::DEPTH, 0);
+}
+
+PyObject *Replay_get_features(PyObject *self, void *) {
+  if (!checked_state(self))
+    return nullptr;
+  return export_array(reinterpret_cast<ReplayObject *>(self),
+                      ArrayKind::FEATURES, 0);
+}
+
+PyObject *Replay_get_events_processed(PyObject *self, void *) {
+  ReplayState *state = checked_state(self);
+  return state ? PyLong_FromUnsignedLongLong(state->events_processed)
+               : nullptr;
+}
+
+PyObject *Replay_get_done(PyObject *self, void *) {
+  ReplayState *state = checked_state(self);
+  return state ? PyBool_FromLong(!state->reader.has_more()) : nullptr;
+}
+
+PyObject *Replay_get_position(PyObject *self, void *) {
+  ReplayState *state = checked_state(self);
+  if (!state)
+    return nullptr;
+  return PyFloat_FromDouble(state->strategy ? state->strategy->get_position()
+                                            : 0.0);
+}
+
+PyObject *Replay_get_pnl(PyObject *self, void *) {
+  ReplayState *state = checked_state(self);
+  if (!state)
+    return nullptr;
+  return PyFloat_FromDouble(state->strategy ? state->strategy->get_pnl()
+                                            : 0.0);
+}
+
+PyMethodDef Replay_methods[] = {
+    {"step", Replay_step, METH_VARARGS,
+     "step(n=1) -> int\nApply up to n events; returns how many were applied."},
+    {"run", Replay_run, METH_NOARGS,
+     "run() -> int\nApply every remaining event."},
+    {"metrics", Replay_metrics, METH_NOARGS,
+     "metrics() -> dict\nRecorded series as read-only views (no copy)."},
+    {"clear_metrics", Replay_clear_metrics, METH_NOARGS,
+     "Drop recorded series (no views may be alive)."},
+    {"reserve", Replay_reserve, METH_VARARGS,
+     "reserve(n)\nPreallocate n samples so views can stay alive while "
+     "stepping."},
+    {nullptr, nullptr, 0, nullptr}};
+
+PyGetSetDef Replay_getset[] = {
+    {"depth", Replay_get_depth, nullptr,
+     "(depth, 4) view: bid_price, bid_size, ask_price, ask_size", nullptr},
+    {"features", Replay_get_features, nullptr,
+     "Current feature vector (see FEATURE_NAMES)", nullptr},
+    {"events_processed", Replay_get_events_processed, nullptr, nullptr,
+     nullptr},
+    {"done", Replay_get_done, nullptr, "True at end of file", nullptr},
+    {"position", Replay_get_position, nullptr, nullptr, nullptr},
+    {"pnl", Replay_get_pnl, nullptr, nullptr, nullptr},
+    {nullptr, nullptr, nullptr, nullptr, nullptr}};
+
+PyTypeObject ReplayType = {PyVarObject_HEAD_INIT(nullptr, 0)};
+
+PyModuleDef lobengine_module = {
+    PyModuleDef_HEAD_INIT, "lobengine",
+    "Zero-copy access to the C++ order book replay.", -1, nullptr};
+
+} // namespace
+
+PyMODINIT_FUNC PyInit_lobengine() {
+  ArrayRefType.tp_name = "lobengine.ArrayRef";
+  ArrayRefType.tp_basicsize = sizeof(ArrayRefObject);
+  ArrayRefType.tp_dealloc = ArrayRef_dealloc;
+  ArrayRefType.tp_as_buffer = &ArrayRef_as_buffer;
+  ArrayRefType.tp_flags = Py_TPFLAGS_DEFAULT;
+  ArrayRefType.tp_doc = "Buffer exporter for an engine-owned array";
+
+  ReplayType.tp_name = "lobengine.Replay";
+  ReplayType.tp_basicsize = sizeof(ReplayObject);
+  ReplayType.tp_dealloc = Replay_dealloc;
+  ReplayType.tp_flags = Py_TPFLAGS_DEFAULT;
+  ReplayType.tp_doc =
+      "Replay(path, symbol='BTCUSDT', depth=10, queue_model='fifo',\n"
+      "       imbalance_depth=5, strategy=None, eval_every=10,\n"
+      "       record_every=1)";
+  ReplayType.tp_methods = Replay_methods;
+  ReplayType.tp_getset = Replay_getset;
+  ReplayType.tp_new = Replay_new;
+  ReplayType.tp_init = Replay_init;
+
+  if (PyType_Ready(&ArrayRefType) < 0 || PyType_Ready(&ReplayType) < 0)
+    return nullptr;
+
+  PyObject *module = PyModule_Create(&lobengine_module);
+  if (!module)
+    return nullptr;
+
+  PyObject *names = PyTuple_New(kFeatureCount);
+  if (!names) {
+    Py_DECREF(module);
+    return nullptr;
+  }
+  for (int i = 0; i < kFeatureCount; ++i)
+    PyTuple_SET_ITEM(names, i, PyUnicode_FromString(kFeatureNames[i]));
+
+  Py_INCREF(&ReplayType);
+  if (PyModule_AddObject(module, "Replay",
+                         reinterpret_cast<PyObject *>(&ReplayType)) < 0 ||
+      PyModule_AddObject(module, "FEATURE_NAMES", names) < 0) {
+    Py_DECREF(&ReplayType);
+    Py_DECREF(module);
+    return nullptr;
+  }
+  return module;
+}
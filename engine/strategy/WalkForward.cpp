@@ -0,0 +1,129 @@
+#include "WalkForward.h"
+#include "../metrics/Trace.h"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+namespace lob {
+
+size_t SignalTimeline::lower_bound(uint64_t ts) const {
+  return static_cast<size_t>(
+      std::lower_bound(timestamp.begin(), timestamp.end(), ts) -
+      timestamp.begin());
+}
+
+SimResult simulate_imbalance(const SignalTimeline &timeline,
+                             size_t depth_index, double threshold,
+                             size_t begin, size_t end, double trade_size) {
+  SimResult result;
+  if (begin >= end)
+    return result;
+
+  const double *imbalance = timeline.imbalance[depth_index].data();
+  const double *mid = timeline.mid.data();
+  double position = 0.0;
+  double cash = 0.0;
+
+  for (size_t i = begin; i < end; ++i) {
+    int signal = imbalance[i] > threshold    ? 1
+                 : imbalance[i] < -threshold ? -1
+                                             : 0;
+    if (signal != 0) {
+      double quantity = signal * trade_size;
+      position += quantity;
+      cash -= quantity * mid[i];
+      result.trades++;
+    }
+  }
+
+  result.final_position = position;
+  result.pnl = cash + position * mid[end - 1];
+  return result;
+}
+
+std::vector<WindowResult> walk_forward(const SignalTimeline &timeline,
+                                       const WalkForwardOptions &options) {
+  std::vector<WindowResult> windows;
+  if (timeline.size() == 0 || options.thresholds.empty() ||
+      timeline.depths.empty())
+    return windows;
+
+  // Window boundaries in exchange time
+  const uint64_t step = options.step_ms ? options.step_ms : options.test_ms;
+  const uint64_t first = timeline.timestamp.front();
+  const uint64_t last = timeline.timestamp.back();
+  uint64_t start = first;
+  while (start + options.train_ms + options.test_ms <= last + 1) {
+    WindowResult window{};
+    window.train_begin = start;
+    window.test_begin = start + options.train_ms;
+    window.test_end = window.test_begin + options.test_ms;
+
+    // Jump over gaps between captures instead of emitting empty windows
+    size_t train_first = timeline.lower_bound(window.train_begin);
+    if (train_first == timeline.lower_bound(window.test_begin)) {
+      start = std::max(start + step, timeline.timestamp[train_first]);
+      continue;
+    }
+    if (timeline.lower_bound(window.test_begin) !=
+        timeline.lower_bound(window.test_end))
+      windows.push_back(window);
+    start += step;
+  }
+  if (windows.empty())
+    return windows;
+
+  // Train every (window, cell) pair in parallel over the shared timeline
+  const size_t thresholds = options.thresholds.size();
+  const size_t cells = thresholds * timeline.depths.size();
+  const size_t tasks = windows.size() * cells;
+  std::vector<double> train_pnl(tasks);
+  std::atomic<size_t> next_task{0};
+
+  auto worker = [&]() {
+    for (size_t task = next_task.fetch_add(1); task < tasks;
+         task = next_task.fetch_add(1)) {
+      LOB_TRACE_SPAN("walk-forward train");
+      const WindowResult &window = windows[task / cells];
+      size_t cell = task % cells;
+      size_t begin = timeline.lower_bound(window.train_begin);
+      size_t end = timeline.lower_bound(window.test_begin);
+      train_pnl[task] =
+          simulate_imbalance(timeline, cell / thresholds,
+                             options.thresholds[cell % thresholds], begin,
+                             end, options.trade_size)
+              .pnl;
+    }
+  };
+
+  size_t threads = options.threads;
+  if (threads == 0)
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  threads = std::min(threads, tasks);
+
+  std::vector<std::thread> pool;
+  for (size_t t = 1; t < threads; ++t)
+    pool.emplace_back(worker);
+  worker();
+  for (std::thread &thread : pool)
+    thread.join();
+
+  // Pick each window's best cell and run it out of sample
+  for (size_t w = 0; w < windows.size(); ++w) {
+    const double *pnl = &train_pnl[w * cells];
+    size_t best = static_cast<size_t>(std::max_element(pnl, pnl + cells) - pnl);
+
+    WindowResult &window = windows[w];
+    window.best = ImbalanceParams{options.thresholds[best % thresholds],
+                                  timeline.depths[best / thresholds]};
+    window.train_pnl = pnl[best];
+    window.test = simulate_imbalance(
+        timeline, best / thresholds, window.best.threshold,
+        timeline.lower_bound(window.test_begin),
+        timeline.lower_bound(window.test_end), options.trade_size);
+  }
+
+  return windows;
+}
+
+} // namespace lob
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "../order_book/OrderBook.h"
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace lob {
+
+// Everything the imbalance strategy looks at, recorded once per evaluation
+// point while the book is rebuilt. Grid cells replay from these columns
+// instead of rebuilding the book, and share them read-only across threads.
+struct SignalTimeline {
+  std::vector<size_t> depths;                // Imbalance depths recorded
+  std::vector<uint64_t> timestamp;           // Exchange time (ms)
+  std::vector<double> mid;
+  std::vector<std::vector<double>> imbalance; // [depth index][point]
+
+  explicit SignalTimeline(std::vector<size_t> imbalance_depths)
+      : depths(std::move(imbalance_depths)), imbalance(depths.size()) {}
+
+  size_t size() const { return timestamp.size(); }
+
+  // Record the book at one evaluation point (skipped unless both sides
+  // are present, as no trade can happen there)
+  void record(const OrderBook &book, uint64_t exchange_ts) {
+    TopOfBook top = book.get_top_of_book();
+    if (!top.valid())
+      return;
+    timestamp.push_back(exchange_ts);
+    mid.push_back(top.mid);
+    for (size_t d = 0; d < depths.size(); ++d)
+      imbalance[d].push_back(book.calculate_imbalance(depths[d]));
+  }
+
+  // First point with timestamp >= ts
+  size_t lower_bound(uint64_t ts) const;
+};
+
+struct ImbalanceParams {
+  double threshold;
+  size_t depth;
+};
+
+// Imbalance strategy outcome over a range of timeline points, starting
+// flat and marked to the last mid of the range
+struct SimResult {
+  double pnl = 0.0;
+  double final_position = 0.0;
+  size_t trades = 0;
+};
+
+// Trade trade_size at mid whenever imbalance crosses +/- threshold, as the
+// replay loop does with ImbalanceStrategy
+SimResult simulate_imbalance(const SignalTimeline &timeline,
+                             size_t depth_index, double threshold,
+                             size_t begin, size_t end, double trade_size);
+
+struct WalkForwardOptions {
+  uint64_t train_ms = 60000;
+  uint64_t test_ms = 20000;
+  uint64_t step_ms = 0; // 0 = test_ms (back-to-back test windows)
+  std::vector<double> thresholds{0.1, 0.2, 0.3, 0.4, 0.5};
+  double trade_size = 0.01;
+  size_t threads = 0; // 0 = all hardware threads
+};
+
+struct WindowResult {
+  uint64_t train_begin;
+  uint64_t test_begin;
+  uint64_t test_end;
+  ImbalanceParams best;
+  double train_pnl;
+  SimResult test;
+};
+
+// Roll train/test windows over the timeline. Every (window, grid cell)
+// train run is evaluated in parallel; each window's best cell by train PnL
+// (first in grid order on ties) is then run on its test window. The grid
+// is options.thresholds x timeline.depths.
+std::vector<WindowResult> walk_forward(const SignalTimeline &timeline,
+                                       const WalkForwardOptions &options);
+
+} // namespace lob
@@ -51,6 +51,47 @@ def create_test_events(filename: str = "./data/test_events.events", num_events:
     return filename
 
 
+def create_l3_test_events(filename: str = "./data/test_l3.events", num_events: int = 5000):
+    """Create a market-by-order (L3) event file: ADD/MODIFY/CANCEL by order id."""
+    import random
+
+    os.makedirs(os.path.dirname(filename) or ".", exist_ok=True)
+
+    with open(filename, 'w') as f:
+        base_price = 42000.0
+        timestamp = int(time.time() * 1000)
+        seq = 1
+        next_id = 1
+        live = {}  # order_id -> (price, qty, side)
+
+        for i in range(num_events):
+            timestamp += 10
+            action = random.random()
+
+            if action < 0.5 or len(live) < 20:
+                side = random.choice(['BID', 'ASK'])
+                offset = random.randint(1, 10) * 0.5
+                price = base_price - offset if side == 'BID' else base_price + offset
+                qty = round(random.uniform(0.001, 1.0), 5)
+                live[next_id] = (price, qty, side)
+                f.write(f"{seq}|{timestamp}|{timestamp}|ADD|{price:.2f}|{qty:.5f}|{side}|{next_id}\n")
+                next_id += 1
+            elif action < 0.7:
+                order_id = random.choice(list(live))
+                price, qty, side = live[order_id]
+                qty = round(qty * random.uniform(0.2, 0.9), 5)
+                live[order_id] = (price, qty, side)
+                f.write(f"{seq}|{timestamp}|{timestamp}|MODIFY|{price:.2f}|{qty:.5f}|{side}|{order_id}\n")
+            else:
+                order_id = random.choice(list(live))
+                price, qty, side = live.pop(order_id)
+                f.write(f"{seq}|{timestamp}|{timestamp}|CANCEL|{price:.2f}|0|{side}|{order_id}\n")
+            seq += 1
+
+    print(f"[INFO] Created L3 test event file: {filename}")
+    return filename
+
+
 if __name__ == "__main__":
     print("=== Order Book Test Setup ===")
     test_file = create_test_events(num_events=5000)
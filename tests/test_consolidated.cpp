@@ -0,0 +1,235 @@
+#include "../engine/order_book/ConsolidatedBook.h"
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <random>
+#include <vector>
+
+using namespace lob;
+
+namespace {
+
+Event l2(Side side, double price, double quantity, uint64_t ts) {
+  Event event;
+  event.exchange_ts = ts;
+  event.event_type = EventType::UPDATE;
+  event.price = price;
+  event.price_ticks = std::llround(price * 100.0);
+  event.quantity = quantity;
+  event.side = side;
+  return event;
+}
+
+Event l3(EventType type, uint64_t id, Side side, double price,
+         double quantity, uint64_t ts) {
+  Event event = l2(side, price, quantity, ts);
+  event.event_type = type;
+  event.order_id = id;
+  return event;
+}
+
+// The aggregate must equal the venue books summed level by level
+template <Side S> void check_side(const ConsolidatedBook &book) {
+  std::map<int64_t, std::vector<double>, typename SideTraits<S>::Compare>
+      expected;
+  for (size_t v = 0; v < book.venue_count(); ++v) {
+    for (const auto &[ticks, limit] : book.venue(v).template half<S>()) {
+      auto &shares = expected[ticks];
+      shares.resize(book.venue_count(), 0.0);
+      shares[v] = limit.total_volume;
+    }
+  }
+
+  const ConsolidatedHalf<S> &half = book.template half<S>();
+  assert(half.size() == expected.size());
+  auto it = half.begin();
+  for (const auto &[ticks, shares] : expected) {
+    assert(it->first == ticks);
+    double total = 0.0;
+    for (size_t v = 0; v < shares.size(); ++v) {
+      assert(std::abs(it->second.venue_volume[v] - shares[v]) < 1e-9);
+      assert(((it->second.venue_mask >> v) & 1u) == (shares[v] > 0.0));
+      total += shares[v];
+    }
+    assert(std::abs(it->second.volume - total) < 1e-9);
+    ++it;
+  }
+}
+
+void check_matches_venues(const ConsolidatedBook &book) {
+  check_side<Side::BID>(book);
+  check_side<Side::ASK>(book);
+
+  TopOfBook top = book.get_top_of_book();
+  const auto &bids = book.half<Side::BID>();
+  const auto &asks = book.half<Side::ASK>();
+  assert(top.has_bid == !bids.empty() && top.has_ask == !asks.empty());
+  if (top.has_bid)
+    assert(top.bid_price == bids.best().price &&
+           top.bid_size == bids.best().volume);
+  if (top.has_ask)
+    assert(top.ask_price == asks.best().price &&
+           top.ask_size == asks.best().volume);
+}
+
+} // namespace
+
+// Test Case 1: Best across venues, summed depth, attribution
+void test_case_1() {
+  std::cout << "\n=== Test Case 1: Aggregation and attribution ==="
+            << std::endl;
+  ConsolidatedBook book("BTCUSDT", instruments::BTCUSDT);
+  size_t a = book.add_venue("A");
+  size_t b = book.add_venue("B");
+  assert(a == 0 && b == 1);
+
+  book.apply(a, l2(Side::BID, 100.00, 1.0, 1));
+  book.apply(a, l2(Side::BID, 99.99, 2.0, 1));
+  book.apply(a, l2(Side::ASK, 100.02, 1.5, 1));
+  book.apply(b, l2(Side::BID, 100.00, 3.0, 2));
+  book.apply(b, l2(Side::ASK, 100.01, 0.5, 2));
+
+  TopOfBook top = book.get_top_of_book();
+  assert(top.bid_price == 100.00 && top.bid_size == 4.0);
+  assert(top.ask_price == 100.01 && top.ask_size == 0.5);
+  assert(book.best_bid_venues() == 0b11);
+  assert(book.best_ask_venues() == 0b10);
+
+  DepthArray<5> bids;
+  book.get_bid_depth(bids);
+  assert(bids.size() == 2);
+  assert(bids[0].volume == 4.0 && bids[0].order_count == 2);
+  assert(bids[1].price == 99.99 && bids[1].order_count == 1);
+
+  // Venue B pulls its ask: A's ask becomes the consolidated touch
+  book.apply(b, l2(Side::ASK, 100.01, 0.0, 3));
+  top = book.get_top_of_book();
+  assert(top.ask_price == 100.02 && book.best_ask_venues() == 0b01);
+
+  // B bids through A's ask: not a crossed book on either venue, but
+  // crossed across venues
+  book.apply(b, l2(Side::BID, 100.02, 1.0, 4));
+  assert(book.locked() && !book.crossed());
+  book.apply(b, l2(Side::BID, 100.02, 0.0, 4));
+  book.apply(b, l2(Side::BID, 100.03, 1.0, 4));
+  assert(book.crossed() && !book.locked());
+  assert(book.best_bid_venues() == 0b10 && book.best_ask_venues() == 0b01);
+  check_matches_venues(book);
+
+  for (size_t i = 2; i < kMaxVenues; ++i)
+    assert(book.add_venue("X") == i);
+  assert(book.add_venue("overflow") == kNoVenue);
+  std::cout << "✓ Test Case 1 PASSED" << std::endl;
+}
+
+// Test Case 2: The incremental aggregate tracks the venues exactly,
+// including levels dropped by crossed-book repair and L3 modify/cancel
+void test_case_2() {
+  std::cout << "\n=== Test Case 2: Incremental vs venue books ==="
+            << std::endl;
+  ConsolidatedBook book("BTCUSDT", instruments::BTCUSDT);
+  book.add_venue("L2-a");
+  book.add_venue("L2-b");
+  book.add_venue("L3");
+
+  std::mt19937_64 rng(7);
+  std::vector<uint64_t> live;
+  uint64_t next_id = 1;
+  for (uint64_t ts = 1; ts <= 20000; ++ts) {
+    size_t venue = rng() % 3;
+    Side side = rng() % 2 ? Side::BID : Side::ASK;
+    // Overlapping bands so venues (and occasionally a venue) cross
+    int offset = static_cast<int>(rng() % 30);
+    double price =
+        (side == Side::BID ? 100.05 - offset * 0.01 : 99.95 + offset * 0.01);
+    double quantity = (rng() % 4) * 0.5;
+
+    if (venue < 2) {
+      book.apply(venue, l2(side, price, quantity, ts));
+    } else if (live.empty() || rng() % 3 == 0) {
+      book.apply(venue, l3(EventType::ADD, next_id, side, price,
+                           quantity + 0.5, ts));
+      live.push_back(next_id++);
+    } else {
+      size_t pick = rng() % live.size();
+      uint64_t id = live[pick];
+      if (rng() % 2) {
+        const L3Order *order = book.venue(venue).find_l3_order(id);
+        double new_price = order ? (order->price_ticks +
+                                    static_cast<int>(rng() % 5) - 2) /
+                                       100.0
+                                 : price;
+        book.apply(venue, l3(EventType::MODIFY, id, side, new_price,
+                             quantity + 0.5, ts));
+      } else {
+        book.apply(venue, l3(EventType::CANCEL, id, side, price, 0.0, ts));
+        live[pick] = live.back();
+        live.pop_back();
+      }
+    }
+    check_matches_venues(book);
+  }
+
+  std::cout << "  " << book.half<Side::BID>().size() << " bid / "
+            << book.half<Side::ASK>().size() << " ask consolidated levels"
+            << std::endl;
+  std::cout << "✓ Test Case 2 PASSED" << std::endl;
+}
+
+// Test Case 3: Consolidated update cost relative to a single book
+void test_case_3() {
+  std::cout << "\n=== Test Case 3: Update cost ===" << std::endl;
+  const size_t kEvents = 400000;
+  std::vector<Event> events;
+  std::mt19937_64 rng(11);
+  for (size_t i = 0; i < kEvents; ++i) {
+    Side side = i % 2 ? Side::BID : Side::ASK;
+    int offset = static_cast<int>(rng() % 50) + 1;
+    double price = side == Side::BID ? 100.00 - offset * 0.01
+                                     : 100.00 + offset * 0.01;
+    events.push_back(l2(side, price, (rng() % 5) * 0.25, i));
+  }
+
+  OrderBook single("BTCUSDT", instruments::BTCUSDT);
+  auto start = std::chrono::steady_clock::now();
+  for (const Event &event : events)
+    apply_event(single, event);
+  double single_ns = std::chrono::duration<double, std::nano>(
+                         std::chrono::steady_clock::now() - start)
+                         .count() /
+                     kEvents;
+
+  ConsolidatedBook book("BTCUSDT", instruments::BTCUSDT);
+  book.add_venue("A");
+  book.add_venue("B");
+  start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < events.size(); ++i)
+    book.apply(i % 2, events[i]);
+  double consolidated_ns = std::chrono::duration<double, std::nano>(
+                               std::chrono::steady_clock::now() - start)
+                               .count() /
+                           kEvents;
+  check_matches_venues(book);
+
+  std::cout << "  single book: " << single_ns
+            << " ns/event, consolidated: " << consolidated_ns << " ns/event"
+            << std::endl;
+  std::cout << "✓ Test Case 3 PASSED" << std::endl;
+}
+
+int main() {
+  std::cout << "========================================" << std::endl;
+  std::cout << "Consolidated Book Test Suite" << std::endl;
+  std::cout << "========================================" << std::endl;
+
+  test_case_1();
+  test_case_2();
+  test_case_3();
+
+  std::cout << "\n========================================" << std::endl;
+  std::cout << " ALL TESTS PASSED!" << std::endl;
+  std::cout << "========================================" << std::endl;
+  return 0;
+}
@@ -0,0 +1,137 @@
+#include "../engine/metrics/ControlChannel.h"
+#include "../engine/metrics/LatencyHistogram.h"
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <fcntl.h>
+#include <iostream>
+#include <string>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+using namespace lob;
+
+// Test Case 1: Command parsing and cadence updates
+void test_case_1() {
+  std::cout << "\n=== Test Case 1: Command parsing ===" << std::endl;
+  ControlCommand command;
+  RuntimeConfig config;
+
+  assert(parse_control_command("eval_every 50", command));
+  assert(command.op == ControlOp::EVAL_EVERY && command.value == 50);
+  assert(apply_control_command(command, config) && config.eval_every == 50);
+
+  assert(parse_control_command("  book_log_every   7 ", command));
+  assert(apply_control_command(command, config) && config.book_log_every == 7);
+
+  assert(parse_control_command("trace on", command));
+  assert(command.op == ControlOp::TRACE && command.value == 1);
+  assert(!apply_control_command(command, config)); // Caller's job
+  assert(parse_control_command("kill_switch off", command));
+  assert(command.op == ControlOp::KILL_SWITCH && command.value == 0);
+  assert(parse_control_command("trace_dump /tmp/x.json", command));
+  assert(command.op == ControlOp::TRACE_DUMP && command.path == "/tmp/x.json");
+  assert(parse_control_command("dump", command));
+  assert(command.op == ControlOp::DUMP);
+
+  // Malformed commands leave the output alone
+  command.value = 99;
+  assert(!parse_control_command("eval_every 0", command));
+  assert(!parse_control_command("eval_every -5", command));
+  assert(!parse_control_command("eval_every 5x", command));
+  assert(!parse_control_command("eval_every 5 6", command));
+  assert(!parse_control_command("trace maybe", command));
+  assert(!parse_control_command("dump now", command));
+  assert(!parse_control_command("reboot", command));
+  assert(command.value == 99);
+  assert(config.eval_every == 50 && config.progress_every == 10000);
+  std::cout << "✓ Test Case 1 PASSED" << std::endl;
+}
+
+// Wait (bounded) for the channel's flag
+bool wait_pending(const ControlChannel &control) {
+  for (int i = 0; i < 2000 && !control.pending(); ++i)
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  return control.pending();
+}
+
+// Test Case 2: SIGUSR1 and FIFO only raise the flag; take() drains
+void test_case_2() {
+  std::cout << "\n=== Test Case 2: Signal and FIFO ===" << std::endl;
+  const std::string path = "test_control_" + std::to_string(getpid()) + ".ctl";
+  std::vector<ControlCommand> commands;
+  {
+    ControlChannel control;
+    control.install_signal_handler();
+    assert(control.open_fifo(path));
+    assert(!control.pending());
+
+    raise(SIGUSR1);
+    assert(control.pending());
+    assert(control.take(commands) && commands.empty());
+    assert(!control.pending());
+
+    // Two writers, one bad line in between, a command split across writes
+    int fd = open(path.c_str(), O_WRONLY);
+    assert(fd >= 0);
+    const char first[] = "eval_every 25\nnonsense\nprogress_";
+    const char second[] = "every 500\ndump\n";
+    assert(write(fd, first, sizeof(first) - 1) > 0);
+    assert(write(fd, second, sizeof(second) - 1) > 0);
+    close(fd);
+
+    size_t expected = 3;
+    bool dump = false;
+    while (commands.size() < expected && wait_pending(control))
+      dump |= control.take(commands);
+    assert(!dump); // "dump" arrives as a command, not the signal flag
+    assert(commands.size() == 3);
+    assert(commands[0].op == ControlOp::EVAL_EVERY && commands[0].value == 25);
+    assert(commands[1].op == ControlOp::PROGRESS_EVERY &&
+           commands[1].value == 500);
+    assert(commands[2].op == ControlOp::DUMP);
+  }
+
+  // close() removed the FIFO it created and restored SIGUSR1
+  struct stat info;
+  assert(stat(path.c_str(), &info) != 0);
+  struct sigaction current;
+  sigaction(SIGUSR1, nullptr, &current);
+  assert(current.sa_handler == SIG_DFL);
+  std::cout << "✓ Test Case 2 PASSED" << std::endl;
+}
+
+// Test Case 3: Log2 latency histogram
+void test_case_3() {
+  std::cout << "\n=== Test Case 3: Latency histogram ===" << std::endl;
+  LatencyHistogram histogram;
+  for (int i = 0; i < 98; ++i)
+    histogram.record(300); // [256, 512)
+  histogram.record(5000);  // [4096, 8192)
+  histogram.record(0);
+
+  assert(histogram.count() == 100);
+  assert(histogram.max_ns() == 5000);
+  assert(histogram.quantile_ns(0.5) == 512);
+  assert(histogram.quantile_ns(0.99) == 512);
+  assert(histogram.quantile_ns(1.0) == 8192);
+  assert(std::abs(histogram.mean_ns() - (98 * 300 + 5000) / 100.0) < 1e-9);
+  std::cout << "✓ Test Case 3 PASSED" << std::endl;
+}
+
+int main() {
+  std::cout << "========================================" << std::endl;
+  std::cout << "Control Channel Test Suite" << std::endl;
+  std::cout << "========================================" << std::endl;
+
+  test_case_1();
+  test_case_2();
+  test_case_3();
+
+  std::cout << "\n========================================" << std::endl;
+  std::cout << " ALL TESTS PASSED!" << std::endl;
+  std::cout << "========================================" << std::endl;
+  return 0;
+}
@@ -0,0 +1,345 @@
+#include "../engine/io/EventApply.h"
+#include "../engine/io/EventReader.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace lob;
+
+const std::string kEventFile = "test_reader.events";
+
+// Time-sorted file mixing L2 and L3 lines on both sides; long enough
+// (several MB) for the time-range seek to bisect
+void write_event_file() {
+  std::ofstream out(kEventFile);
+  const char *l2_types[] = {"SNAPSHOT", "UPDATE"};
+  const char *l3_types[] = {"ADD", "MODIFY", "CANCEL"};
+  for (int i = 0; i < 120000; ++i) {
+    uint64_t seq = 1000 + i / 3;
+    uint64_t ts = 1700000000000ULL + i / 2;
+    const char *side = (i % 5 < 2) ? "BID" : "ASK";
+    int price_cents = 5000000 + (i * 37) % 2000;
+    out << seq << "|" << ts << "|" << ts + 3 << "|";
+    if (i % 4 == 3) {
+      out << l3_types[i % 3] << "|" << price_cents / 100 << "."
+          << price_cents % 100 << "|0.5|" << side << "|" << i << "\n";
+    } else {
+      out << l2_types[i < 100 ? 0 : 1] << "|" << price_cents / 100 << "."
+          << price_cents % 100 << "|1.25|" << side << "\n";
+    }
+  }
+}
+
+std::vector<Event> read_all(EventReader &reader) {
+  std::vector<Event> events;
+  while (reader.has_more()) {
+    auto event = reader.read_next();
+    if (event)
+      events.push_back(*event);
+  }
+  return events;
+}
+
+bool matches(const EventFilter &f, const Event &e) {
+  return e.exchange_ts >= f.min_exchange_ts &&
+         e.exchange_ts <= f.max_exchange_ts && e.exchange_seq >= f.min_seq &&
+         e.exchange_seq <= f.max_seq &&
+         (f.type_mask & EventFilter::type_bit(e.event_type)) &&
+         (e.side == Side::BID ? f.bids : f.asks) && e.price >= f.min_price &&
+         e.price <= f.max_price;
+}
+
+// Filtered read must equal the unfiltered read with the predicate applied
+void check_filter(const EventFilter &filter, const std::vector<Event> &all) {
+  std::vector<Event> expected;
+  for (const Event &e : all) {
+    if (matches(filter, e))
+      expected.push_back(e);
+  }
+
+  EventReader reader(kEventFile);
+  reader.set_filter(filter);
+  std::vector<Event> got = read_all(reader);
+
+  assert(got.size() == expected.size());
+  for (size_t i = 0; i < got.size(); ++i) {
+    assert(got[i].exchange_seq == expected[i].exchange_seq);
+    assert(got[i].exchange_ts == expected[i].exchange_ts);
+    assert(got[i].event_type == expected[i].event_type);
+    assert(got[i].price_ticks == expected[i].price_ticks);
+    assert(got[i].side == expected[i].side);
+    assert(got[i].order_id == expected[i].order_id);
+  }
+
+  // reset() replays the same filtered range
+  reader.reset();
+  assert(read_all(reader).size() == expected.size());
+
+  std::cout << "  " << got.size() << " events, " << reader.lines_filtered()
+            << " lines skipped" << std::endl;
+}
+
+// Test Case 1: Each predicate on its own and combined
+void test_case_1() {
+  std::cout << "\n=== Test Case 1: Reader predicate pushdown ===" << std::endl;
+  write_event_file();
+
+  EventReader plain(kEventFile);
+  std::vector<Event> all = read_all(plain);
+  assert(all.size() == 120000);
+
+  EventFilter time_range;
+  time_range.min_exchange_ts = 1700000000000ULL + 40000;
+  time_range.max_exchange_ts = 1700000000000ULL + 40999;
+  check_filter(time_range, all);
+
+  EventFilter seq_range;
+  seq_range.min_seq = 5000;
+  seq_range.max_seq = 5100;
+  check_filter(seq_range, all);
+
+  EventFilter types;
+  types.type_mask = EventFilter::type_bit(EventType::ADD) |
+                    EventFilter::type_bit(EventType::SNAPSHOT);
+  check_filter(types, all);
+
+  EventFilter bids;
+  bids.asks = false;
+  check_filter(bids, all);
+
+  EventFilter band;
+  band.min_price = 50005.00;
+  band.max_price = 50007.50;
+  check_filter(band, all);
+
+  EventFilter combined = time_range;
+  combined.bids = false;
+  combined.type_mask = EventFilter::type_bit(EventType::UPDATE) |
+                       EventFilter::type_bit(EventType::CANCEL);
+  combined.min_price = 50001.00;
+  combined.max_price = 50015.00;
+  check_filter(combined, all);
+
+  // Range before/after the file
+  EventFilter none;
+  none.min_exchange_ts = 1800000000000ULL;
+  check_filter(none, all);
+  none.min_exchange_ts = 0;
+  none.max_exchange_ts = 1;
+  check_filter(none, all);
+
+  std::remove(kEventFile.c_str());
+  std::cout << "✓ Test Case 1 PASSED" << std::endl;
+}
+
+// Test Case 2: Columnar block decode and block apply
+void test_case_2() {
+  std::cout << "\n=== Test Case 2: Columnar block decode ===" << std::endl;
+  const std::string path = "test_reader_blocks.events";
+  {
+    // Uncrossed batches: bids below 50000, asks above, some removals,
+    // plus a few L3 orders
+    std::ofstream out(path);
+    for (int batch = 0; batch < 3000; ++batch) {
+      uint64_t ts = 1700000000000ULL + batch * 10;
+      for (int k = 0; k < 6; ++k) {
+        bool bid = k < 3;
+        int offset = (batch * 7 + k * 13) % 40 + 1;
+        int cents = bid ? 5000000 - offset : 5000000 + offset;
+        const char *qty = (batch + k) % 5 == 0 ? "0" : "1.5";
+        out << batch << "|" << ts << "|" << ts + 1 << "|UPDATE|"
+            << cents / 100 << "." << cents % 100 << "|" << qty << "|"
+            << (bid ? "BID" : "ASK") << "\n";
+      }
+      if (batch % 100 == 50) {
+        out << batch << "|" << ts << "|" << ts + 1 << "|ADD|49990.00|0.25|BID|"
+            << batch << "\n";
+      }
+      if (batch % 100 == 75) {
+        out << batch << "|" << ts << "|" << ts + 1 << "|CANCEL|49990.00|0|BID|"
+            << batch - 25 << "\n";
+      }
+    }
+  }
+
+  EventReader reader(path);
+  std::vector<Event> all = read_all(reader);
+
+  // Odd capacity so blocks split exchange batches
+  EventReader block_reader(path);
+  EventBlock block(7);
+  std::vector<Event> decoded;
+  while (size_t count = block_reader.read_block(block)) {
+    assert(count <= 7);
+    for (size_t i = 0; i < count; ++i)
+      decoded.push_back(block.event(i, block_reader.codec()));
+  }
+  assert(decoded.size() == all.size());
+  for (size_t i = 0; i < all.size(); ++i) {
+    assert(decoded[i].exchange_seq == all[i].exchange_seq);
+    assert(decoded[i].local_ts == all[i].local_ts);
+    assert(decoded[i].event_type == all[i].event_type);
+    assert(decoded[i].price == all[i].price);
+    assert(decoded[i].quantity == all[i].quantity);
+    assert(decoded[i].side == all[i].side);
+    assert(decoded[i].order_id == all[i].order_id);
+  }
+
+  // Block apply builds the same book as per-event apply
+  OrderBook per_event("TEST");
+  for (const Event &event : all)
+    apply_event(per_event, event);
+
+  OrderBook per_block("TEST");
+  EventReader apply_reader(path);
+  EventBlock big_block;
+  while (apply_reader.read_block(big_block))
+    apply_block(per_block, big_block);
+
+  DepthArray<64> expected_bids, expected_asks, bids, asks;
+  per_event.get_bid_depth(expected_bids);
+  per_event.get_ask_depth(expected_asks);
+  per_block.get_bid_depth(bids);
+  per_block.get_ask_depth(asks);
+  assert(bids.size() == expected_bids.size() && !bids.empty());
+  assert(asks.size() == expected_asks.size() && !asks.empty());
+  for (size_t i = 0; i < bids.size(); ++i) {
+    assert(bids[i].price == expected_bids[i].price);
+    assert(std::abs(bids[i].volume - expected_bids[i].volume) < 1e-9);
+    assert(bids[i].order_count == expected_bids[i].order_count);
+  }
+  for (size_t i = 0; i < asks.size(); ++i) {
+    assert(asks[i].price == expected_asks[i].price);
+    assert(std::abs(asks[i].volume - expected_asks[i].volume) < 1e-9);
+    assert(asks[i].order_count == expected_asks[i].order_count);
+  }
+  std::cout << "  " << all.size() << " events, " << bids.size() << " bid / "
+            << asks.size() << " ask levels" << std::endl;
+
+  // Compile-time instrument: parser and book share the static grid and
+  // build the same book as the runtime-spec path
+  OrderBook dynamic_book("BTCUSDT", instruments::BTCUSDT);
+  EventReader dynamic_reader(path, DynamicInstrument(instruments::BTCUSDT));
+  for (const Event &event : read_all(dynamic_reader))
+    apply_event(dynamic_book, event);
+
+  OrderBook static_book("BTCUSDT", instruments::BTCUSDT);
+  BasicEventReader<BtcUsdtInstrument> static_reader(path, BtcUsdtInstrument());
+  while (static_reader.read_block(big_block))
+    apply_block<FifoPolicy, BtcUsdtInstrument>(static_book, big_block);
+
+  dynamic_book.get_bid_depth(expected_bids);
+  static_book.get_bid_depth(bids);
+  assert(bids.size() == expected_bids.size() && !bids.empty());
+  for (size_t i = 0; i < bids.size(); ++i) {
+    assert(bids[i].price == expected_bids[i].price);
+    assert(std::abs(bids[i].volume - expected_bids[i].volume) < 1e-9);
+  }
+  assert(static_book.get_top_of_book().ask_price ==
+         dynamic_book.get_top_of_book().ask_price);
+
+  std::remove(path.c_str());
+  std::cout << "✓ Test Case 2 PASSED" << std::endl;
+}
+
+// Test Case 3: Startup pre-scan, exact and sampled
+void test_case_3() {
+  std::cout << "\n=== Test Case 3: Pre-scan stats ===" << std::endl;
+  write_event_file();
+
+  EventReader reader(kEventFile);
+  std::vector<Event> all = read_all(reader);
+  std::set<uint64_t> live;
+  size_t peak_live = 0;
+  for (const Event &e : all) {
+    if (e.event_type == EventType::ADD)
+      live.insert(e.order_id);
+    else if (e.event_type == EventType::CANCEL)
+      live.erase(e.order_id);
+    peak_live = std::max(peak_live, live.size());
+  }
+
+  // Whole file fits the budget: exact, and the reader is rewound
+  EventFileStats exact = reader.scan_stats(uint64_t(64) << 20);
+  assert(!exact.sampled && exact.bytes_scanned == exact.bytes);
+  assert(exact.events == all.size());
+  assert(exact.max_batch == 3);
+  assert(exact.peak_l3_orders == peak_live);
+  assert(exact.first_ts == all.front().exchange_ts);
+  assert(exact.last_ts == all.back().exchange_ts);
+  auto first = reader.read_next();
+  assert(first && first->exchange_seq == all.front().exchange_seq);
+
+  // 1 MB budget over a larger file: count extrapolated, ends exact
+  EventFileStats sampled = reader.scan_stats(uint64_t(1) << 20);
+  assert(sampled.sampled && sampled.bytes_scanned < sampled.bytes);
+  assert(std::abs(static_cast<double>(sampled.events) - all.size()) <
+         0.02 * all.size());
+  assert(sampled.max_batch == 3);
+  assert(sampled.first_ts == exact.first_ts);
+  assert(sampled.last_ts == exact.last_ts);
+  std::cout << "  ~" << sampled.events << " of " << all.size()
+            << " events from " << sampled.bytes_scanned << " of "
+            << sampled.bytes << " bytes" << std::endl;
+
+  // The L3 store is presized when L3 mode switches on
+  OrderBook book("TEST");
+  book.reserve_l3(exact.peak_l3_orders * 2);
+  assert(!book.l3_enabled());
+  book.enable_l3();
+  for (uint64_t id = 1; id <= exact.peak_l3_orders; ++id)
+    assert(book.add_l3_order(id, 49000.0 + id % 100, 0.5, Side::BID, 0));
+  assert(book.get_top_of_book().bid_price == 49099.0);
+
+  std::remove(kEventFile.c_str());
+  std::cout << "✓ Test Case 3 PASSED" << std::endl;
+}
+
+// Test Case 4: Instrument spec files reject grids the codec cannot use
+void test_case_4() {
+  std::cout << "\n=== Test Case 4: Instrument spec validation ==="
+            << std::endl;
+  const std::string path = "test_instruments.txt";
+  {
+    std::ofstream out(path);
+    out << "# symbol|tick|lot|price_decimals|qty_decimals|min|max\n";
+    out << "GOOD|0.05|0.001|2|3|0|1000000\n";
+    out << "FINE|0.001|0.001|2|3|0|1000000\n";   // Tick below 10^-2
+    out << "ZERO|0|0.001|2|3|0|1000000\n";       // Tick 0
+    out << "NEG|0.01|-0.001|2|3|0|1000000\n";    // Negative lot
+    out << "OFFGRID|0.015|0.001|2|3|0|1000000\n"; // 1.5 price units
+    out << "RANGE|0.01|0.001|2|3|100|100\n";     // Empty price range
+    out << "JUNK|abc|0.001|2|3\n";               // Not a number
+  }
+
+  assert(load_instrument_specs(path) == 1);
+  const InstrumentSpec &good = instrument_for("GOOD");
+  assert(good.tick_units() == 5 && good.lot_units() == 1);
+  for (const char *bad : {"FINE", "ZERO", "NEG", "OFFGRID", "RANGE", "JUNK"})
+    assert(instrument_for(bad) == instruments::GENERIC);
+
+  std::remove(path.c_str());
+  std::cout << "✓ Test Case 4 PASSED" << std::endl;
+}
+
+int main() {
+  std::cout << "========================================" << std::endl;
+  std::cout << "Event Reader Test Suite" << std::endl;
+  std::cout << "========================================" << std::endl;
+
+  test_case_1();
+  test_case_2();
+  test_case_3();
+  test_case_4();
+
+  std::cout << "\n========================================" << std::endl;
+  std::cout << " ALL TESTS PASSED!" << std::endl;
+  std::cout << "========================================" << std::endl;
+  return 0;
+}
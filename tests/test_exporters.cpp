@@ -0,0 +1,227 @@
+#include "../engine/export/DatasetExporter.h"
+#include "../engine/export/TensorExporter.h"
+#include "../engine/order_book/OrderBook.h"
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using namespace lob;
+
+// Read a whole file into memory
+std::string read_file(const std::string &path) {
+  std::ifstream in(path, std::ios::binary);
+  return std::string((std::istreambuf_iterator<char>(in)),
+                     std::istreambuf_iterator<char>());
+}
+
+// Split an .npy file into its header dict and data section
+void parse_npy(const std::string &bytes, std::string &dict, std::string &data) {
+  assert(bytes.size() >= 10);
+  assert(bytes.compare(0, 6, "\x93NUMPY") == 0);
+  assert(bytes[6] == 1 && bytes[7] == 0);
+  size_t header_len = static_cast<unsigned char>(bytes[8]) |
+                      (static_cast<unsigned char>(bytes[9]) << 8);
+  assert((10 + header_len) % 64 == 0);
+  assert(bytes[10 + header_len - 1] == '\n');
+  dict = bytes.substr(10, header_len);
+  data = bytes.substr(10 + header_len);
+}
+
+// Test Case 1: NpyWriter header and row count
+void test_case_1() {
+  std::cout << "\n=== Test Case 1: NpyWriter ===" << std::endl;
+  const std::string path = "test_export_writer.npy";
+
+  NpyWriter writer;
+  assert(writer.open(path, "<f8", sizeof(double), {3}));
+  double rows[6] = {1, 2, 3, 4, 5, 6};
+  writer.append(rows, 1);
+  writer.append(rows + 3, 1);
+  assert(writer.rows() == 2);
+  assert(writer.close());
+
+  std::string dict, data;
+  parse_npy(read_file(path), dict, data);
+  std::cout << dict;
+  assert(dict.find("'descr': '<f8'") != std::string::npos);
+  assert(dict.find("'shape': (2, 3,)") != std::string::npos);
+  assert(data.size() == sizeof(rows));
+  assert(std::memcmp(data.data(), rows, sizeof(rows)) == 0);
+
+  std::remove(path.c_str());
+  std::cout << " PASSED: Header patched with final shape" << std::endl;
+}
+
+// Test Case 2: TensorExporter rows mirror the book's top-K depth
+void test_case_2() {
+  std::cout << "\n=== Test Case 2: TensorExporter ===" << std::endl;
+  const std::string prefix = "test_export_tensor";
+
+  OrderBook book("BTCUSDT");
+  book.update_order(100.0, 1.0, Side::BID, 1);
+  book.update_order(99.0, 2.0, Side::BID, 1);
+  book.update_order(101.0, 3.0, Side::ASK, 1);
+
+  {
+    // Tiny staging buffer: exercises streaming flushes
+    TensorExporter exporter(prefix, 3, 2);
+    assert(exporter.is_open());
+    for (uint64_t i = 0; i < 5; ++i) {
+      book.update_order(100.0, 1.0 + i, Side::BID, 10 + i);
+      exporter.sample(book, 1000 + i, 2000 + i);
+    }
+    assert(exporter.rows() == 5);
+    assert(exporter.close());
+  }
+
+  std::string dict, data;
+  parse_npy(read_file(prefix + ".npy"), dict, data);
+  assert(dict.find("'shape': (5, 3, 4,)") != std::string::npos);
+  std::vector<double> tensor(data.size() / sizeof(double));
+  std::memcpy(tensor.data(), data.data(), data.size());
+  assert(tensor.size() == 5 * 3 * 4);
+
+  // Last row: bids 100 x 5, 99 x 2; ask 101 x 3; third level empty
+  const double *row = tensor.data() + 4 * 12;
+  assert(row[0] == 100.0 && row[1] == 5.0 && row[2] == 101.0 && row[3] == 3.0);
+  assert(row[4] == 99.0 && row[5] == 2.0 && row[6] == 0.0 && row[7] == 0.0);
+  assert(row[8] == 0.0 && row[11] == 0.0);
+
+  parse_npy(read_file(prefix + ".ts.npy"), dict, data);
+  assert(dict.find("'descr': '<u8'") != std::string::npos);
+  assert(dict.find("'shape': (5, 2,)") != std::string::npos);
+  uint64_t ts[10];
+  assert(data.size() == sizeof(ts));
+  std::memcpy(ts, data.data(), sizeof(ts));
+  assert(ts[0] == 1000 && ts[1] == 2000 && ts[8] == 1004 && ts[9] == 2004);
+
+  std::remove((prefix + ".npy").c_str());
+  std::remove((prefix + ".ts.npy").c_str());
+  std::cout << " PASSED: Depth tensor and timestamp index agree with book"
+            << std::endl;
+}
+
+// Load one column of a ColumnarWriter file (single row group expected)
+std::vector<double> read_column(const std::string &bytes,
+                                const std::string &name, uint64_t &rows) {
+  assert(bytes.compare(0, 8, "LOBCOLS1") == 0);
+  assert(bytes.compare(bytes.size() - 8, 8, "LOBCOLS1") == 0);
+  uint32_t count;
+  std::memcpy(&count, bytes.data() + 8, sizeof(count));
+
+  size_t index = count;
+  for (uint32_t c = 0; c < count; ++c) {
+    if (name == bytes.c_str() + 12 + c * 40)
+      index = c;
+  }
+  assert(index < count);
+
+  std::memcpy(&rows, bytes.data() + bytes.size() - 24, sizeof(rows));
+  size_t chunk = 12 + count * 40 + 8 + index * rows * 8;
+  std::vector<double> values(rows);
+  std::memcpy(values.data(), bytes.data() + chunk, rows * 8);
+  return values;
+}
+
+// Test Case 3: DatasetExporter forward labels from the lookahead ring
+void test_case_3() {
+  std::cout << "\n=== Test Case 3: DatasetExporter Labels ===" << std::endl;
+  const std::string path = "test_export_dataset.bin";
+
+  OrderBook book("BTCUSDT");
+  book.update_order(99.0, 1.0, Side::BID, 1);
+  book.update_order(101.0, 1.0, Side::ASK, 1);
+
+  DatasetExporter::Options options;
+  options.imbalance_depths = {1};
+  options.horizons_ms = {1000, 100}; // Unsorted on purpose
+  {
+    DatasetExporter exporter(path, options);
+    assert(exporter.is_open());
+
+    // Batches every 50ms; the mid steps up by 1 every 100ms
+    for (uint64_t i = 0; i < 40; ++i) {
+      if (i % 2 == 0 && i > 0) {
+        double bid = 99.0 + i / 2;
+        book.update_order(bid, 1.0, Side::BID, i);
+        book.update_order(bid + 2.0, 1.0, Side::ASK, i);
+        book.clear_price_level(bid - 1.0, Side::BID);
+        book.clear_price_level(bid + 1.0, Side::ASK);
+      }
+      exporter.on_batch(book, 1000 + i * 50, 2000 + i * 50, true);
+    }
+    assert(exporter.rows() == 40);
+    assert(exporter.close());
+  }
+
+  uint64_t rows;
+  std::string bytes = read_file(path);
+  std::vector<double> mid = read_column(bytes, "mid", rows);
+  std::vector<double> short_ret = read_column(bytes, "ret_100ms", rows);
+  std::vector<double> long_ret = read_column(bytes, "ret_1s", rows);
+  assert(rows == 40);
+  assert(mid[0] == 100.0 && mid[2] == 101.0);
+
+  // Row 0 (t=1000): mid at t<=1100 is row 2's 101
+  assert(std::abs(short_ret[0] - (101.0 / 100.0 - 1.0)) < 1e-12);
+  // Row 0: mid at t<=2000 is row 20's 110
+  assert(std::abs(long_ret[0] - (110.0 / 100.0 - 1.0)) < 1e-12);
+  // Last data point is t=2950: 100ms labels resolve up to row 37, 1s
+  // labels up to row 19; later ones are beyond the data
+  assert(!std::isnan(short_ret[37]) && std::isnan(short_ret[38]));
+  assert(!std::isnan(long_ret[19]) && std::isnan(long_ret[20]));
+
+  std::remove(path.c_str());
+  std::cout << " PASSED: Labels match as-of mids at each horizon" << std::endl;
+}
+
+// Test Case 4: Ring overflow emits rows instead of growing
+void test_case_4() {
+  std::cout << "\n=== Test Case 4: Bounded Lookahead ===" << std::endl;
+  const std::string path = "test_export_overflow.bin";
+
+  OrderBook book("BTCUSDT");
+  book.update_order(99.0, 1.0, Side::BID, 1);
+  book.update_order(101.0, 1.0, Side::ASK, 1);
+
+  DatasetExporter::Options options;
+  options.horizons_ms = {10000};
+  options.lookahead_rows = 8;
+  DatasetExporter exporter(path, options);
+  for (uint64_t i = 0; i < 100; ++i)
+    exporter.on_batch(book, 1000 + i, 1000 + i, true);
+  assert(exporter.overflowed() == 92);
+  assert(exporter.rows() == 100);
+  assert(exporter.close());
+
+  uint64_t rows;
+  std::vector<double> labels =
+      read_column(read_file(path), "ret_10s", rows);
+  assert(rows == 100 && std::isnan(labels[0]));
+
+  std::remove(path.c_str());
+  std::cout << " PASSED: Memory stays bounded by the ring" << std::endl;
+}
+
+int main() {
+  std::cout << "========================================" << std::endl;
+  std::cout << "Exporter Test Suite" << std::endl;
+  std::cout << "========================================" << std::endl;
+
+  test_case_1();
+  test_case_2();
+  test_case_3();
+  test_case_4();
+
+  std::cout << "\n========================================" << std::endl;
+  std::cout << " ALL TESTS PASSED!" << std::endl;
+  std::cout << "========================================" << std::endl;
+  return 0;
+}
@@ -1,5 +1,6 @@
 #include "../engine/order_book/OrderBook.h"
 #include <cassert>
+#include <cmath>
 #include <iomanip>
 #include <iostream>
 
@@ -228,6 +229,335 @@ void test_case_9() {
   std::cout << " PASSED: FIFO order preserved correctly" << std::endl;
 }
 
+// Test Case 10: Allocation-free Depth Queries and Views
+void test_case_10() {
+  std::cout << "\n=== Test Case 10: Allocation-free Depth Queries ==="
+            << std::endl;
+  OrderBook book("BTCUSDT");
+
+  book.update_order(100.0, 50.0, Side::BID, 1000);
+  book.update_order(99.0, 30.0, Side::BID, 1001);
+  book.update_order(98.0, 10.0, Side::BID, 1002);
+  book.update_order(101.0, 40.0, Side::ASK, 1003);
+  book.update_order(100.0, 70.0, Side::BID, 1004); // [50, 20]
+
+  // Caller-owned fixed-capacity buffer
+  DepthArray<2> bids;
+  assert(book.get_bid_depth(bids) == 2);
+  assert(bids[0].price == 100.0 && bids[0].volume == 70.0);
+  assert(bids[0].order_count == 2);
+  assert(bids[1].price == 99.0 && bids[1].volume == 30.0);
+
+  // Raw buffer larger than the book
+  LevelInfo asks[4];
+  assert(book.get_ask_depth(asks, 4) == 1);
+  assert(asks[0].price == 101.0 && asks[0].volume == 40.0);
+
+  // Level views must agree with the allocating API
+  auto depth = book.get_bid_depth(3);
+  size_t i = 0;
+  for (const LevelInfo &level : book.bid_levels(3)) {
+    assert(level.price == depth[i].first);
+    assert(level.volume == depth[i].second);
+    i++;
+  }
+  assert(i == 3);
+
+  // Order queue view
+  OrderQueueView queue = book.get_order_queue(100.0, Side::BID);
+  assert(queue.size() == 2);
+  assert(queue[0].quantity == 50.0);
+  assert(queue[1].quantity == 20.0);
+  assert(book.get_order_queue(97.0, Side::BID).empty());
+
+  std::cout << " PASSED: Depth buffers and views match book state"
+            << std::endl;
+}
+
+// Test Case 11: Incremental Top-of-Book Snapshot
+void test_case_11() {
+  std::cout << "\n=== Test Case 11: Top-of-Book Snapshot ===" << std::endl;
+  OrderBook book("BTCUSDT");
+
+  assert(!book.get_top_of_book().has_bid);
+  assert(!book.get_top_of_book().valid());
+
+  book.update_order(100.0, 30.0, Side::BID, 1000);
+  book.update_order(102.0, 10.0, Side::ASK, 1001);
+
+  TopOfBook top = book.get_top_of_book();
+  assert(top.valid());
+  assert(top.bid_price == 100.0 && top.bid_size == 30.0);
+  assert(top.ask_price == 102.0 && top.ask_size == 10.0);
+  assert(top.mid == 101.0 && top.spread == 2.0);
+  // Microprice leans toward the thinner side (ask)
+  assert(std::abs(top.microprice - 101.5) < 1e-9);
+
+  // Better bid replaces the touch; removing it restores the old one
+  book.update_order(101.0, 5.0, Side::BID, 1002);
+  assert(book.get_top_of_book().bid_price == 101.0);
+  book.update_order(101.0, 0.0, Side::BID, 1003);
+  assert(book.get_top_of_book().bid_price == 100.0);
+
+  // Touch size follows volume changes at the best level
+  book.update_order(102.0, 4.0, Side::ASK, 1004);
+  assert(book.get_top_of_book().ask_size == 4.0);
+  assert(*book.get_mid_price() == book.get_top_of_book().mid);
+
+  book.clear();
+  assert(!book.get_top_of_book().has_ask);
+
+  std::cout << " PASSED: Touch snapshot tracks every change" << std::endl;
+}
+
+// Test Case 12: Side-Specialized and Batched Updates
+void test_case_12() {
+  std::cout << "\n=== Test Case 12: Side-Specialized Batch Updates ==="
+            << std::endl;
+  OrderBook runtime("BTCUSDT");
+  OrderBook specialized("BTCUSDT");
+
+  const double prices[] = {100.0, 99.0, 98.0, 99.0, 100.0};
+  const double quantities[] = {5.0, 3.0, 2.0, 0.0, 7.0};
+
+  for (size_t i = 0; i < 5; ++i) {
+    runtime.update_order(prices[i], quantities[i], Side::BID, 1000);
+  }
+  specialized.update_batch<Side::BID>(prices, quantities, 5, 1000);
+
+  assert(runtime.get_bid_depth(10) == specialized.get_bid_depth(10));
+  assert(specialized.get_bid_volume(99.0) == 0.0);
+  assert(specialized.get_top_of_book().bid_size == 7.0);
+
+  specialized.update<Side::ASK>(101.0, 4.0, 1001);
+  int64_t ask_ticks = specialized.codec().price_to_ticks(101.0);
+  assert(specialized.half<Side::ASK>().volume_at(ask_ticks) == 4.0);
+  assert(*specialized.get_spread() == 1.0);
+
+  std::cout << " PASSED: Batched and runtime paths agree" << std::endl;
+}
+
+// Test Case 13: Instrument Specs and Tick Conversion
+void test_case_13() {
+  std::cout << "\n=== Test Case 13: Instrument Tick Conversion ==="
+            << std::endl;
+
+  // Compile-time spec folds to constants
+  static_assert(BtcUsdtInstrument::spec().price_scale() == 100);
+  static_assert(BtcUsdtInstrument::spec().tick_units() == 1);
+  static_assert(BtcUsdtInstrument::spec().lot_units() == 1);
+
+  PriceCodec<BtcUsdtInstrument> btc;
+  const char price_text[] = "91359.99000000";
+  int64_t ticks = 0;
+  assert(btc.parse_price_ticks(price_text, price_text + 14, ticks));
+  assert(ticks == 9135999);
+  assert(btc.ticks_to_price(ticks) == 91359.99);
+  assert(btc.price_to_ticks(91359.99) == ticks);
+
+  const char qty_text[] = "0.00045000";
+  int64_t lots = 0;
+  assert(btc.parse_qty_lots(qty_text, qty_text + 10, lots));
+  assert(lots == 45 && btc.lots_to_qty(lots) == 0.00045);
+
+  // Runtime spec with a non-decimal tick (0.5)
+  InstrumentSpec half_tick{0.5, 1.0, 1, 0, 0.0, 1000.0};
+  PriceCodec<DynamicInstrument> coarse{DynamicInstrument(half_tick)};
+  assert(coarse.price_to_ticks(100.5) == 201);
+  assert(coarse.ticks_to_price(201) == 100.5);
+
+  // Books snap prices onto their instrument's tick grid
+  OrderBook book("BTCUSDT");
+  book.update_order_ticks(ticks, 1.5, Side::BID, 1000);
+  assert(book.get_bid_volume(91359.99) == 1.5);
+  assert(*book.get_best_bid() == 91359.99);
+
+  std::cout << " PASSED: Ticks and lots round-trip exactly" << std::endl;
+}
+
+// Test Case 14: True L3 Order-by-Order Mode
+void test_case_14() {
+  std::cout << "\n=== Test Case 14: True L3 Order-by-Order Mode ==="
+            << std::endl;
+  OrderBook book("BTCUSDT");
+  book.enable_l3(1000);
+
+  assert(book.add_l3_order(11, 100.0, 5.0, Side::BID, 1000));
+  assert(book.add_l3_order(12, 100.0, 3.0, Side::BID, 1001));
+  assert(book.add_l3_order(13, 99.0, 2.0, Side::BID, 1002));
+  assert(book.add_l3_order(21, 101.0, 4.0, Side::ASK, 1003));
+  assert(!book.add_l3_order(11, 98.0, 1.0, Side::BID, 1004)); // Duplicate id
+
+  // Depth and imbalance APIs see L3 volume
+  assert(book.get_bid_volume(100.0) == 8.0);
+  assert(book.get_bid_depth(2)[1].second == 2.0);
+  assert(book.get_top_of_book().ask_size == 4.0);
+  assert(std::abs(book.calculate_imbalance(5) - (10.0 - 4.0) / 14.0) < 1e-9);
+
+  // Shrinking keeps priority; growing re-queues at the back
+  assert(book.modify_l3_order(11, 4.0, 1005));
+  assert(book.get_l3_queue(100.0, Side::BID).begin()->order_id == 11);
+  assert(book.modify_l3_order(11, 6.0, 1006));
+  assert(book.get_l3_queue(100.0, Side::BID).begin()->order_id == 12);
+  assert(book.get_bid_volume(100.0) == 9.0);
+
+  // Price change moves the order to the new level
+  assert(book.modify_l3_order_ticks(12, book.codec().price_to_ticks(99.0),
+                                    3.0, 1007));
+  assert(book.get_bid_volume(99.0) == 5.0);
+  assert(book.find_l3_order(12)->price_ticks ==
+         book.codec().price_to_ticks(99.0));
+
+  // Cancel drains the level; the touch falls back
+  assert(book.cancel_l3_order(11));
+  assert(!book.cancel_l3_order(11));
+  assert(*book.get_best_bid() == 99.0);
+  assert(book.get_l3_order_count() == 3);
+
+  // Heavy churn keeps index and level totals consistent
+  for (uint64_t id = 1000; id < 1900; ++id) {
+    book.add_l3_order(id, 90.0 + (id % 7), 1.0, Side::BID, 2000);
+  }
+  for (uint64_t id = 1000; id < 1900; id += 2) {
+    assert(book.cancel_l3_order(id));
+  }
+  assert(book.get_l3_order_count() == 453);
+  for (uint64_t id = 1001; id < 1900; id += 2) {
+    assert(book.find_l3_order(id) != nullptr);
+  }
+
+  // Pool is bounded
+  OrderBook small("BTCUSDT");
+  small.enable_l3(2);
+  assert(small.add_l3_order(1, 100.0, 1.0, Side::ASK, 0));
+  assert(small.add_l3_order(2, 100.0, 1.0, Side::ASK, 0));
+  assert(!small.add_l3_order(3, 100.0, 1.0, Side::ASK, 0));
+  assert(small.cancel_l3_order(1));
+  assert(small.add_l3_order(3, 100.0, 1.0, Side::ASK, 0));
+
+  std::cout << " PASSED: L3 add/modify/cancel keep book and index in sync"
+            << std::endl;
+}
+
+// Build [10, 15, 20] at 100 and then reduce the level to 30 with Policy
+template <typename Policy> std::deque<Order> queue_after_decrease() {
+  OrderBook book("BTCUSDT");
+  book.update<Side::BID, Policy>(100.0, 10.0, 1000);
+  book.update<Side::BID, Policy>(100.0, 25.0, 1001);
+  book.update<Side::BID, Policy>(100.0, 45.0, 1002);
+  book.update<Side::ASK, Policy>(101.0, 5.0, 1003);
+  book.update<Side::BID, Policy>(99.0, 5.0, 1004);
+  book.update<Side::BID, Policy>(100.0, 30.0, 1005); // -15
+  assert(book.get_bid_volume(100.0) == 30.0);
+  return book.get_orders_at_price(100.0, Side::BID);
+}
+
+// Test Case 15: Pluggable Decrease-Allocation Policies
+void test_case_15() {
+  std::cout << "\n=== Test Case 15: Decrease-Allocation Policies ==="
+            << std::endl;
+
+  auto fifo = queue_after_decrease<FifoPolicy>();
+  print_orders(fifo, "fifo");
+  assert(fifo.size() == 2 && fifo[0].quantity == 10.0);
+
+  auto lifo = queue_after_decrease<LifoCancelPolicy>();
+  print_orders(lifo, "lifo");
+  assert(lifo.size() == 3 && lifo[0].quantity == 10.0 &&
+         lifo[2].quantity == 5.0);
+
+  auto prorata = queue_after_decrease<ProRataPolicy>();
+  print_orders(prorata, "prorata");
+  assert(prorata.size() == 3);
+  assert(std::abs(prorata[0].quantity - 10.0 * 30.0 / 45.0) < 1e-9);
+
+  auto sized = queue_after_decrease<SizeWeightedPolicy>();
+  print_orders(sized, "size");
+  assert(sized.size() == 3);
+  // Largest order absorbs the most, smallest the least
+  assert(20.0 - sized[2].quantity > 10.0 - sized[0].quantity);
+
+  // Mixed: the level is at the touch, so the decrease is treated as a trade
+  auto mixed = queue_after_decrease<MixedTradeCancelPolicy>();
+  print_orders(mixed, "mixed");
+  assert(mixed.size() == 2 && mixed[0].quantity == 10.0);
+
+  // Away from the touch, an exact-size match is cancelled
+  OrderBook book("BTCUSDT");
+  using Mixed = MixedTradeCancelPolicy;
+  book.update<Side::BID, Mixed>(101.0, 1.0, 1000);
+  book.update<Side::BID, Mixed>(100.0, 10.0, 1001);
+  book.update<Side::BID, Mixed>(100.0, 25.0, 1002);
+  book.update<Side::BID, Mixed>(100.0, 45.0, 1003);
+  book.update<Side::BID, Mixed>(100.0, 30.0, 1004); // cancels the 15
+  auto deep = book.get_orders_at_price(100.0, Side::BID);
+  assert(deep.size() == 2 && deep[0].quantity == 10.0 &&
+         deep[1].quantity == 20.0);
+
+  std::cout << " PASSED: Each model allocates the decrease as specified"
+            << std::endl;
+}
+
+// Test Case 16: Vectorized FIFO Consumption on Deep Queues
+void test_case_16() {
+  std::cout << "\n=== Test Case 16: Vectorized FIFO Consumption ==="
+            << std::endl;
+
+  // prefix_cut agrees with a scalar running sum for every block tail
+  std::vector<double> q;
+  for (int i = 0; i < 37; ++i)
+    q.push_back(1.0 + (i % 5));
+  for (size_t n = 0; n <= q.size(); ++n) {
+    for (double limit : {0.0, 0.5, 1.0, 7.0, 30.5, 1000.0}) {
+      size_t count = 0;
+      double sum = 0.0;
+      while (count < n && sum + q[count] <= limit)
+        sum += q[count++];
+      PrefixCut cut = prefix_cut(q.data(), n, limit);
+      assert(cut.count == count);
+      assert(std::abs(cut.consumed - sum) < 1e-9);
+    }
+  }
+
+  // 300 synthetic orders of size 1..3 at one level
+  OrderBook book("BTCUSDT");
+  std::vector<double> expected;
+  double volume = 0.0;
+  for (int i = 0; i < 300; ++i) {
+    double qty = 1.0 + (i % 3);
+    volume += qty;
+    expected.push_back(qty);
+    book.update_order(100.0, volume, Side::BID, 1000 + i);
+  }
+  assert(book.get_order_queue(100.0, Side::BID).size() == 300);
+
+  // Partial sweep: 249.5 removes the first 125 orders (sum 249) and trims
+  // the next one by 0.5
+  book.update_order(100.0, volume - 249.5, Side::BID, 2000);
+  OrderQueueView queue = book.get_order_queue(100.0, Side::BID);
+  assert(queue.size() == 175);
+  assert(queue[0].quantity == expected[125] - 0.5);
+  assert(queue[1].quantity == expected[126]);
+  assert(queue.back().quantity == expected[299]);
+  assert(std::abs(book.get_bid_volume(100.0) - (volume - 249.5)) < 1e-9);
+
+  // Repeated sweeps reclaim the consumed prefix and keep order ids
+  uint64_t last_id = queue.back().order_id;
+  for (int i = 0; i < 10; ++i) {
+    volume = book.get_bid_volume(100.0);
+    book.update_order(100.0, volume - 20.0, Side::BID, 3000 + i);
+  }
+  queue = book.get_order_queue(100.0, Side::BID);
+  assert(queue.back().order_id == last_id);
+  double sum = 0.0;
+  for (size_t i = 0; i < queue.size(); ++i)
+    sum += queue.quantities()[i];
+  assert(std::abs(sum - book.get_bid_volume(100.0)) < 1e-9);
+
+  std::cout << " PASSED: Bulk drop and boundary trim match FIFO semantics"
+            << std::endl;
+}
+
 int main() {
   std::cout << "========================================" << std::endl;
   std::cout << "Hybrid L2/L3 Order Book Test Suite" << std::endl;
@@ -243,6 +573,13 @@ int main() {
     test_case_7();
     test_case_8();
     test_case_9();
+    test_case_10();
+    test_case_11();
+    test_case_12();
+    test_case_13();
+    test_case_14();
+    test_case_15();
+    test_case_16();
 
     std::cout << "\n========================================" << std::endl;
     std::cout << " ALL TESTS PASSED!" << std::endl;
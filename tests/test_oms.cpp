@@ -0,0 +1,129 @@
+#include "../engine/oms/OrderManager.h"
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+using namespace lob;
+
+// Test Case 1: Lifecycle new -> acked -> partial -> filled
+void test_case_1() {
+  std::cout << "\n=== Test Case 1: Order lifecycle ===" << std::endl;
+  OrderManager oms(8);
+
+  OrderId id = oms.submit(OrderKind::LIMIT, Side::BID, 100, 1.0, 42, 1);
+  assert(id != kInvalidOrderId);
+  assert(oms.find(id)->state == OrderState::NEW);
+  assert(oms.find(id)->client_id == 42);
+
+  // Fills need an ack first
+  assert(oms.fill(id, 0.5, 10.0, 2) == OmsResult::INVALID_TRANSITION);
+  assert(oms.acknowledge(id, 2) == OmsResult::OK);
+  assert(oms.acknowledge(id, 2) == OmsResult::INVALID_TRANSITION);
+
+  assert(oms.fill(id, 0.4, 10.0, 3) == OmsResult::OK);
+  assert(oms.find(id)->state == OrderState::PARTIALLY_FILLED);
+  assert(std::abs(oms.find(id)->leaves() - 0.6) < 1e-12);
+
+  // Overfill rejected, exact remainder completes the order
+  assert(oms.fill(id, 0.7, 10.0, 4) == OmsResult::INVALID_QUANTITY);
+  assert(oms.fill(id, 0.6, 11.0, 4) == OmsResult::OK);
+  assert(oms.find(id) == nullptr); // Terminal: slot recycled
+  assert(oms.live() == 0);
+
+  assert(std::abs(oms.position() - 1.0) < 1e-12);
+  assert(std::abs(oms.cash() - -(0.4 * 10.0 + 0.6 * 11.0)) < 1e-9);
+  assert(oms.fills() == 2);
+  std::cout << "✓ Test Case 1 PASSED" << std::endl;
+}
+
+// Test Case 2: Amend, cancel, reject, stale handles, pool exhaustion
+void test_case_2() {
+  std::cout << "\n=== Test Case 2: Amend, cancel, stale ids ===" << std::endl;
+  OrderManager oms(2);
+
+  OrderId a = oms.submit(OrderKind::LIMIT, Side::ASK, 200, 2.0, 1, 1);
+  OrderId b = oms.submit(OrderKind::IOC, Side::BID, 199, 1.0, 2, 1);
+  assert(oms.submit(OrderKind::LIMIT, Side::BID, 1, 1.0, 3, 1) ==
+         kInvalidOrderId); // Pool full
+  assert(oms.submit(OrderKind::LIMIT, Side::BID, 1, 0.0, 3, 1) ==
+         kInvalidOrderId);
+
+  // Only resting limits can be amended, and not below what has filled
+  assert(oms.amend(b, 198, 1.0, 2) == OmsResult::INVALID_TRANSITION);
+  oms.acknowledge(a, 2);
+  oms.fill(a, 0.5, 20.0, 3);
+  assert(oms.amend(a, 201, 0.5, 4) == OmsResult::INVALID_QUANTITY);
+  assert(oms.amend(a, 201, 3.0, 4) == OmsResult::OK);
+  assert(oms.find(a)->price_ticks == 201 && oms.find(a)->quantity == 3.0);
+  assert(oms.find(a)->state == OrderState::PARTIALLY_FILLED);
+
+  // IOC remainder cancelled; reject only from NEW
+  assert(oms.reject(b, 5) == OmsResult::OK);
+  assert(oms.rejects() == 1);
+  assert(oms.cancel(b, 5) == OmsResult::UNKNOWN_ORDER);
+
+  // Recycled slot gets a new generation: the old handle stays dead
+  OrderId c = oms.submit(OrderKind::MARKET, Side::BID, 0, 1.0, 4, 6);
+  assert(c != b && static_cast<uint32_t>(c) == static_cast<uint32_t>(b));
+  assert(oms.find(b) == nullptr && oms.find(c) != nullptr);
+
+  size_t live = 0;
+  oms.for_each_live([&](OrderId, const OmsOrder &) { live++; });
+  assert(live == 2 && oms.live() == 2);
+  assert(oms.cancel_all(7) == 2);
+  assert(oms.live() == 0 && oms.find(a) == nullptr);
+  assert(oms.cancel(a, 8) == OmsResult::UNKNOWN_ORDER);
+  std::cout << "✓ Test Case 2 PASSED" << std::endl;
+}
+
+// Test Case 3: Two-sided re-quoting at feed rate
+void test_case_3() {
+  std::cout << "\n=== Test Case 3: Re-quote throughput ===" << std::endl;
+  OrderManager oms(1024);
+  const int ticks = 2000000;
+
+  OrderId bid = kInvalidOrderId;
+  OrderId ask = kInvalidOrderId;
+  auto start = std::chrono::steady_clock::now();
+  for (int t = 0; t < ticks; ++t) {
+    // Every tick: amend both quotes; every 8th: cancel and replace
+    if (t % 8 == 0) {
+      oms.cancel(bid, t);
+      oms.cancel(ask, t);
+      bid = oms.submit(OrderKind::LIMIT, Side::BID, 1000 - t % 5, 1.0, t, t);
+      ask = oms.submit(OrderKind::LIMIT, Side::ASK, 1001 + t % 5, 1.0, t, t);
+      oms.acknowledge(bid, t);
+      oms.acknowledge(ask, t);
+    } else {
+      oms.amend(bid, 1000 - t % 5, 1.0 + (t % 3), t);
+      oms.amend(ask, 1001 + t % 5, 1.0 + (t % 3), t);
+    }
+  }
+  auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start)
+                .count();
+  assert(oms.live() == 2);
+  assert(oms.submitted() == 2 * static_cast<uint64_t>(ticks / 8));
+
+  double ops = 2.0 * ticks + 4.0 * (ticks / 8); // amends + cancel/submit/ack
+  std::cout << "  " << ticks << " ticks, " << ns / ops << " ns per operation"
+            << std::endl;
+  std::cout << "✓ Test Case 3 PASSED" << std::endl;
+}
+
+int main() {
+  std::cout << "========================================" << std::endl;
+  std::cout << "Order Manager Test Suite" << std::endl;
+  std::cout << "========================================" << std::endl;
+
+  test_case_1();
+  test_case_2();
+  test_case_3();
+
+  std::cout << "\n========================================" << std::endl;
+  std::cout << " ALL TESTS PASSED!" << std::endl;
+  std::cout << "========================================" << std::endl;
+  return 0;
+}
@@ -0,0 +1,140 @@
+#include "../engine/oms/OwnOrderOverlay.h"
+#include <cassert>
+#include <cmath>
+#include <iostream>
+
+using namespace lob;
+
+// Market: bids 100/99 (2.0, 3.0), asks 101/102 (1.0, 4.0)
+void fill_market(OrderBook &book) {
+  book.update<Side::BID>(100.0, 2.0, 1);
+  book.update<Side::BID>(99.0, 3.0, 1);
+  book.update<Side::ASK>(101.0, 1.0, 1);
+  book.update<Side::ASK>(102.0, 4.0, 1);
+}
+
+// Test Case 1: Overlay bookkeeping and rebuild from the OMS
+void test_case_1() {
+  std::cout << "\n=== Test Case 1: Overlay levels ===" << std::endl;
+  OrderBook book("BTCUSDT");
+  const auto &codec = book.codec();
+  OwnOrderOverlay own;
+
+  own.add(Side::BID, codec.price_to_ticks(99.0), 1.0);
+  own.add(Side::BID, codec.price_to_ticks(100.5), 0.5);
+  own.add(Side::BID, codec.price_to_ticks(99.0), 0.5);
+  const OwnHalf<Side::BID> &bids = own.half<Side::BID>();
+  assert(bids.size() == 2);
+  assert(bids.begin()->price_ticks == codec.price_to_ticks(100.5)); // Best first
+  assert(bids.volume_at(codec.price_to_ticks(99.0)) == 1.5);
+
+  // Partial fill keeps the level, the last order leaving removes it
+  own.reduce(Side::BID, codec.price_to_ticks(99.0), 0.25, false);
+  assert(bids.volume_at(codec.price_to_ticks(99.0)) == 1.25);
+  own.reduce(Side::BID, codec.price_to_ticks(99.0), 0.75, true);
+  own.reduce(Side::BID, codec.price_to_ticks(99.0), 0.5, true);
+  assert(bids.size() == 1);
+
+  // Rebuild picks up resting limits only, at their remaining size
+  OrderManager oms(8);
+  OrderId a = oms.submit(OrderKind::LIMIT, Side::ASK,
+                         codec.price_to_ticks(101.0), 2.0, 1, 1);
+  oms.submit(OrderKind::MARKET, Side::BID, 0, 1.0, 2, 1);
+  oms.acknowledge(a, 2);
+  oms.fill(a, 0.5, 101.0, 3);
+  own.rebuild(oms);
+  assert(own.half<Side::BID>().empty());
+  assert(own.half<Side::ASK>().size() == 1);
+  assert(own.half<Side::ASK>().volume_at(codec.price_to_ticks(101.0)) == 1.5);
+  std::cout << "✓ Test Case 1 PASSED" << std::endl;
+}
+
+// Test Case 2: Feed without our orders - overlay adds them
+void test_case_2() {
+  std::cout << "\n=== Test Case 2: Feed excludes own orders ===" << std::endl;
+  OrderBook book("BTCUSDT");
+  fill_market(book);
+  const auto &codec = book.codec();
+
+  OwnOrderOverlay own;
+  own.add(Side::BID, codec.price_to_ticks(100.5), 1.0); // Improves the bid
+  own.add(Side::BID, codec.price_to_ticks(99.0), 2.0);  // Joins a level
+  own.add(Side::ASK, codec.price_to_ticks(102.0), 1.0);
+
+  BookViews views = book_views(book, own, FeedOwnership::EXCLUDES_OWN);
+
+  DepthArray<5> bids;
+  views.with_own.bid_depth(bids);
+  assert(bids.size() == 3);
+  assert(std::abs(bids[0].price - 100.5) < 1e-9 && bids[0].volume == 1.0);
+  assert(bids[0].order_count == 1);
+  assert(bids[1].price == 100.0 && bids[1].volume == 2.0);
+  assert(bids[2].price == 99.0 && bids[2].volume == 5.0);
+  assert(bids[2].order_count == 2);
+
+  // The book others see is the feed itself
+  assert(views.without_own.imbalance(5) == book.calculate_imbalance(5));
+  TopOfBook market = views.without_own.top();
+  assert(market.bid_price == 100.0 && market.ask_price == 101.0);
+
+  TopOfBook ours = views.with_own.top();
+  assert(std::abs(ours.bid_price - 100.5) < 1e-9 && ours.ask_price == 101.0);
+  assert(std::abs(ours.mid - 100.75) < 1e-9);
+
+  // Bid 1 + 2 + 5 = 8 vs ask 1 + 5 = 6
+  assert(std::abs(views.with_own.imbalance(5) - 2.0 / 14.0) < 1e-12);
+  assert(views.with_own.total_bid_volume(2) == 3.0);
+  std::cout << "✓ Test Case 2 PASSED" << std::endl;
+}
+
+// Test Case 3: Feed already counts our orders - overlay subtracts them
+void test_case_3() {
+  std::cout << "\n=== Test Case 3: Feed includes own orders ===" << std::endl;
+  OrderBook book("BTCUSDT");
+  fill_market(book);
+  const auto &codec = book.codec();
+
+  // Whole 101 ask is ours; 1.0 of the 99 bid is ours
+  OwnOrderOverlay own;
+  own.add(Side::ASK, codec.price_to_ticks(101.0), 1.0);
+  own.add(Side::BID, codec.price_to_ticks(99.0), 1.0);
+
+  BookViews views = book_views(book, own, FeedOwnership::INCLUDES_OWN);
+  assert(views.with_own.imbalance(5) == book.calculate_imbalance(5));
+
+  // Without us the ask touch moves out to 102
+  DepthArray<5> asks;
+  views.without_own.ask_depth(asks);
+  assert(asks.size() == 1 && asks[0].price == 102.0);
+  TopOfBook others = views.without_own.top();
+  assert(others.ask_price == 102.0 && others.ask_size == 4.0);
+  assert(others.bid_price == 100.0);
+
+  // Depth still means "n visible levels" after levels vanish
+  DepthArray<1> one;
+  assert(views.without_own.ask_depth(one) == 1 && one[0].price == 102.0);
+
+  // Bid 2 + 2 = 4 vs ask 4
+  assert(std::abs(views.without_own.imbalance(5)) < 1e-12);
+
+  // Views read the live book: later feed updates show up without a rebuild
+  book.update<Side::ASK>(101.0, 3.0, 2);
+  assert(views.without_own.top().ask_price == 101.0);
+  assert(views.without_own.top().ask_size == 2.0);
+  std::cout << "✓ Test Case 3 PASSED" << std::endl;
+}
+
+int main() {
+  std::cout << "========================================" << std::endl;
+  std::cout << "Own-Order Overlay Test Suite" << std::endl;
+  std::cout << "========================================" << std::endl;
+
+  test_case_1();
+  test_case_2();
+  test_case_3();
+
+  std::cout << "\n========================================" << std::endl;
+  std::cout << " ALL TESTS PASSED!" << std::endl;
+  std::cout << "========================================" << std::endl;
+  return 0;
+}
@@ -0,0 +1,67 @@
+#include "../engine/metrics/Probes.h"
+#include <cassert>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+
+using namespace lob;
+
+enum class Direction : uint8_t { UP, DOWN };
+
+__attribute__((noinline)) int64_t fire(uint64_t seq, int64_t ticks,
+                                       Direction direction) {
+  LOB_PROBE0(test_empty);
+  LOB_PROBE3(test_args, seq, ticks, direction);
+  return ticks + 1;
+}
+
+// Test Case 1: Probes are inert NOPs with a stapsdt note per site
+void test_case_1() {
+  std::cout << "\n=== Test Case 1: USDT probe notes ===" << std::endl;
+  static_assert(sdt_arg_size<int64_t>() == -8, "signed size is negative");
+  static_assert(sdt_arg_size<uint32_t>() == 4, "unsigned size is positive");
+  static_assert(sdt_arg_size<Direction>() == 1, "enums use their width");
+
+  assert(fire(7, -3, Direction::DOWN) == -2);
+
+  if (!LOB_PROBES_ENABLED) {
+    std::cout << "  probes compiled out on this platform" << std::endl;
+    std::cout << "✓ Test Case 1 PASSED" << std::endl;
+    return;
+  }
+
+  // Provider and probe name are adjacent only inside the note payloads
+  // (needles are assembled at runtime so they are not in .rodata)
+  std::ifstream exe("/proc/self/exe", std::ios::binary);
+  std::string image((std::istreambuf_iterator<char>(exe)),
+                    std::istreambuf_iterator<char>());
+  auto needle = [](const char *name) {
+    return std::string("lob") + '\0' + name + '\0';
+  };
+  assert(image.find(needle("test_empty")) != std::string::npos);
+  size_t note = image.find(needle("test_args"));
+  assert(note != std::string::npos);
+
+  // Argument spec: unsigned 8 bytes, signed 8 bytes, unsigned 1 byte
+  std::string args(image.c_str() + note + needle("test_args").size());
+  assert(args.rfind("8@", 0) == 0);
+  assert(args.find(" -8@") != std::string::npos);
+  assert(args.find(" 1@") != std::string::npos);
+  std::cout << "  test_args: " << args << std::endl;
+  std::cout << "✓ Test Case 1 PASSED" << std::endl;
+}
+
+int main() {
+  std::cout << "========================================" << std::endl;
+  std::cout << "USDT Probe Test Suite" << std::endl;
+  std::cout << "========================================" << std::endl;
+
+  test_case_1();
+
+  std::cout << "\n========================================" << std::endl;
+  std::cout << " ALL TESTS PASSED!" << std::endl;
+  std::cout << "========================================" << std::endl;
+  return 0;
+}
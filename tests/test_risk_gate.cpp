@@ -0,0 +1,156 @@
+#include "../engine/oms/RiskGate.h"
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+using namespace lob;
+
+// Two-sided market at 99.5 / 100.5 (mid 100)
+TopOfBook make_top() {
+  TopOfBook top;
+  top.has_bid = top.has_ask = true;
+  top.bid_price = 99.5;
+  top.ask_price = 100.5;
+  top.bid_size = top.ask_size = 1.0;
+  top.update_derived();
+  return top;
+}
+
+// Test Case 1: Size, position, notional and kill switch
+void test_case_1() {
+  std::cout << "\n=== Test Case 1: Limits and kill switch ===" << std::endl;
+  RiskLimits limits;
+  limits.max_order_qty = 2.0;
+  limits.max_position = 3.0;
+  limits.max_notional = 250.0;
+  RiskGate gate(limits);
+  TopOfBook top = make_top();
+
+  assert(gate.check(Side::BID, OrderKind::MARKET, 0.0, 2.5, top, 1) ==
+         RiskCheck::ORDER_SIZE);
+  assert(gate.check(Side::BID, OrderKind::MARKET, 0.0, 1.0, TopOfBook(), 1) ==
+         RiskCheck::NO_MARKET);
+
+  // Open quantity counts as if it filled: 2 open + 1.5 breaches 3
+  assert(gate.check(Side::BID, OrderKind::LIMIT, 99.0, 2.0, top, 1) ==
+         RiskCheck::PASSED);
+  assert(gate.open_buy() == 2.0);
+  assert(gate.check(Side::BID, OrderKind::LIMIT, 99.0, 1.5, top, 1) ==
+         RiskCheck::POSITION);
+
+  // 2 open + 0.6 at mid 100 = 260 > 250 notional
+  assert(gate.check(Side::BID, OrderKind::MARKET, 0.0, 0.6, top, 1) ==
+         RiskCheck::NOTIONAL);
+
+  // Fills move open quantity into position; selling reduces exposure
+  gate.on_fill(Side::BID, 2.0);
+  assert(gate.position() == 2.0 && gate.open_buy() == 0.0);
+  assert(gate.check(Side::ASK, OrderKind::MARKET, 0.0, 2.0, top, 1) ==
+         RiskCheck::PASSED);
+  gate.on_release(Side::ASK, 2.0); // Cancelled after all
+  assert(gate.open_sell() == 0.0);
+
+  gate.set_kill_switch(true);
+  assert(gate.check(Side::ASK, OrderKind::MARKET, 0.0, 0.1, top, 1) ==
+         RiskCheck::KILL_SWITCH);
+  gate.set_kill_switch(false);
+  assert(gate.check(Side::ASK, OrderKind::MARKET, 0.0, 0.1, top, 1) ==
+         RiskCheck::PASSED);
+
+  assert(gate.checked() == 8 && gate.rejected() == 5);
+  assert(gate.rejections(RiskCheck::POSITION) == 1);
+  assert(gate.rejections(RiskCheck::KILL_SWITCH) == 1);
+  std::cout << "✓ Test Case 1 PASSED" << std::endl;
+}
+
+// Test Case 2: Token bucket throttle and price bands
+void test_case_2() {
+  std::cout << "\n=== Test Case 2: Rate throttle and price band ===" << std::endl;
+  RiskLimits limits;
+  limits.max_orders_per_sec = 10.0; // One token per 100 ms
+  limits.burst = 3.0;
+  limits.price_band_bps = 100.0; // 1% around mid
+  RiskGate gate(limits);
+  TopOfBook top = make_top();
+
+  // Burst of 3, then empty until time passes
+  for (int i = 0; i < 3; ++i)
+    assert(gate.check(Side::BID, OrderKind::MARKET, 0.0, 0.1, top, 1000) ==
+           RiskCheck::PASSED);
+  assert(gate.check(Side::BID, OrderKind::MARKET, 0.0, 0.1, top, 1050) ==
+         RiskCheck::RATE);
+  assert(gate.check(Side::BID, OrderKind::MARKET, 0.0, 0.1, top, 1100) ==
+         RiskCheck::PASSED);
+
+  // The bucket never holds more than the burst
+  for (int i = 0; i < 3; ++i)
+    assert(gate.check(Side::BID, OrderKind::MARKET, 0.0, 0.1, top, 100000) ==
+           RiskCheck::PASSED);
+  assert(gate.check(Side::BID, OrderKind::MARKET, 0.0, 0.1, top, 100000) ==
+         RiskCheck::RATE);
+
+  // Band applies to priced orders only and does not consume a token
+  assert(gate.check(Side::ASK, OrderKind::LIMIT, 101.5, 0.1, top, 200000) ==
+         RiskCheck::PRICE_BAND);
+  assert(gate.check(Side::ASK, OrderKind::IOC, 98.0, 0.1, top, 200000) ==
+         RiskCheck::PRICE_BAND);
+  for (int i = 0; i < 3; ++i)
+    assert(gate.check(Side::ASK, OrderKind::LIMIT, 100.9, 0.1, top, 200000) ==
+           RiskCheck::PASSED);
+  assert(gate.rejections(RiskCheck::RATE) == 2);
+  assert(gate.rejections(RiskCheck::PRICE_BAND) == 2);
+  std::cout << "✓ Test Case 2 PASSED" << std::endl;
+}
+
+// Test Case 3: Cost per check with every limit enabled
+void test_case_3() {
+  std::cout << "\n=== Test Case 3: Check latency ===" << std::endl;
+  RiskLimits limits;
+  limits.max_order_qty = 5.0;
+  limits.max_position = 10.0;
+  limits.max_notional = 1e6;
+  limits.max_orders_per_sec = 1000.0;
+  limits.burst = 50.0;
+  limits.price_band_bps = 50.0;
+  RiskGate gate(limits);
+  TopOfBook top = make_top();
+
+  const int orders = 5000000;
+  uint64_t passed = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < orders; ++i) {
+    Side side = (i & 1) ? Side::ASK : Side::BID;
+    double price = side == Side::BID ? 99.8 - 0.2 * (i % 4) : 100.2;
+    if (gate.check(side, OrderKind::LIMIT, price, 0.5, top, i) ==
+        RiskCheck::PASSED) {
+      gate.on_fill(side, 0.5);
+      passed++;
+    }
+  }
+  auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start)
+                .count();
+  assert(gate.checked() == static_cast<uint64_t>(orders));
+  assert(passed > 0 && gate.rejected() > 0);
+
+  std::cout << "  " << orders << " orders, " << passed << " passed, "
+            << static_cast<double>(ns) / orders << " ns per check"
+            << std::endl;
+  std::cout << "✓ Test Case 3 PASSED" << std::endl;
+}
+
+int main() {
+  std::cout << "========================================" << std::endl;
+  std::cout << "Risk Gate Test Suite" << std::endl;
+  std::cout << "========================================" << std::endl;
+
+  test_case_1();
+  test_case_2();
+  test_case_3();
+
+  std::cout << "\n========================================" << std::endl;
+  std::cout << " ALL TESTS PASSED!" << std::endl;
+  std::cout << "========================================" << std::endl;
+  return 0;
+}
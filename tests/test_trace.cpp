@@ -0,0 +1,84 @@
+#include "../engine/metrics/Trace.h"
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+// Built with -DLOB_TRACING=1; without it every span compiles to nothing
+using namespace lob;
+
+std::string read_file(const std::string &path) {
+  std::ifstream in(path);
+  std::stringstream buffer;
+  buffer << in.rdbuf();
+  return buffer.str();
+}
+
+size_t count(const std::string &text, const std::string &needle) {
+  size_t n = 0;
+  for (size_t pos = text.find(needle); pos != std::string::npos;
+       pos = text.find(needle, pos + 1))
+    n++;
+  return n;
+}
+
+// Test Case 1: Spans only while enabled, per thread, as trace-event JSON
+void test_case_1() {
+  std::cout << "\n=== Test Case 1: Chrome trace export ===" << std::endl;
+  static_assert(kTracingCompiled, "build this test with -DLOB_TRACING=1");
+
+  { LOB_TRACE_SPAN("before enable"); }
+
+  set_trace_thread_name("main");
+  set_tracing(true);
+  for (int i = 0; i < 3; ++i) {
+    LOB_TRACE_SPAN("outer");
+    LOB_TRACE_SPAN("inner");
+  }
+  std::thread worker([] {
+    set_trace_thread_name("worker");
+    LOB_TRACE_SPAN("worker span");
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  });
+  worker.join();
+  set_tracing(false);
+  { LOB_TRACE_SPAN("after disable"); }
+
+  const std::string path = "test_trace.json";
+  assert(write_chrome_trace(path));
+  std::string json = read_file(path);
+  std::remove(path.c_str());
+
+  assert(json.rfind("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", 0) == 0);
+  assert(count(json, "\"name\":\"outer\",\"ph\":\"X\"") == 3);
+  assert(count(json, "\"name\":\"inner\",\"ph\":\"X\"") == 3);
+  assert(count(json, "worker span") == 1);
+  assert(count(json, "before enable") == 0);
+  assert(count(json, "after disable") == 0);
+
+  // Both threads are named and the worker's span lasted about 2 ms
+  assert(count(json, "\"args\":{\"name\":\"main\"}") == 1);
+  assert(count(json, "\"args\":{\"name\":\"worker\"}") == 1);
+  size_t pos = json.find("worker span");
+  size_t dur = json.find("\"dur\":", pos) + 6;
+  double worker_us = std::stod(json.substr(dur));
+  assert(worker_us > 1500.0 && worker_us < 200000.0);
+  std::cout << "✓ Test Case 1 PASSED" << std::endl;
+}
+
+int main() {
+  std::cout << "========================================" << std::endl;
+  std::cout << "Span Tracing Test Suite" << std::endl;
+  std::cout << "========================================" << std::endl;
+
+  test_case_1();
+
+  std::cout << "\n========================================" << std::endl;
+  std::cout << " ALL TESTS PASSED!" << std::endl;
+  std::cout << "========================================" << std::endl;
+  return 0;
+}